@@ -0,0 +1,85 @@
+/**
+ * @file arena.h
+ *
+ * This interface defines a region allocator. Memory is handed out from large chunks by advancing a pointer, and is
+ * released all at once when the arena is reset or freed. Blocks allocated from an arena carry no block header, so they
+ * must never be passed to freeBlock.
+ */
+
+#ifndef _arena_h
+#define _arena_h
+
+#include "cslib.h"
+
+/**
+ * @brief This type provides a region of memory from which blocks are allocated and released together.
+ */
+
+typedef struct ArenaCDT* Arena;
+
+/**
+ * @brief Creates a new empty arena. The chunks are allocated when they are first needed.
+ *
+ * Usage: @code arena = newArena(); @endcode
+ */
+
+Arena newArena(void);
+
+/**
+ * @brief Frees the arena together with every block allocated from it.
+ *
+ * Usage: @code freeArena(arena); @endcode
+ */
+
+void freeArena(Arena arena);
+
+/**
+ * @brief Releases every block allocated from the arena. The first chunk is kept, so an arena that is reset between
+ * uses of similar size does not allocate again.
+ *
+ * Usage: @code resetArena(arena); @endcode
+ */
+
+void resetArena(Arena arena);
+
+/**
+ * @brief Allocates a block of nbytes from the arena. The block is suitably aligned for any type.
+ *
+ * Usage: @code ptr = allocArena(arena, nbytes); @endcode
+ */
+
+void* allocArena(Arena arena, size_t nbytes);
+
+/**
+ * @brief Copies the string into the arena.
+ *
+ * Usage: @code copy = copyStringToArena(arena, str); @endcode
+ */
+
+string copyStringToArena(Arena arena, string str);
+
+/**
+ * @brief Returns the number of bytes allocated from the arena since it was created or last reset.
+ *
+ * Usage: @code n = sizeArena(arena); @endcode
+ */
+
+size_t sizeArena(Arena arena);
+
+/**
+ * @brief Allocates enough space in the arena to hold an object of the type to which type points.
+ *
+ * Usage: @code ptr = newArenaBlock(arena, type); @endcode
+ */
+
+#define newArenaBlock(arena, type) ((type) allocArena(arena, sizeof *((type) NULL)))
+
+/**
+ * @brief Allocates enough space in the arena to hold an array of n values of the specified type.
+ *
+ * Usage: @code array = newArenaArray(arena, n, type); @endcode
+ */
+
+#define newArenaArray(arena, n, type) ((type *) allocArena(arena, (n) * sizeof(type)))
+
+#endif
@@ -59,7 +59,8 @@ BST newBSTFromType(string baseType);
 
 /**
  * @brief Frees the storage for a binary search tree.  If nodes contain data fields with allocated storage, the client
- * must free this storage by traversing the tree prior to calling freeBST.
+ * must free this storage by traversing the tree prior to calling freeBST.  The nodes are allocated in chunks that belong to
+ * the tree, so a node is valid only as long as the tree is and until it is removed.
  * Usage: @code freeBST(bst); @endcode
  */
 
@@ -147,6 +148,65 @@ void removeBSTNode(BST bst, ...);
 
 void removeBSTNodeFromArg(BST bst, GenericType any);
 
+/**
+ * @brief Typed versions of findBSTNode, insertBSTNode and removeBSTNode for trees of string keys.  The key is passed
+ * without the variable argument list and compared without calling through the comparison function, unless the tree
+ * has a custom comparison function, in which case the generic entries are used.
+ * Usage:
+ * @code
+ * node = findBSTNodeString(bst, key);
+ * node = insertBSTNodeString(bst, key);
+ * removeBSTNodeString(bst, key);
+ * @endcode
+ */
+
+BSTNode findBSTNodeString(BST bst, string key);
+BSTNode insertBSTNodeString(BST bst, string key);
+void removeBSTNodeString(BST bst, string key);
+
+/**
+ * @brief Typed versions of findBSTNode, insertBSTNode and removeBSTNode for trees of int keys.
+ * Usage:
+ * @code
+ * node = findBSTNodeInt(bst, key);
+ * node = insertBSTNodeInt(bst, key);
+ * removeBSTNodeInt(bst, key);
+ * @endcode
+ */
+
+BSTNode findBSTNodeInt(BST bst, int key);
+BSTNode insertBSTNodeInt(BST bst, int key);
+void removeBSTNodeInt(BST bst, int key);
+
+/**
+ * @brief Typed versions of findBSTNode, insertBSTNode and removeBSTNode for trees of long keys.
+ * Usage:
+ * @code
+ * node = findBSTNodeLong(bst, key);
+ * node = insertBSTNodeLong(bst, key);
+ * removeBSTNodeLong(bst, key);
+ * @endcode
+ */
+
+BSTNode findBSTNodeLong(BST bst, long key);
+BSTNode insertBSTNodeLong(BST bst, long key);
+void removeBSTNodeLong(BST bst, long key);
+
+/**
+ * @brief Typed versions of findBSTNode, insertBSTNode and removeBSTNode for trees of pointer keys, which are ordered by
+ * their addresses.
+ * Usage:
+ * @code
+ * node = findBSTNodePointer(bst, key);
+ * node = insertBSTNodePointer(bst, key);
+ * removeBSTNodePointer(bst, key);
+ * @endcode
+ */
+
+BSTNode findBSTNodePointer(BST bst, void* key);
+BSTNode insertBSTNodePointer(BST bst, void* key);
+void removeBSTNodePointer(BST bst, void* key);
+
 /**
  * @brief Calls a function on every node in the binary search tree using the specified iteration order.  The arguments
  * to the callback function are a pointer to the node and the data pointer.
@@ -167,6 +227,17 @@ void mapBST(BST bst, proc fn, TraversalOrder order, void* data);
 
 Iterator newNodeIterator(BST bst, TraversalOrder order);
 
+/**
+ * @brief Returns an iterator for traversing the keys in a binary search tree in the specified order.  The keys are
+ * stored through the element pointer with the size of the base type.
+ * Usage: @code iterator = newKeyIterator(bst, order); @endcode
+ *
+ * Both iterators walk the tree in place and take memory only in proportion to its height, so the tree must not change
+ * while it is being iterated.
+ */
+
+Iterator newKeyIterator(BST bst, TraversalOrder order);
+
 /**
  * @brief Returns the root node of the binary search tree.
  * Usage: @code root = getRootBST(bst); @endcode
@@ -124,6 +124,27 @@ void* getBlockData(void* ptr);
 #define newArray(n, type) \
    ((type *) getTypedBlock((n) * sizeof(type), #type "[]"))
 
+#ifdef CSLIB_HEAP_PROFILE
+
+/*
+ * Heap profile
+ * ------------
+ * When the library is compiled with CSLIB_HEAP_PROFILE defined, every block is counted under its type marker: the
+ * live blocks and bytes, their high-water marks and the number of allocations.  The live blocks are also kept in a
+ * list, so the blocks that are never freed can be listed by type.  The profile is written to the standard error
+ * channel when the program exits, and can be written at any other time with printHeapProfile.
+ */
+
+/**
+ * @brief Writes the heap profile to the stream: the totals, the allocation rate and a line for every type marker.  If
+ * listBlocks is true, the first few live blocks of every type are listed as well, oldest first.
+ * Usage: @code printHeapProfile(stderr, true); @endcode
+ */
+
+void printHeapProfile(FILE* out, bool listBlocks);
+
+#endif
+
   /* Section 3 -- error handling */
 
   /**
@@ -10,11 +10,14 @@
  * function by calling enableIteration, which takes the collection pointer and a type-specific callback to create the
  * iterator.
  *
- * There are two different strategies for creating the iterator in each type.  The general strategy (which is useful for
- * iterators that are not really collections, such as scanners that return a series of tokens) is to call
+ * There are three different strategies for creating the iterator in each type.  The general strategy (which is useful
+ * for iterators that are not really collections, such as scanners that return a series of tokens) is to call
  * newStepIterator, which takes a pointer to a stepIterator function specific for that type.  The second strategy
  * creates the entire list of values at the beginning.  Such iterators are created by calling newListIterator to create
- * an empty iterator and the calling addToIteratorList for each element.
+ * an empty iterator and the calling addToIteratorList for each element.  The third strategy walks the collection in
+ * place: newCursorIterator creates a step iterator together with a small cursor, in which the step function keeps its
+ * position in the collection.  A cursor iterator takes no memory per element, and abandoning it before the end costs
+ * nothing but the call to freeIterator, but the collection must not change while it is being iterated.
  *
  * Elements in the iterator may be sorted or unsorted depending on the comparison function passed to newListIterator.
  */
@@ -64,6 +67,23 @@ void enableIteration(void* collection, NewIteratorFn newFn);
 
 Iterator newStepIterator(int size, StepIteratorFn stepFn);
 
+/**
+ * @brief Creates a new step iterator with a cursor of cursorSize bytes, which is initialized to zero.  The cursor is
+ * allocated together with the iterator and freed by freeIterator.
+ *
+ * Usage: @code iterator = newCursorIterator(size, cursorSize, stepFn); @endcode
+ */
+
+Iterator newCursorIterator(int size, int cursorSize, StepIteratorFn stepFn);
+
+/**
+ * @brief Returns the cursor of an iterator created by newCursorIterator, or NULL for the other iterators.
+ *
+ * Usage: @code cursor = getIteratorCursor(iterator); @endcode
+ */
+
+void* getIteratorCursor(Iterator iterator);
+
 /**
  * @brief Creates a new iterator with an empty iterator list.  The first argument is the size of the element type,
  * which makes it possible for the package to allocate storage for values of that type. The cmpFn is the comparison
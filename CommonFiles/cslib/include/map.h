@@ -1,9 +1,10 @@
 /**
  * @file map.h
  *
- * This interface defines a map abstraction that associates string-valued keys with values. In contrast to the HashMap
- * type defined in the hashmap.h interface, the implementation of the Map type uses a balanced binary tree, which offers
- * logarithmic performance and sorted iteration.
+ * This interface defines a map abstraction that associates string-valued keys with values. A map is either a tree map,
+ * which uses a balanced binary tree and offers logarithmic performance and sorted iteration, or a hash map, which uses
+ * an open-addressing hash table and offers constant average performance and iteration in no particular order. The
+ * type is chosen when the map is created, and the rest of the interface is the same for both.
  *
  * In most applications, the restriction of keys to strings is easy to circumvent. The simplest strategy is to convert
  * key values to strings before inserting them into the map. A more general strategy is to use the bst.h interface
@@ -23,16 +24,41 @@
 
 typedef struct MapCDT* Map;
 
+/**
+ * @brief This type defines the implementation of a map.
+ */
+
+typedef enum {
+    TREE_MAP,                           /**< Balanced binary tree, sorted iteration.                */
+    HASH_MAP                            /**< Open-addressing hash table, unordered iteration.       */
+} MapType;
+
 /* Exported entries */
 
 /**
- * @brief Allocates a new map with no entries.
+ * @brief Allocates a new tree map with no entries.
  *
  * Usage: @code map = newMap(); @endcode
  */
 
 Map newMap();
 
+/**
+ * @brief Allocates a new map of the specified type with no entries.
+ *
+ * Usage: @code map = newMapOfType(HASH_MAP); @endcode
+ */
+
+Map newMapOfType(MapType type);
+
+/**
+ * @brief Returns the type of the map.
+ *
+ * Usage: @code type = getMapType(map); @endcode
+ */
+
+MapType getMapType(Map map);
+
 /**
  * @brief Frees the storage associated with the map.
  *
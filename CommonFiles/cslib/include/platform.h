@@ -0,0 +1,108 @@
+/**
+ * @file platform.h
+ *
+ * This interface hides the differences between the C runtime of Microsoft Visual C++ and the C runtime of the other
+ * platforms. On Windows it only includes the headers that declare these functions; elsewhere it declares replacements
+ * for the Microsoft functions the library and the applications use.
+ */
+
+#ifndef _platform_h
+#define _platform_h
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <time.h>
+
+#ifdef _WIN32
+
+#include <io.h>
+
+#else
+
+#include <errno.h>
+#include <unistd.h>
+
+/**
+ * @brief This type holds the error code returned by the functions below.
+ */
+
+typedef int errno_t;
+
+/**
+ * @brief Checks the file access, the same as access.
+ *
+ * Usage: @code status = _access(path, mode); @endcode
+ */
+
+#define _access access
+
+/**
+ * @brief Gets the file descriptor of the stream, the same as fileno.
+ *
+ * Usage: @code fd = _fileno(stream); @endcode
+ */
+
+#define _fileno fileno
+
+/**
+ * @brief Writes the buffered data of the file descriptor to the disk, the same as fsync.
+ *
+ * Usage: @code status = _commit(fd); @endcode
+ */
+
+#define _commit fsync
+
+/**
+ * @brief Sets the time zone from the TZ environment variable, the same as tzset.
+ *
+ * Usage: @code _tzset(); @endcode
+ */
+
+#define _tzset tzset
+
+/**
+ * @brief Returns the 64-bit position of the stream, the same as ftello.
+ *
+ * Usage: @code pos = _ftelli64(stream); @endcode
+ */
+
+#define _ftelli64 ftello
+
+/**
+ * @brief Moves the stream to the 64-bit position, the same as fseeko.
+ *
+ * Usage: @code status = _fseeki64(stream, offset, origin); @endcode
+ */
+
+#define _fseeki64 fseeko
+
+/**
+ * @brief Opens the file and stores the stream into *stream. Returns zero on success and the error code otherwise, in
+ * which case *stream is set to NULL.
+ *
+ * Usage: @code err = fopen_s(&stream, filename, mode); @endcode
+ */
+
+errno_t fopen_s(FILE** stream, const char* filename, const char* mode);
+
+/**
+ * @brief Converts the time to the local time and stores it into *result. Returns zero on success and the error code
+ * otherwise.
+ *
+ * Usage: @code err = localtime_s(&result, &time); @endcode
+ */
+
+errno_t localtime_s(struct tm* result, const time_t* time);
+
+/**
+ * @brief Returns the number of characters the formatted string has, without the terminating NUL character. The
+ * argument list is not consumed, so it can be passed to vsprintf afterwards.
+ *
+ * Usage: @code len = _vscprintf(format, args); @endcode
+ */
+
+int _vscprintf(const char* format, va_list args);
+
+#endif
+
+#endif
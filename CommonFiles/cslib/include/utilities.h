@@ -1,13 +1,14 @@
 #ifndef _utilities_h
 #define _utilites_h
 
-#include <Windows.h>
 #include "cslib.h"
+#include "Console.h"
+#include "platform.h"
 #include "vector.h"
 #include "Event.h"
 #include "EventCategory.h"
-#include <io.h>
 #include "map.h"
+#include "arena.h"
 
 /**
  * @enum	F_COLOR
@@ -65,13 +66,15 @@ enum FormatOption {
 	MIDDLE = 0x0100
 };
 
-void ErrorExit(LPSTR lpszFunction);
+void ErrorExit(string lpszFunction);
 
 void error_msg(const string format, ...);
 
 int clear(int startY, int endY);
 
+#ifdef _WIN32
 LPWSTR GetFormattedMessage(LPWSTR pMessage, ...);
+#endif
 
 int PrintToConsole(const string format, ...);
 
@@ -109,13 +112,13 @@ void SaveCategoriesToFile(Vector categories, string fileName);
 
 void clearCordinates(int startX, int startY, int height, int width);
 
-void cls(HANDLE hConsole);
+void cls(void);
 
-Vector EventToVector(Event event);
+Vector EventToVector(void* p, Arena arena);
 
 void FreeEventStringVector(Vector vector);
 
-Vector EventCategoryToVector(EventCategory category);
+Vector EventCategoryToVector(void* p, Arena arena);
 
 void FreeEventCategoryStringVector(Vector vector);
 
@@ -129,11 +132,9 @@ string ShowPrompt(const string title, const string footer, const string format,
 
 int YesNoPrompt(const string title, const string format, ...);
 
-CHAR_INFO* SaveScreenBuffer(void);
+ConsoleCell* SaveScreenBuffer(void);
 
-int RecoverScreenBuffer(CHAR_INFO* chiBuffer);
-
-void SetConsoleWindowSize(int x, int y);
+int RecoverScreenBuffer(ConsoleCell* cells);
 
 int fileToMap(string filename, Map map);
 
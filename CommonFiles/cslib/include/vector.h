@@ -9,6 +9,7 @@
 
 #include "cslib.h"
 #include "generic.h"
+#include "cmpfn.h"
 
 /**
  * @brief This type defines the abstract vector type.
@@ -16,6 +17,24 @@
 
 typedef struct VectorCDT *Vector;
 
+/**
+ * @brief This type defines the order in which a sort key arranges the elements.
+ */
+
+typedef enum {
+   SORT_ASCENDING = 1,                 /**< Smaller elements come first.                          */
+   SORT_DESCENDING = -1                /**< Larger elements come first.                           */
+} SortDirection;
+
+/**
+ * @brief This type defines a single key of a composite sort order: the comparison function and the direction.
+ */
+
+typedef struct {
+   CompareFn cmpFn;                    /**< Function that compares the elements by this key.       */
+   SortDirection direction;            /**< Order of the elements by this key.                     */
+} SortKey;
+
 /* Exported entries */
 
 /**
@@ -125,4 +144,59 @@ void insert(Vector vector, int index, void *value);
 
 void removeVector(Vector vector, int index);
 
+/**
+ * @brief Returns the version of the vector. The vector gets a new version whenever it is changed, and the versions are
+ * never reused by other vectors, so an unchanged version means the vector holds the same elements in the same order.
+ * Changes inside the elements themselves are not tracked.
+ * 
+ * Usage: @code version = versionVector(vector); @endcode
+ */
+
+unsigned long versionVector(Vector vector);
+
+/**
+ * @brief Sorts the elements of the vector into ascending order as defined by the comparison function. The sort is not
+ * stable. It runs in O(n log n) time in the worst case, and in linear time if the vector is already sorted.
+ * 
+ * Usage: @code sortVector(vector, cmpFn); @endcode
+ */
+
+void sortVector(Vector vector, CompareFn cmpFn);
+
+/**
+ * @brief Sorts the elements in the index range from begin up to but not including end.
+ * 
+ * Usage: @code sortVectorRange(vector, begin, end, cmpFn); @endcode
+ */
+
+void sortVectorRange(Vector vector, int begin, int end, CompareFn cmpFn);
+
+/**
+ * @brief Sorts the elements of the vector into ascending order, keeping the elements that compare equal in their
+ * original order. The sort merges the runs that are already ordered, so it takes linear time on a sorted vector and
+ * little more than that on a vector that consists of a few sorted runs.
+ * 
+ * Usage: @code stableSortVector(vector, cmpFn); @endcode
+ */
+
+void stableSortVector(Vector vector, CompareFn cmpFn);
+
+/**
+ * @brief Stable sorts the elements of the vector by a composite key. The elements are ordered by the first key, the
+ * elements equal by the first key are ordered by the second one and so on.
+ * 
+ * Usage: @code sortVectorByKeys(vector, keys, nKeys); @endcode
+ */
+
+void sortVectorByKeys(Vector vector, SortKey keys[], int nKeys);
+
+/**
+ * @brief Inserts the value into the vector that is sorted by the keys, after the elements equal to it, and returns its
+ * index. The position is found by binary search.
+ * 
+ * Usage: @code index = insertSortedVector(vector, value, keys, nKeys); @endcode
+ */
+
+int insertSortedVector(Vector vector, void *value, SortKey keys[], int nKeys);
+
 #endif
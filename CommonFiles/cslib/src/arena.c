@@ -0,0 +1,130 @@
+/**
+ * @file arena.c
+ *
+ * This file implements the arena.h interface. The arena is a linked list of chunks; allocation advances a pointer
+ * inside the newest chunk and a new chunk is added when the current one is full.
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "cslib.h"
+#include "arena.h"
+
+/* Constants */
+
+#define CHUNK_SIZE 16384
+#define ALIGNMENT sizeof(double)
+
+/**
+ * @brief This type holds a single chunk of arena memory. The client data follows the chunk header.
+ */
+
+typedef struct ChunkHeader {
+    struct ChunkHeader* next;          /**< The previously filled chunk.                           */
+    size_t capacity;                   /**< Number of bytes available for the client data.         */
+    size_t used;                       /**< Number of bytes already handed out.                    */
+    double data[1];                    /**< Start of the client data, aligned for any type.        */
+} ChunkHeader;
+
+/**
+ * @brief This type is the concrete type for the Arena.
+ */
+
+struct ArenaCDT {
+    ChunkHeader* chunks;
+    size_t size;
+};
+
+/* Private function prototypes */
+
+static ChunkHeader* newChunk(size_t capacity);
+
+/* Exported entries */
+
+Arena newArena(void) {
+    Arena arena;
+
+    arena = newBlock(Arena);
+    arena->chunks = NULL;
+    arena->size = 0;
+    return arena;
+}
+
+void freeArena(Arena arena) {
+    ChunkHeader* chunk;
+    ChunkHeader* next;
+
+    for (chunk = arena->chunks; chunk != NULL; chunk = next) {
+        next = chunk->next;
+        freeBlock(chunk);
+    }
+    freeBlock(arena);
+}
+
+void resetArena(Arena arena) {
+    ChunkHeader* chunk;
+    ChunkHeader* next;
+
+    if (arena->chunks == NULL) return;
+    for (chunk = arena->chunks->next; chunk != NULL; chunk = next) {
+        next = chunk->next;
+        freeBlock(chunk);
+    }
+    arena->chunks->next = NULL;
+    arena->chunks->used = 0;
+    arena->size = 0;
+}
+
+void* allocArena(Arena arena, size_t nbytes) {
+    ChunkHeader* chunk;
+    void* ptr;
+
+    nbytes = (nbytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    chunk = arena->chunks;
+    if (chunk == NULL || chunk->capacity - chunk->used < nbytes) {
+        chunk = newChunk((nbytes > CHUNK_SIZE) ? nbytes : CHUNK_SIZE);
+        if (arena->chunks != NULL && nbytes > CHUNK_SIZE) {
+            /* Oversized blocks get their own chunk, so the current chunk stays in use. */
+            chunk->next = arena->chunks->next;
+            arena->chunks->next = chunk;
+        } else {
+            chunk->next = arena->chunks;
+            arena->chunks = chunk;
+        }
+    }
+    ptr = (char*)chunk->data + chunk->used;
+    chunk->used += nbytes;
+    arena->size += nbytes;
+    return ptr;
+}
+
+string copyStringToArena(Arena arena, string str) {
+    size_t len;
+    string copy;
+
+    if (str == NULL) error("copyStringToArena: NULL string");
+    len = strlen(str);
+    copy = newArenaArray(arena, len + 1, char);
+    memcpy(copy, str, len + 1);
+    return copy;
+}
+
+size_t sizeArena(Arena arena) {
+    return arena->size;
+}
+
+/* Private functions */
+
+/**
+ * @brief Allocates a new chunk that can hold capacity bytes of client data.
+ */
+
+static ChunkHeader* newChunk(size_t capacity) {
+    ChunkHeader* chunk;
+
+    chunk = (ChunkHeader*)getTypedBlock(offsetof(ChunkHeader, data) + capacity, "ChunkHeader");
+    chunk->next = NULL;
+    chunk->capacity = capacity;
+    chunk->used = 0;
+    return chunk;
+}
@@ -3,9 +3,14 @@
  *
  * This file implements the bst.h interface, which provides a general implementation of binary search trees.  It is used
  * in the implementations of the Map and Set types.
+ *
+ * The nodes of a tree are carved out of chunks that belong to the tree, and the removed nodes are kept on a free list
+ * for the next insertion, so inserting many keys does not allocate a block for every node.  The chunks are freed
+ * together with the tree.
  */
 
 #include <stdarg.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 #include "bst.h"
@@ -15,6 +20,24 @@
 #include "iterator.h"
 #include "itertype.h"
 
+/**
+ * @brief The number of nodes in the first chunk of a tree.  Every next chunk is twice as large, up to MAX_CHUNK_NODES.
+ */
+
+#define MIN_CHUNK_NODES 8
+
+/**
+ * @brief The largest number of nodes in a chunk.
+ */
+
+#define MAX_CHUNK_NODES 1024
+
+/**
+ * @brief The type for a chunk of nodes, which is defined after the node structure.
+ */
+
+typedef struct NodeChunkCDT* NodeChunk;
+
  /**
   * @brief This type is the concrete type used to represent the BST.
   */
@@ -30,6 +53,9 @@ struct BSTCDT {
     BSTNode root;               /**< Root of the tree                      */
     int count;                  /**< Number of entries in the BST          */
     FILE* debugLog;             /**< Debugging log                         */
+    NodeChunk chunks;           /**< Chunks the nodes are allocated from   */
+    int chunkNodes;             /**< Number of nodes in the next chunk     */
+    BSTNode freeNodes;          /**< Free nodes, linked by the left field  */
 };
 
 /**
@@ -45,6 +71,139 @@ struct BSTNodeCDT {
     BST bst;                    /**< Back pointer to the bst               */
 };
 
+/**
+ * @brief This type defines a chunk of nodes.  The nodes array extends past the end of the structure.
+ */
+
+struct NodeChunkCDT {
+    NodeChunk next;             /**< Next chunk of the tree                */
+    struct BSTNodeCDT nodes[1]; /**< The nodes of the chunk                */
+};
+
+/**
+ * @brief This type defines the cursor of a node or key iterator.  The stack holds the nodes the walk has to come back
+ * to, so its size is bounded by the height of the tree.  The stack array extends past the end of the structure.
+ */
+
+typedef struct {
+    BST bst;                    /**< The tree being walked                 */
+    TraversalOrder order;       /**< The order of the walk                 */
+    bool keys;                  /**< Whether keys or nodes are returned    */
+    BSTNode current;            /**< Next subtree to descend into          */
+    BSTNode last;               /**< Last node returned                    */
+    int depth;                  /**< Number of nodes on the stack          */
+    int capacity;               /**< Size of the stack                     */
+    BSTNode stack[1];           /**< The nodes to come back to             */
+} TreeCursor;
+
+/**
+ * @brief Compares two string keys.
+ */
+
+#define COMPARE_STRINGS(k1, k2) strcmp(k1, k2)
+
+/**
+ * @brief Compares two keys of a type with the relational operators.
+ */
+
+#define COMPARE_VALUES(k1, k2) (((k1) == (k2)) ? 0 : ((k1) < (k2)) ? -1 : +1)
+
+/**
+ * @brief Defines the typed entries for keys of the specified type, which are named by the suffix and stored in the
+ * specified field of the key union.  The private functions walk the tree with the comparison inlined.  The exported
+ * entries take that path only when the tree uses the default comparison function and the key passes the valid test,
+ * and otherwise pass the key to the generic entries, so a custom comparison function or an invalid key is handled
+ * exactly as before.
+ */
+
+#define DEFINE_TYPED_BST_ENTRIES(suffix, type, field, defaultCmpFn, compare, valid)                                    \
+                                                                                                                       \
+static BSTNode findTreeNode##suffix(BSTNode t, type key) {                                                             \
+    int sign;                                                                                                          \
+                                                                                                                       \
+    while (t != NULL) {                                                                                                \
+        sign = compare(key, t->key.field);                                                                             \
+        if (sign == 0) return t;                                                                                       \
+        t = (sign < 0) ? t->left : t->right;                                                                           \
+    }                                                                                                                  \
+    return NULL;                                                                                                       \
+}                                                                                                                      \
+                                                                                                                       \
+static int insertTreeNode##suffix(BST bst, BSTNode* tp, type key, BSTNode* rp) {                                       \
+    BSTNode t;                                                                                                         \
+    int sign;                                                                                                          \
+                                                                                                                       \
+    t = *tp;                                                                                                           \
+    if (t == NULL) {                                                                                                   \
+        t = newTreeNode(bst);                                                                                          \
+        t->key.field = key;                                                                                            \
+        *tp = t;                                                                                                       \
+        *rp = t;                                                                                                       \
+        bst->count++;                                                                                                  \
+        return +1;                                                                                                     \
+    }                                                                                                                  \
+    sign = compare(key, t->key.field);                                                                                 \
+    if (sign == 0) {                                                                                                   \
+        *rp = t;                                                                                                       \
+        return 0;                                                                                                      \
+    }                                                                                                                  \
+    if (sign < 0) {                                                                                                    \
+        return (insertTreeNode##suffix(bst, &t->left, key, rp) > 0) ? growTree(bst, tp, -1) : 0;                      \
+    }                                                                                                                  \
+    else {                                                                                                             \
+        return (insertTreeNode##suffix(bst, &t->right, key, rp) > 0) ? growTree(bst, tp, +1) : 0;                     \
+    }                                                                                                                  \
+}                                                                                                                      \
+                                                                                                                       \
+static int removeTreeNode##suffix(BST bst, BSTNode* tp, type key) {                                                    \
+    BSTNode t;                                                                                                         \
+    int sign;                                                                                                          \
+                                                                                                                       \
+    t = *tp;                                                                                                           \
+    if (t == NULL) return 0;                                                                                           \
+    sign = compare(key, t->key.field);                                                                                 \
+    if (sign == 0) return removeTargetNode(bst, tp);                                                                   \
+    if (sign < 0) {                                                                                                    \
+        return (removeTreeNode##suffix(bst, &t->left, key) < 0) ? shrinkTree(bst, tp, +1) : 0;                         \
+    }                                                                                                                  \
+    else {                                                                                                             \
+        return (removeTreeNode##suffix(bst, &t->right, key) < 0) ? shrinkTree(bst, tp, -1) : 0;                        \
+    }                                                                                                                  \
+}                                                                                                                      \
+                                                                                                                       \
+BSTNode findBSTNode##suffix(BST bst, type key) {                                                                       \
+    GenericType any;                                                                                                   \
+                                                                                                                       \
+    if (bst->cmpFn == defaultCmpFn && (valid)) {                                                                       \
+        return findTreeNode##suffix(bst->root, key);                                                                   \
+    }                                                                                                                  \
+    any.field = key;                                                                                                   \
+    return findBSTNodeFromArg(bst, any);                                                                               \
+}                                                                                                                      \
+                                                                                                                       \
+BSTNode insertBSTNode##suffix(BST bst, type key) {                                                                     \
+    GenericType any;                                                                                                   \
+    BSTNode node;                                                                                                      \
+                                                                                                                       \
+    if (bst->cmpFn == defaultCmpFn && (valid)) {                                                                       \
+        insertTreeNode##suffix(bst, &bst->root, key, &node);                                                           \
+        return node;                                                                                                   \
+    }                                                                                                                  \
+    any.field = key;                                                                                                   \
+    return insertBSTNodeFromArg(bst, any);                                                                             \
+}                                                                                                                      \
+                                                                                                                       \
+void removeBSTNode##suffix(BST bst, type key) {                                                                        \
+    GenericType any;                                                                                                   \
+                                                                                                                       \
+    if (bst->cmpFn == defaultCmpFn && (valid)) {                                                                       \
+        removeTreeNode##suffix(bst, &bst->root, key);                                                                  \
+        return;                                                                                                        \
+    }                                                                                                                  \
+    any.field = key;                                                                                                   \
+    removeBSTNodeFromArg(bst, any);                                                                                    \
+}
+
 /* Private function prototypes */
 
 static BSTNode copyTree(BST newbst, BSTNode t);
@@ -57,9 +216,19 @@ static int removeTreeNode(BST bst, BSTNode* tp, void* kp);
 
 static int removeTargetNode(BST bst, BSTNode* tp);
 
-static void freeTree(BSTNode t);
+static int removeRightmostNode(BST bst, BSTNode* tp, BSTNode* rp);
+
+static int growTree(BST bst, BSTNode* tp, int side);
+
+static int shrinkTree(BST bst, BSTNode* tp, int delta);
+
+static void initNodePool(BST bst);
+
+static BSTNode newTreeNode(BST bst);
 
-static void freeNode(BSTNode node);
+static void freeNode(BST bst, BSTNode node);
+
+static void freeNodePool(BST bst);
 
 static void adjustBF(BST bst, BSTNode* tp, int delta);
 
@@ -73,7 +242,13 @@ static void rotateRight(BST bst, BSTNode* tp);
 
 static void mapTree(BSTNode t, proc fn, TraversalOrder order, void* data);
 
-static void addNodeToIterator(BSTNode node, void* data);
+static Iterator newTreeIterator(BST bst, TraversalOrder order, bool keys);
+
+static bool stepTreeIterator(Iterator iterator, void* dst);
+
+static BSTNode nextTreeNode(TreeCursor* cursor);
+
+static void pushTreeNode(TreeCursor* cursor, BSTNode node);
 
 static Iterator newForeachIterator(void* collection);
 
@@ -93,11 +268,12 @@ BST newBSTFromType(string baseType) {
     bst->count = 0;
     bst->root = NULL;
     bst->debugLog = NULL;
+    initNodePool(bst);
     return bst;
 }
 
 void freeBST(BST bst) {
-    clearBST(bst);
+    freeNodePool(bst);
     freeBlock(bst);
 }
 
@@ -110,7 +286,9 @@ bool isEmptyBST(BST bst) {
 }
 
 void clearBST(BST bst) {
-    freeTree(bst->root);
+    freeNodePool(bst);
+    initNodePool(bst);
+    bst->root = NULL;
     bst->count = 0;
 }
 
@@ -126,8 +304,9 @@ BST cloneBST(BST bst) {
     newbst->cmpFn = bst->cmpFn;
     newbst->toStringFn = bst->toStringFn;
     newbst->count = bst->count;
-    newbst->root = copyTree(newbst, bst->root);
     newbst->debugLog = NULL;
+    initNodePool(newbst);
+    newbst->root = copyTree(newbst, bst->root);
     return newbst;
 }
 
@@ -176,16 +355,24 @@ void removeBSTNodeFromArg(BST bst, GenericType any) {
     removeTreeNode(bst, &bst->root, &any);
 }
 
+DEFINE_TYPED_BST_ENTRIES(String, string, pointerRep, stringCmpFn, COMPARE_STRINGS, key != NULL)
+
+DEFINE_TYPED_BST_ENTRIES(Int, int, intRep, intCmpFn, COMPARE_VALUES, true)
+
+DEFINE_TYPED_BST_ENTRIES(Long, long, longRep, longCmpFn, COMPARE_VALUES, true)
+
+DEFINE_TYPED_BST_ENTRIES(Pointer, void*, pointerRep, pointerCmpFn, COMPARE_VALUES, true)
+
 void mapBST(BST bst, proc fn, TraversalOrder order, void* data) {
     mapTree(bst->root, fn, order, data);
 }
 
 Iterator newNodeIterator(BST bst, TraversalOrder order) {
-    Iterator iterator;
+    return newTreeIterator(bst, order, false);
+}
 
-    iterator = newListIterator(sizeof(void*), NULL);
-    mapBST(bst, addNodeToIterator, order, iterator);
-    return iterator;
+Iterator newKeyIterator(BST bst, TraversalOrder order) {
+    return newTreeIterator(bst, order, true);
 }
 
 BSTNode getRootBST(BST bst) {
@@ -250,7 +437,7 @@ static BSTNode copyTree(BST newbst, BSTNode t) {
     BSTNode node;
 
     if (t == NULL) return NULL;
-    node = newBlock(BSTNode);
+    node = newTreeNode(newbst);
     node->key = t->key;
     node->value = t->value;
     node->left = copyTree(newbst, t->left);
@@ -291,12 +478,8 @@ static int insertTreeNode(BST bst, BSTNode* tp, void* kp, BSTNode* rp) {
 
     t = *tp;
     if (t == NULL) {
-        t = newBlock(BSTNode);
+        t = newTreeNode(bst);
         memcpy(&t->key, kp, bst->baseTypeSize);
-        t->bst = bst;
-        t->bf = 0;
-        t->left = t->right = NULL;
-        t->value = NULL;
         *tp = t;
         *rp = t;
         bst->count++;
@@ -308,36 +491,11 @@ static int insertTreeNode(BST bst, BSTNode* tp, void* kp, BSTNode* rp) {
         return 0;
     }
     if (sign < 0) {
-        if (insertTreeNode(bst, &t->left, kp, rp) > 0) {
-            switch (t->bf) {
-            case +1:
-                t->bf = 0;
-                return 0;
-            case 0:
-                t->bf = -1;
-                return +1;
-            case -1:
-                fixLeftImbalance(bst, tp);
-                return 0;
-            }
-        }
+        return (insertTreeNode(bst, &t->left, kp, rp) > 0) ? growTree(bst, tp, -1) : 0;
     }
     else {
-        if (insertTreeNode(bst, &t->right, kp, rp) > 0) {
-            switch (t->bf) {
-            case -1:
-                t->bf = 0;
-                return 0;
-            case 0:
-                t->bf = +1;
-                return +1;
-            case +1:
-                fixRightImbalance(bst, tp);
-                return 0;
-            }
-        }
+        return (insertTreeNode(bst, &t->right, kp, rp) > 0) ? growTree(bst, tp, +1) : 0;
     }
-    return 0;
 }
 
 /**
@@ -348,23 +506,18 @@ static int insertTreeNode(BST bst, BSTNode* tp, void* kp, BSTNode* rp) {
 
 static int removeTreeNode(BST bst, BSTNode* tp, void* kp) {
     BSTNode t;
-    int sign, hDelta, bfDelta;
+    int sign;
 
     t = *tp;
     if (t == NULL) return 0;
-    bfDelta = 0;
     sign = bst->cmpFn(kp, &t->key);
     if (sign == 0) return removeTargetNode(bst, tp);
     if (sign < 0) {
-        hDelta = removeTreeNode(bst, &t->left, kp);
-        if (hDelta < 0) bfDelta = +1;
+        return (removeTreeNode(bst, &t->left, kp) < 0) ? shrinkTree(bst, tp, +1) : 0;
     }
     else {
-        hDelta = removeTreeNode(bst, &t->right, kp);
-        if (hDelta < 0) bfDelta = -1;
+        return (removeTreeNode(bst, &t->right, kp) < 0) ? shrinkTree(bst, tp, -1) : 0;
     }
-    adjustBF(bst, tp, bfDelta);
-    return ((bfDelta != 0 && t->bf == 0) ? -1 : 0);
 }
 
 /**
@@ -376,56 +529,152 @@ static int removeTreeNode(BST bst, BSTNode* tp, void* kp) {
  * case, all you need to do is replace the node with its non-NULL child.  If both children are non-NULL, this code finds
  * the rightmost descendent of the left child; this node may not be a leaf, but will have no right child.  Its left
  * child replaces it in the tree, after which the replacement data is moved to the position occupied by the target node.
+ * The rightmost descendent is unlinked by following the right children, without comparing any keys.
  */
 
 static int removeTargetNode(BST bst, BSTNode* tp) {
     BSTNode t, np;
+    int hDelta;
 
     t = *tp;
+    bst->count--;
     if (t->left == NULL) {
         *tp = t->right;
-        freeNode(t);
-        bst->count--;
+        freeNode(bst, t);
         return -1;
     }
     else if (t->right == NULL) {
         *tp = t->left;
-        freeNode(t);
-        bst->count--;
+        freeNode(bst, t);
         return -1;
     }
     else {
-        np = t->left;
-        while (np->right != NULL) {
-            np = np->right;
-        }
+        hDelta = removeRightmostNode(bst, &t->left, &np);
         t->key = np->key;
         t->value = np->value;
-        if (removeTreeNode(bst, &t->left, &t->key) < 0) {
-            adjustBF(bst, tp, +1);
-            return (t->bf == 0) ? -1 : 0;
-        }
-        else {
-            return 0;
-        }
+        freeNode(bst, np);
+        return (hDelta < 0) ? shrinkTree(bst, tp, +1) : 0;
     }
 }
 
 /**
- * @brief The freeTree function frees all nodes by conducting a postorder walk. The freeNode function makes a
- * special-case check to free the key string.
+ * @brief Unlinks the rightmost node of the tree whose address is passed as the tp parameter and stores it in the
+ * location passed as the rp parameter.  The return value is the change in height of the tree.
  */
 
-static void freeTree(BSTNode t) {
-    if (t != NULL) {
-        freeTree(t->left);
-        freeTree(t->right);
-        freeNode(t);
+static int removeRightmostNode(BST bst, BSTNode* tp, BSTNode* rp) {
+    BSTNode t;
+
+    t = *tp;
+    if (t->right == NULL) {
+        *tp = t->left;
+        *rp = t;
+        return -1;
+    }
+    return (removeRightmostNode(bst, &t->right, rp) < 0) ? shrinkTree(bst, tp, -1) : 0;
+}
+
+/**
+ * @brief Corrects the balance factor of the tree whose address is passed as the tp parameter after the subtree on the
+ * specified side (-1 for the left, +1 for the right) has grown by one.  The return value is the change in height of the
+ * tree.
+ */
+
+static int growTree(BST bst, BSTNode* tp, int side) {
+    BSTNode t;
+
+    t = *tp;
+    if (t->bf == -side) {
+        t->bf = 0;
+        return 0;
+    }
+    if (t->bf == 0) {
+        t->bf = side;
+        return +1;
+    }
+    if (side < 0) {
+        fixLeftImbalance(bst, tp);
+    }
+    else {
+        fixRightImbalance(bst, tp);
     }
+    return 0;
+}
+
+/**
+ * @brief Corrects the balance factor of the tree whose address is passed as the tp parameter by the specified delta
+ * after one of its subtrees has shrunk by one.  The return value is the change in height of the tree, which is -1
+ * exactly when the tree that ends up at that address is balanced.  The root may have changed by a rotation, so it is
+ * read again from the address.
+ */
+
+static int shrinkTree(BST bst, BSTNode* tp, int delta) {
+    adjustBF(bst, tp, delta);
+    return ((*tp)->bf == 0) ? -1 : 0;
 }
 
-static void freeNode(BSTNode node) {
-    freeBlock(node);
+/**
+ * @brief Sets up an empty node pool for the tree.
+ */
+
+static void initNodePool(BST bst) {
+    bst->chunks = NULL;
+    bst->chunkNodes = MIN_CHUNK_NODES;
+    bst->freeNodes = NULL;
+}
+
+/**
+ * @brief Returns a new leaf node of the tree, which is taken from the free list.  When the free list is empty, a new
+ * chunk is allocated and all of its nodes are put on the free list.
+ */
+
+static BSTNode newTreeNode(BST bst) {
+    NodeChunk chunk;
+    BSTNode node;
+    int i;
+
+    if (bst->freeNodes == NULL) {
+        chunk = (NodeChunk)getBlock(offsetof(struct NodeChunkCDT, nodes)
+                                    + bst->chunkNodes * sizeof(struct BSTNodeCDT));
+        chunk->next = bst->chunks;
+        bst->chunks = chunk;
+        for (i = bst->chunkNodes - 1; i >= 0; i--) {
+            chunk->nodes[i].left = bst->freeNodes;
+            bst->freeNodes = &chunk->nodes[i];
+        }
+        if (bst->chunkNodes < MAX_CHUNK_NODES) bst->chunkNodes *= 2;
+    }
+    node = bst->freeNodes;
+    bst->freeNodes = node->left;
+    node->value = NULL;
+    node->left = node->right = NULL;
+    node->bf = 0;
+    node->bst = bst;
+    return node;
+}
+
+/**
+ * @brief Returns the node to the free list of the tree.
+ */
+
+static void freeNode(BST bst, BSTNode node) {
+    node->left = bst->freeNodes;
+    bst->freeNodes = node;
+}
+
+/**
+ * @brief Frees all chunks of the tree, which frees all of its nodes at once.
+ */
+
+static void freeNodePool(BST bst) {
+    NodeChunk chunk;
+
+    while (bst->chunks != NULL) {
+        chunk = bst->chunks;
+        bst->chunks = chunk->next;
+        freeBlock(chunk);
+    }
+    bst->freeNodes = NULL;
 }
 
 /**
@@ -592,11 +841,107 @@ static void mapTree(BSTNode t, proc fn, TraversalOrder order, void* data) {
 }
 
 /**
- * @brief Adds the specified node to the iterator, which is passed as the data parameter.
+ * @brief Creates a cursor iterator over the nodes or the keys of the tree.  The stack is sized for the tallest AVL tree
+ * with the current number of nodes, whose height is below 1.44 log2(n + 2).
+ */
+
+static Iterator newTreeIterator(BST bst, TraversalOrder order, bool keys) {
+    Iterator iterator;
+    TreeCursor* cursor;
+    int bits, n, capacity;
+
+    bits = 0;
+    for (n = bst->count; n > 0; n >>= 1) {
+        bits++;
+    }
+    capacity = 3 * bits / 2 + 3;
+    iterator = newCursorIterator(keys ? bst->baseTypeSize : (int) sizeof(BSTNode),
+                                 offsetof(TreeCursor, stack) + capacity * sizeof(BSTNode), stepTreeIterator);
+    cursor = (TreeCursor*)getIteratorCursor(iterator);
+    cursor->bst = bst;
+    cursor->order = order;
+    cursor->keys = keys;
+    cursor->capacity = capacity;
+    cursor->last = NULL;
+    cursor->depth = 0;
+    if (order == PREORDER) {
+        cursor->current = NULL;
+        if (bst->root != NULL) pushTreeNode(cursor, bst->root);
+    }
+    else {
+        cursor->current = bst->root;
+    }
+    return iterator;
+}
+
+/**
+ * @brief Stores the next node, or its key, through dst.
+ */
+
+static bool stepTreeIterator(Iterator iterator, void* dst) {
+    TreeCursor* cursor;
+    BSTNode node;
+
+    cursor = (TreeCursor*)getIteratorCursor(iterator);
+    node = nextTreeNode(cursor);
+    if (node == NULL) return false;
+    if (cursor->keys) {
+        memcpy(dst, &node->key, cursor->bst->baseTypeSize);
+    }
+    else {
+        *((BSTNode*)dst) = node;
+    }
+    return true;
+}
+
+/**
+ * @brief Advances the walk and returns the next node, or NULL at the end.  A preorder walk keeps the subtrees it has
+ * still to visit on the stack.  The inorder and postorder walks keep the ancestors of the current subtree on the stack,
+ * and the postorder walk uses the last returned node to tell whether it is coming back from the right subtree.
  */
 
-static void addNodeToIterator(BSTNode node, void* data) {
-    addToIteratorList((Iterator)data, &node);
+static BSTNode nextTreeNode(TreeCursor* cursor) {
+    BSTNode node;
+
+    if (cursor->order == PREORDER) {
+        if (cursor->depth == 0) return NULL;
+        node = cursor->stack[--cursor->depth];
+        if (node->right != NULL) pushTreeNode(cursor, node->right);
+        if (node->left != NULL) pushTreeNode(cursor, node->left);
+        return node;
+    }
+    while (true) {
+        while (cursor->current != NULL) {
+            pushTreeNode(cursor, cursor->current);
+            cursor->current = cursor->current->left;
+        }
+        if (cursor->depth == 0) return NULL;
+        node = cursor->stack[cursor->depth - 1];
+        if (cursor->order == INORDER) {
+            cursor->depth--;
+            cursor->current = node->right;
+            return node;
+        }
+        if (node->right != NULL && node->right != cursor->last) {
+            cursor->current = node->right;
+        }
+        else {
+            cursor->depth--;
+            cursor->last = node;
+            return node;
+        }
+    }
+}
+
+/**
+ * @brief Pushes the node on the stack of the cursor.
+ */
+
+static void pushTreeNode(TreeCursor* cursor, BSTNode node) {
+    if (cursor->depth == cursor->capacity) {
+        error("BST iterator: The tree has changed during the iteration");
+    }
+    cursor->stack[cursor->depth++] = node;
 }
 
 /**
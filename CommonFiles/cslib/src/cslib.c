@@ -9,6 +9,14 @@
 #include <string.h>
 #include <stdarg.h>
 #include "cslib.h"
+#ifdef CSLIB_HEAP_PROFILE
+#include <time.h>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <pthread.h>
+#endif
+#endif
 
  /* Constants */
 
@@ -30,6 +38,8 @@
  *                  +---------------------+
  *                  | client data pointer |
  *                  +---------------------+
+ *                  |   profile links *   |
+ *                  +---------------------+
  *   client addr -> |          .          |
  *                  |          .          |
  *                  |          .          |
@@ -37,8 +47,15 @@
  * @endverbatim
  *
  * The password is a special value unlikely to appear as a data value.
+ *
+ * (*) Only with CSLIB_HEAP_PROFILE: the neighbours in the list of the live blocks, the profile of the block type and the
+ * allocation number, which also keep the client data aligned the same as without them.
  */
 
+#ifdef CSLIB_HEAP_PROFILE
+struct TypeProfile;
+#endif
+
 typedef struct BlockHeader {
     union {
         size_t _password;              /**< A special value unlikely to appear as a data value     */
@@ -47,12 +64,78 @@ typedef struct BlockHeader {
     char* type;                        /**< String containing the type of block data.              */
     size_t size;                       /**< Size of client data.                                   */
     void* data;                        /**< Client data pointer.                                   */
+#ifdef CSLIB_HEAP_PROFILE
+    struct BlockHeader* prev;          /**< The previous (older) live block.                       */
+    struct BlockHeader* next;          /**< The next (newer) live block.                           */
+    struct TypeProfile* profile;       /**< The profile of the block type.                         */
+    size_t serial;                     /**< Number of the allocation, counted from 1.              */
+#endif
 } BlockHeader;
 
 #define password block_union._password
 #define chain block_union._chain
 #define PASSWORD 314159265L // pi (3.14159265) times 100 million
 
+#ifdef CSLIB_HEAP_PROFILE
+
+/* Heap profile */
+
+#define TYPE_PROFILE_SLOTS 256 /**< Number of the distinct type markers that are counted separately.    */
+#define LISTED_BLOCKS 8        /**< Number of the live blocks listed for every type.                   */
+#define PREVIEW_LENGTH 40      /**< Number of the characters shown from a live string.                 */
+
+/**
+ * @brief The counters of a single type marker.  The markers are string literals, so the same type may have several
+ * profiles, one for every copy of the literal; they are merged by name when the profile is written.
+ */
+
+typedef struct TypeProfile {
+    string type;                       /**< The type marker, or NULL if the slot is free.          */
+    size_t liveBlocks;                 /**< Number of the blocks allocated and not yet freed.      */
+    size_t liveBytes;                  /**< Client bytes of the live blocks.                       */
+    size_t peakBlocks;                 /**< The highest number of the live blocks.                 */
+    size_t peakBytes;                  /**< The highest number of the live bytes.                  */
+    size_t totalBlocks;                /**< Number of the allocations.                             */
+    int group;                         /**< Index of the merged line, used while writing.          */
+} TypeProfile;
+
+/**
+ * @brief The profiles, an open addressing table keyed by the address of the type marker.  When it is full, the blocks
+ * of the new markers are counted in the overflow profile.
+ */
+static TypeProfile typeProfiles[TYPE_PROFILE_SLOTS];
+static TypeProfile overflowProfile = { "(other)", 0, 0, 0, 0, 0, 0 };
+
+static BlockHeader* oldestBlock;       /**< The head of the list of the live blocks.               */
+static BlockHeader* newestBlock;       /**< The tail of the list of the live blocks.               */
+static size_t liveBlocks;
+static size_t liveBytes;
+static size_t peakBlocks;
+static size_t peakBytes;
+static size_t totalBlocks;
+static time_t profileStart;
+
+/* The blocks are allocated and freed by the worker threads as well, so the profile is locked. */
+
+#ifdef _WIN32
+static SRWLOCK profileLock = SRWLOCK_INIT;
+#define lockProfile() AcquireSRWLockExclusive(&profileLock)
+#define unlockProfile() ReleaseSRWLockExclusive(&profileLock)
+#else
+static pthread_mutex_t profileLock = PTHREAD_MUTEX_INITIALIZER;
+#define lockProfile() pthread_mutex_lock(&profileLock)
+#define unlockProfile() pthread_mutex_unlock(&profileLock)
+#endif
+
+static void addProfiledBlock(BlockHeader* base);
+static void removeProfiledBlock(BlockHeader* base);
+static TypeProfile* findTypeProfile(string type);
+static void printProfileAtExit(void);
+static int compareGroups(const void* p1, const void* p2);
+static void printPreview(FILE* out, BlockHeader* base);
+
+#endif
+
 /* Memory allocation implementation */
 
 void* getBlock(size_t nbytes) {
@@ -70,6 +153,9 @@ void* getTypedBlock(size_t nbytes, string type) {
     base->type = type;
     base->size = nbytes;
     base->data = NULL;
+#ifdef CSLIB_HEAP_PROFILE
+    addProfiledBlock(base);
+#endif
     return (void*)((char*)base + sizeof(BlockHeader));
 }
 
@@ -78,6 +164,9 @@ void freeBlock(void* ptr) {
 
     base = (BlockHeader*)((char*)ptr - sizeof(BlockHeader));
     if (base->password == PASSWORD) {
+#ifdef CSLIB_HEAP_PROFILE
+        removeProfiledBlock(base);
+#endif
         base->password = 0;
         free(base);
     }
@@ -110,6 +199,201 @@ void* getBlockData(void* ptr) {
     return base->data;
 }
 
+#ifdef CSLIB_HEAP_PROFILE
+
+/* Heap profile implementation */
+
+void printHeapProfile(FILE* out, bool listBlocks) {
+    TypeProfile* groups;
+    BlockHeader** listed;
+    BlockHeader* block;
+    int* listedCount;
+    int nGroups, i, j;
+    double seconds;
+
+    lockProfile();
+
+    /* The writing itself must not allocate blocks, so malloc is used directly. */
+    groups = (TypeProfile*)malloc((TYPE_PROFILE_SLOTS + 1) * sizeof(TypeProfile));
+    listed = (BlockHeader**)malloc((TYPE_PROFILE_SLOTS + 1) * LISTED_BLOCKS * sizeof(BlockHeader*));
+    listedCount = (int*)calloc(TYPE_PROFILE_SLOTS + 1, sizeof(int));
+    if (groups == NULL || listed == NULL || listedCount == NULL) {
+        unlockProfile();
+        free(groups);
+        free(listed);
+        free(listedCount);
+        fprintf(out, "Heap profile: No memory available\n");
+        return;
+    }
+
+    /* Merge the profiles of the same type name. */
+    nGroups = 0;
+    for (i = 0; i <= TYPE_PROFILE_SLOTS; i++) {
+        TypeProfile* profile = (i < TYPE_PROFILE_SLOTS) ? &typeProfiles[i] : &overflowProfile;
+        if (profile->type == NULL || profile->totalBlocks == 0) continue;
+        for (j = 0; j < nGroups && strcmp(groups[j].type, profile->type) != 0; j++);
+        if (j == nGroups) {
+            groups[nGroups] = *profile;
+            groups[nGroups].group = nGroups;
+            nGroups++;
+        } else {
+            /* The peaks of the copies were not reached at the same time, so their sum is an upper bound. */
+            groups[j].liveBlocks += profile->liveBlocks;
+            groups[j].liveBytes += profile->liveBytes;
+            groups[j].peakBlocks += profile->peakBlocks;
+            groups[j].peakBytes += profile->peakBytes;
+            groups[j].totalBlocks += profile->totalBlocks;
+        }
+        profile->group = j;
+    }
+
+    /* Take the oldest live blocks of every group before the groups are sorted. */
+    if (listBlocks) {
+        for (block = oldestBlock; block != NULL; block = block->next) {
+            int group = block->profile->group;
+            if (listedCount[group] < LISTED_BLOCKS) {
+                listed[group * LISTED_BLOCKS + listedCount[group]++] = block;
+            }
+        }
+    }
+    qsort(groups, nGroups, sizeof(TypeProfile), compareGroups);
+
+    seconds = difftime(time(NULL), profileStart);
+    fprintf(out, "Heap profile: %zu allocations in %.0f s", totalBlocks, seconds);
+    if (seconds > 0) {
+        fprintf(out, " (%.1f/s)", totalBlocks / seconds);
+    }
+    fprintf(out, ", %zu bytes in %zu blocks live, peak %zu bytes in %zu blocks\n",
+            liveBytes, liveBlocks, peakBytes, peakBlocks);
+    fprintf(out, "%-24s %12s %14s %12s %14s %12s\n",
+            "type", "live blocks", "live bytes", "peak blocks", "peak bytes", "allocations");
+    for (i = 0; i < nGroups; i++) {
+        fprintf(out, "%-24s %12zu %14zu %12zu %14zu %12zu\n", groups[i].type, groups[i].liveBlocks,
+                groups[i].liveBytes, groups[i].peakBlocks, groups[i].peakBytes, groups[i].totalBlocks);
+    }
+
+    if (listBlocks && liveBlocks > 0) {
+        fprintf(out, "Live blocks, oldest first:\n");
+        for (i = 0; i < nGroups; i++) {
+            int group = groups[i].group;
+            if (listedCount[group] == 0) continue;
+            fprintf(out, "  %s: %zu blocks, %zu bytes\n", groups[i].type, groups[i].liveBlocks,
+                    groups[i].liveBytes);
+            for (j = 0; j < listedCount[group]; j++) {
+                block = listed[group * LISTED_BLOCKS + j];
+                fprintf(out, "    #%zu, %zu bytes", block->serial, block->size);
+                printPreview(out, block);
+                fprintf(out, "\n");
+            }
+            if (groups[i].liveBlocks > (size_t) listedCount[group]) {
+                fprintf(out, "    ...\n");
+            }
+        }
+    }
+
+    unlockProfile();
+    free(groups);
+    free(listed);
+    free(listedCount);
+}
+
+static void addProfiledBlock(BlockHeader* base) {
+    TypeProfile* profile;
+
+    lockProfile();
+    if (totalBlocks == 0) {
+        profileStart = time(NULL);
+        atexit(printProfileAtExit);
+    }
+    profile = findTypeProfile(base->type);
+    base->profile = profile;
+    base->serial = ++totalBlocks;
+    base->next = NULL;
+    base->prev = newestBlock;
+    if (newestBlock != NULL) {
+        newestBlock->next = base;
+    } else {
+        oldestBlock = base;
+    }
+    newestBlock = base;
+
+    profile->totalBlocks++;
+    profile->liveBlocks++;
+    profile->liveBytes += base->size;
+    if (profile->liveBytes > profile->peakBytes) profile->peakBytes = profile->liveBytes;
+    if (profile->liveBlocks > profile->peakBlocks) profile->peakBlocks = profile->liveBlocks;
+    liveBlocks++;
+    liveBytes += base->size;
+    if (liveBytes > peakBytes) peakBytes = liveBytes;
+    if (liveBlocks > peakBlocks) peakBlocks = liveBlocks;
+    unlockProfile();
+}
+
+static void removeProfiledBlock(BlockHeader* base) {
+    lockProfile();
+    if (base->prev != NULL) {
+        base->prev->next = base->next;
+    } else {
+        oldestBlock = base->next;
+    }
+    if (base->next != NULL) {
+        base->next->prev = base->prev;
+    } else {
+        newestBlock = base->prev;
+    }
+    base->profile->liveBlocks--;
+    base->profile->liveBytes -= base->size;
+    liveBlocks--;
+    liveBytes -= base->size;
+    unlockProfile();
+}
+
+static TypeProfile* findTypeProfile(string type) {
+    size_t start = ((size_t) type >> 3) % TYPE_PROFILE_SLOTS;
+    size_t i = start;
+
+    do {
+        if (typeProfiles[i].type == type) return &typeProfiles[i];
+        if (typeProfiles[i].type == NULL) {
+            typeProfiles[i].type = type;
+            return &typeProfiles[i];
+        }
+        i = (i + 1) % TYPE_PROFILE_SLOTS;
+    } while (i != start);
+    return &overflowProfile;
+}
+
+static void printProfileAtExit(void) {
+    printHeapProfile(stderr, true);
+}
+
+/* The types with the most live bytes come first, then the ones allocated most often. */
+
+static int compareGroups(const void* p1, const void* p2) {
+    const TypeProfile* g1 = (const TypeProfile*)p1;
+    const TypeProfile* g2 = (const TypeProfile*)p2;
+
+    if (g1->liveBytes != g2->liveBytes) return (g1->liveBytes < g2->liveBytes) ? 1 : -1;
+    if (g1->totalBlocks != g2->totalBlocks) return (g1->totalBlocks < g2->totalBlocks) ? 1 : -1;
+    return strcmp(g1->type, g2->type);
+}
+
+/* The strings are shown up to the terminator, with the control characters replaced by dots. */
+
+static void printPreview(FILE* out, BlockHeader* base) {
+    string text = (string)((char*)base + sizeof(BlockHeader));
+    size_t i;
+
+    if (strcmp(base->type, "char[]") != 0) return;
+    fprintf(out, ": \"");
+    for (i = 0; i < base->size && i < PREVIEW_LENGTH && text[i] != '\0'; i++) {
+        fputc(((unsigned char) text[i] < ' ') ? '.' : text[i], out);
+    }
+    fprintf(out, (i == PREVIEW_LENGTH && i < base->size && text[i] != '\0') ? "...\"" : "\"");
+}
+
+#endif
+
 /* Section 3 -- error handling */
 
 void error(string msg, ...) {
@@ -45,6 +45,7 @@ struct IteratorCDT {
     CompareFn cmpFn;
     Cell* head, * tail;
     void* data;
+    void* cursor;
 };
 
 /* Private functions prototypes */
@@ -99,6 +100,7 @@ Iterator newStepIterator(int size, StepIteratorFn stepFn) {
     iterator->cmpFn = NULL;
     iterator->head = iterator->tail = NULL;
     iterator->data = NULL;
+    iterator->cursor = NULL;
     return iterator;
 }
 
@@ -112,9 +114,36 @@ Iterator newListIterator(int size, CompareFn cmpFn) {
     iterator->cmpFn = cmpFn;
     iterator->head = iterator->tail = NULL;
     iterator->data = NULL;
+    iterator->cursor = NULL;
     return iterator;
 }
 
+/*
+ * Implementation notes: newCursorIterator
+ *
+ * The cursor is allocated in the same block as the iterator, right after the concrete structure, so that creating the
+ * iterator takes a single allocation and freeIterator releases the cursor without knowing about it.
+ */
+
+Iterator newCursorIterator(int size, int cursorSize, StepIteratorFn stepFn) {
+    Iterator iterator;
+
+    iterator = (Iterator)getTypedBlock(sizeof(struct IteratorCDT) + cursorSize, "Iterator");
+    enableIteration(iterator, 0);
+    iterator->elementSize = size;
+    iterator->stepFn = stepFn;
+    iterator->cmpFn = NULL;
+    iterator->head = iterator->tail = NULL;
+    iterator->data = NULL;
+    iterator->cursor = (char*)iterator + sizeof(struct IteratorCDT);
+    memset(iterator->cursor, 0, cursorSize);
+    return iterator;
+}
+
+void* getIteratorCursor(Iterator iterator) {
+    return iterator->cursor;
+}
+
 /*
  * Implementation notes: addToIteratorList
  *
@@ -1,10 +1,14 @@
 /**
  * @file map.c
  *
- * This file implements the map.h interface, which implements maps using the balanced binary tree abstraction exported
- * by the bst.h interface.
+ * This file implements the map.h interface. Tree maps use the balanced binary tree abstraction exported by the bst.h
+ * interface. Hash maps use an open-addressing hash table, which keeps a control byte for every slot next to the slots
+ * themselves: the control byte is either empty, deleted or the top seven bits of the hash of the key in the slot. The
+ * probe reads eight control bytes at a time as a single word and finds the matching ones with a few word operations,
+ * so most lookups touch a single word of control bytes and a single slot.
  */
 
+#include <stdint.h>
 #include <string.h>
 #include "bst.h"
 #include "cslib.h"
@@ -12,106 +16,447 @@
 #include "itertype.h"
 #include "map.h"
 
+/**
+ * @brief The number of control bytes the probe reads at a time.
+ */
+
+#define GROUP_WIDTH 8
+
+/**
+ * @brief The smallest capacity of a hash table, which has to be a power of two that is not smaller than GROUP_WIDTH.
+ */
+
+#define MIN_CAPACITY 16
+
+/**
+ * @brief The control byte of a slot that has never been used.
+ */
+
+#define EMPTY_SLOT 0x80
+
+/**
+ * @brief The control byte of a slot whose key has been removed.
+ */
+
+#define DELETED_SLOT 0xFE
+
+/**
+ * @brief The word with the lowest bit of every byte set.
+ */
+
+#define LOW_BITS 0x0101010101010101ULL
+
+/**
+ * @brief The word with the highest bit of every byte set.
+ */
+
+#define HIGH_BITS 0x8080808080808080ULL
+
+/**
+ * @brief This type represents a slot of the hash table.
+ */
+
+typedef struct {
+    string key;                         /* The key, not copied          */
+    uint32_t hash;                      /* The hash of the key          */
+    void* value;                        /* The value                    */
+} HashSlot;
+
  /**
   * @brief This type is the concrete type used to represent the map.
   */
 
 struct MapCDT {
     IteratorHeader header;              /* Header to enable iteration   */
-    BST bst;                            /* BST that does all the work   */
+    MapType type;                       /* Implementation of the map    */
+    BST bst;                            /* BST of a tree map            */
+    unsigned char* control;             /* Control bytes of the slots   */
+    HashSlot* slots;                    /* Slots of a hash map          */
+    int capacity;                       /* Number of the slots          */
+    int count;                          /* Number of the keys           */
+    int deleted;                        /* Number of the deleted slots  */
 };
 
+/**
+ * @brief This type is the cursor of a hash map iterator, which is the map and the index of the next slot.
+ */
+
+typedef struct {
+    Map map;                            /* The map being iterated       */
+    int index;                          /* Next slot to look at         */
+} HashCursor;
+
 /* Private function prototypes */
 
 static Iterator newMapIterator(void* collection);
-static void addKeyToIterator(BSTNode node, void* data);
+static bool stepHashIterator(Iterator iterator, void* dst);
+static void initHashTable(Map map, int capacity);
+static void rehashTable(Map map, int capacity);
+static int findSlot(Map map, string key, uint32_t hash);
+static int findFreeSlot(Map map, uint32_t hash);
+static void setControl(Map map, int index, unsigned char control);
+static uint64_t loadGroup(Map map, int index);
+static uint64_t matchByte(uint64_t group, unsigned char byte);
+static int lowestByte(uint64_t mask);
+static uint32_t hashKey(string key);
 
 /* Exported entries */
 
 Map newMap() {
+    return newMapOfType(TREE_MAP);
+}
+
+Map newMapOfType(MapType type) {
     Map map;
 
     map = newBlock(Map);
     enableIteration(map, newMapIterator);
-    map->bst = newBST(string);
+    map->type = type;
+    map->bst = NULL;
+    map->control = NULL;
+    map->slots = NULL;
+    if (type == HASH_MAP) {
+        initHashTable(map, MIN_CAPACITY);
+    } else {
+        map->bst = newBST(string);
+    }
     return map;
 }
 
+MapType getMapType(Map map) {
+    return map->type;
+}
+
 void freeMap(Map map) {
-    freeBST(map->bst);
+    if (map->type == HASH_MAP) {
+        freeBlock(map->control);
+        freeBlock(map->slots);
+    } else {
+        freeBST(map->bst);
+    }
     freeBlock(map);
 }
 
 int sizeMap(Map map) {
-    return sizeBST(map->bst);
+    return (map->type == HASH_MAP) ? map->count : sizeBST(map->bst);
 }
 
 bool isEmptyMap(Map map) {
-    return isEmptyBST(map->bst);
+    return sizeMap(map) == 0;
 }
 
 void clearMap(Map map) {
-    clearBST(map->bst);
+    if (map->type == HASH_MAP) {
+        freeBlock(map->control);
+        freeBlock(map->slots);
+        initHashTable(map, MIN_CAPACITY);
+    } else {
+        clearBST(map->bst);
+    }
 }
 
 Map cloneMap(Map map) {
     Map newmap;
+    int size;
 
     newmap = newBlock(Map);
     enableIteration(newmap, newMapIterator);
-    newmap->bst = cloneBST(map->bst);
+    newmap->type = map->type;
+    newmap->bst = NULL;
+    newmap->control = NULL;
+    newmap->slots = NULL;
+    if (map->type == HASH_MAP) {
+        size = map->capacity + GROUP_WIDTH;
+        newmap->control = newArray(size, unsigned char);
+        memcpy(newmap->control, map->control, size);
+        newmap->slots = newArray(map->capacity, HashSlot);
+        memcpy(newmap->slots, map->slots, map->capacity * sizeof(HashSlot));
+        newmap->capacity = map->capacity;
+        newmap->count = map->count;
+        newmap->deleted = map->deleted;
+    } else {
+        newmap->bst = cloneBST(map->bst);
+    }
     return newmap;
 }
 
 void putMap(Map map, string key, void* value) {
     BSTNode node;
+    uint32_t hash;
+    int index;
 
-    node = insertBSTNode(map->bst, key);
-    setNodeValue(node, value);
+    if (map->type != HASH_MAP) {
+        node = insertBSTNodeString(map->bst, key);
+        setNodeValue(node, value);
+        return;
+    }
+    hash = hashKey(key);
+    index = findSlot(map, key, hash);
+    if (index >= 0) {
+        map->slots[index].value = value;
+        return;
+    }
+
+    /* The table is kept at most three quarters full, counting the deleted slots, so every probe ends. */
+    if ((map->count + map->deleted + 1) * 4 > map->capacity * 3) {
+        rehashTable(map, ((map->count + 1) * 2 > map->capacity) ? map->capacity * 2 : map->capacity);
+    }
+    index = findFreeSlot(map, hash);
+    if (map->control[index] == DELETED_SLOT) map->deleted--;
+    setControl(map, index, (unsigned char)(hash >> 25));
+    map->slots[index].key = key;
+    map->slots[index].hash = hash;
+    map->slots[index].value = value;
+    map->count++;
 }
 
 void* getMap(Map map, string key) {
     BSTNode node;
+    int index;
 
-    node = findBSTNode(map->bst, key);
+    if (map->type == HASH_MAP) {
+        index = findSlot(map, key, hashKey(key));
+        return (index < 0) ? NULL : map->slots[index].value;
+    }
+    node = findBSTNodeString(map->bst, key);
     return (node == NULL) ? NULL : getNodeValue(node);
 }
 
 bool containsKeyMap(Map map, string key) {
-    return findBSTNode(map->bst, key) != NULL;
+    if (map->type == HASH_MAP) {
+        return findSlot(map, key, hashKey(key)) >= 0;
+    }
+    return findBSTNodeString(map->bst, key) != NULL;
 }
 
 void removeMap(Map map, string key) {
-    removeBSTNode(map->bst, key);
+    int index;
+
+    if (map->type != HASH_MAP) {
+        removeBSTNodeString(map->bst, key);
+        return;
+    }
+    index = findSlot(map, key, hashKey(key));
+    if (index >= 0) {
+        setControl(map, index, DELETED_SLOT);
+        map->count--;
+        map->deleted++;
+    }
 }
 
 void mapMap(Map map, proc fn, void* data) {
     Iterator it;
     BSTNode node;
+    int i;
 
+    if (map->type == HASH_MAP) {
+        for (i = 0; i < map->capacity; i++) {
+            if (map->control[i] < EMPTY_SLOT) {
+                fn(map->slots[i].key, map->slots[i].value, data);
+            }
+        }
+        return;
+    }
     it = newNodeIterator(map->bst, INORDER);
     while (stepIterator(it, &node)) {
-        fn(getKeyString(node), getNodeValue(node), data);
+        fn((string)getKey(node).pointerRep, getNodeValue(node), data);
     }
+    freeIterator(it);
 }
 
 /* Private functions */
 
+/**
+ * @brief Creates a cursor iterator over the keys of the map.  A tree map uses the key iterator of its BST, and a hash
+ * map walks its slots in place.
+ */
+
 static Iterator newMapIterator(void* collection) {
     Iterator iterator;
+    HashCursor* cursor;
+    Map map;
 
-    iterator = newListIterator(sizeof(string), NULL);
-    mapBST(((Map)collection)->bst, addKeyToIterator, INORDER, iterator);
+    map = (Map)collection;
+    if (map->type != HASH_MAP) {
+        return newKeyIterator(map->bst, INORDER);
+    }
+    iterator = newCursorIterator(sizeof(string), sizeof(HashCursor), stepHashIterator);
+    cursor = (HashCursor*)getIteratorCursor(iterator);
+    cursor->map = map;
+    cursor->index = 0;
     return iterator;
 }
 
 /**
- * @brief Adds the key from the specified node to the iterator, which is passed as the data parameter.
+ * @brief Stores the key of the next used slot through dst and advances the cursor past it.
+ */
+
+static bool stepHashIterator(Iterator iterator, void* dst) {
+    HashCursor* cursor;
+    Map map;
+
+    cursor = (HashCursor*)getIteratorCursor(iterator);
+    map = cursor->map;
+    while (cursor->index < map->capacity) {
+        if (map->control[cursor->index] < EMPTY_SLOT) {
+            *((string*)dst) = map->slots[cursor->index++].key;
+            return true;
+        }
+        cursor->index++;
+    }
+    return false;
+}
+
+/**
+ * @brief Allocates an empty hash table with the specified capacity. The control bytes of the first group are repeated
+ * after the last slot, so a group that starts near the end of the table is read without wrapping around.
+ */
+
+static void initHashTable(Map map, int capacity) {
+    map->control = newArray(capacity + GROUP_WIDTH, unsigned char);
+    memset(map->control, EMPTY_SLOT, capacity + GROUP_WIDTH);
+    map->slots = newArray(capacity, HashSlot);
+    map->capacity = capacity;
+    map->count = 0;
+    map->deleted = 0;
+}
+
+/**
+ * @brief Moves the keys into a new table with the specified capacity, which drops the deleted slots. The stored hashes
+ * are reused, so no key is hashed again.
+ */
+
+static void rehashTable(Map map, int capacity) {
+    unsigned char* control;
+    HashSlot* slots;
+    int oldCapacity, i, index;
+
+    control = map->control;
+    slots = map->slots;
+    oldCapacity = map->capacity;
+    initHashTable(map, capacity);
+    for (i = 0; i < oldCapacity; i++) {
+        if (control[i] < EMPTY_SLOT) {
+            index = findFreeSlot(map, slots[i].hash);
+            setControl(map, index, control[i]);
+            map->slots[index] = slots[i];
+            map->count++;
+        }
+    }
+    freeBlock(control);
+    freeBlock(slots);
+}
+
+/**
+ * @brief Returns the index of the slot that holds the key, or -1 if the key is not in the table. Only the slots whose
+ * control bytes match the hash are compared, and the probe stops at the first group with an empty slot.
+ */
+
+static int findSlot(Map map, string key, uint32_t hash) {
+    uint64_t group, match;
+    int mask, position, index;
+
+    mask = map->capacity - 1;
+    position = hash & mask;
+    while (true) {
+        group = loadGroup(map, position);
+        for (match = matchByte(group, (unsigned char)(hash >> 25)); match != 0; match &= match - 1) {
+            index = (position + lowestByte(match)) & mask;
+            if (map->slots[index].hash == hash && strcmp(map->slots[index].key, key) == 0) {
+                return index;
+            }
+        }
+        if (matchByte(group, EMPTY_SLOT) != 0) return -1;
+        position = (position + GROUP_WIDTH) & mask;
+    }
+}
+
+/**
+ * @brief Returns the index of the first empty or deleted slot on the probe sequence of the hash.
+ */
+
+static int findFreeSlot(Map map, uint32_t hash) {
+    uint64_t available;
+    int mask, position;
+
+    mask = map->capacity - 1;
+    position = hash & mask;
+    while (true) {
+        /* Only the empty and the deleted slots have the highest bit of the control byte set. */
+        available = loadGroup(map, position) & HIGH_BITS;
+        if (available != 0) return (position + lowestByte(available)) & mask;
+        position = (position + GROUP_WIDTH) & mask;
+    }
+}
+
+/**
+ * @brief Sets the control byte of the slot, together with its copy after the last slot.
+ */
+
+static void setControl(Map map, int index, unsigned char control) {
+    map->control[index] = control;
+    if (index < GROUP_WIDTH) {
+        map->control[map->capacity + index] = control;
+    }
+}
+
+/**
+ * @brief Reads the group of control bytes that starts at the specified slot. The first control byte ends up in the
+ * lowest byte of the word, whatever the byte order of the machine is.
+ */
+
+static uint64_t loadGroup(Map map, int index) {
+    const unsigned char* bytes;
+    uint64_t group;
+    int i;
+
+    bytes = map->control + index;
+    group = 0;
+    for (i = GROUP_WIDTH - 1; i >= 0; i--) {
+        group = (group << 8) | bytes[i];
+    }
+    return group;
+}
+
+/**
+ * @brief Returns a word with the highest bit set in every byte of the group that equals the specified byte. A byte
+ * right above a matching one can be reported as well, but the lowest reported byte always matches, so the callers
+ * only use the mask to decide whether there is a match at all, or check the reported bytes one by one.
  */
 
-static void addKeyToIterator(BSTNode node, void* data) {
-    string key;
+static uint64_t matchByte(uint64_t group, unsigned char byte) {
+    uint64_t x;
 
-    key = (string)getKey(node).pointerRep;
-    addToIteratorList((Iterator)data, &key);
+    x = group ^ (LOW_BITS * byte);
+    return (x - LOW_BITS) & ~x & HIGH_BITS;
+}
+
+/**
+ * @brief Returns the index of the lowest byte that has its highest bit set in the nonzero mask.
+ */
+
+static int lowestByte(uint64_t mask) {
+    int index;
+
+    index = 0;
+    while ((mask & 0x80) == 0) {
+        mask >>= 8;
+        index++;
+    }
+    return index;
+}
+
+/**
+ * @brief Computes the 32-bit FNV-1a hash of the key.
+ */
+
+static uint32_t hashKey(string key) {
+    uint32_t hash;
+    const unsigned char* cp;
+
+    hash = 2166136261u;
+    for (cp = (const unsigned char*)key; *cp != '\0'; cp++) {
+        hash = (hash ^ *cp) * 16777619u;
+    }
+    return hash;
 }
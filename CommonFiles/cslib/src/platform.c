@@ -0,0 +1,41 @@
+/**
+ * @file platform.c
+ *
+ * This file implements the platform.h interface. On Windows the C runtime provides all of these functions, so the file
+ * is empty there.
+ */
+
+#include "platform.h"
+
+#ifndef _WIN32
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <time.h>
+
+/* Exported entries */
+
+errno_t fopen_s(FILE** stream, const char* filename, const char* mode) {
+    if (stream == NULL) return EINVAL;
+    *stream = fopen(filename, mode);
+    return (*stream == NULL) ? errno : 0;
+}
+
+errno_t localtime_s(struct tm* result, const time_t* time) {
+    if (result == NULL || time == NULL) return EINVAL;
+    return (localtime_r(time, result) == NULL) ? errno : 0;
+}
+
+int _vscprintf(const char* format, va_list args) {
+    va_list copy;
+    int len;
+
+    /* The caller keeps using the argument list, so only a copy is consumed. */
+    va_copy(copy, args);
+    len = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+    return len;
+}
+
+#endif
@@ -136,7 +136,7 @@ string readLine(FILE* infile) {
 
     n = 0;
     size = INITIAL_BUFFER_SIZE;
-    line = (string)getBlock(size + 1);
+    line = newArray(size + 1, char);
     while (true) {
         ch = getc(infile);
         if (ch == '\n' || ch == EOF) break;
@@ -147,7 +147,7 @@ string readLine(FILE* infile) {
         }
         if (n == size) {
             size *= 2;
-            nline = (string)getBlock(size + 1);
+            nline = newArray(size + 1, char);
             strncpy(nline, line, n);
             freeBlock(line);
             line = nline;
@@ -159,7 +159,7 @@ string readLine(FILE* infile) {
         return NULL;
     }
     line[n] = '\0';
-    nline = (string)getBlock(n + 1);
+    nline = newArray(n + 1, char);
     strcpy(nline, line);
     freeBlock(line);
     return nline;
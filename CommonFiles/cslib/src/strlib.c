@@ -355,5 +355,5 @@ int searchStringArray(string str, string array[]) {
  */
 
 static string createString(int len) {
-    return (string)getBlock(len + 1);
+    return newArray(len + 1, char);
 }
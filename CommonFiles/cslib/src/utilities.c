@@ -2,21 +2,32 @@
 #include <stdarg.h>
 #include "cslib.h"
 #include <stdlib.h>
-#include <windows.h>
+#include <errno.h>
+#include <string.h>
+#ifdef _WIN32
 #include <strsafe.h>
-#include <stdarg.h>
+#endif
 #include "vector.h"
 #include "Event.h"
 #include "EventCategory.h"
 #include "simpio.h"
 #include "strlib.h"
 #include "map.h"
+#include "EventJournal.h"
+#include "EventFile.h"
+#include "AtomicFile.h"
+#include "Trace.h"
+#include "arena.h"
+#include "Console.h"
+#include "platform.h"
+
+// Holds the strings of the events read from the data file, they live as long as the application.
+static Arena eventsArena = NULL;
 
-// Extern variables.
-extern HANDLE hStdout;
-extern HANDLE hStdin;
+static Vector ReadEventsGeneration(string fileName, uint32_t* sequence);
 
-void ErrorExit(LPSTR lpszFunction) {
+void ErrorExit(string lpszFunction) {
+#ifdef _WIN32
 	// Retrieve the system error message for the last-error code
 
 	LPVOID lpMsgBuf = NULL;
@@ -58,6 +69,19 @@ void ErrorExit(LPSTR lpszFunction) {
 	LocalFree(lpMsgBuf);
 	LocalFree(lpDisplayBuf);
 	ExitProcess(EXIT_FAILURE);
+#else
+	// There is no message box, the message goes to the standard error after the terminal is restored.
+	int dw = errno;
+
+	CloseConsole();
+	if (dw) {
+		fprintf(stderr, "%s failed with error %d: %s\n", lpszFunction, dw, strerror(dw));
+	}
+	else {
+		fprintf(stderr, "%s\n", lpszFunction);
+	}
+	exit(EXIT_FAILURE);
+#endif
 }
 
 void error_msg(const string format, ...) {
@@ -70,61 +94,23 @@ void error_msg(const string format, ...) {
 }
 
 int clear(int startY, int endY) {
-	COORD coordScreen = { 0, startY };    // Home for the cursor.
-	DWORD cCharsWritten;
-	CONSOLE_SCREEN_BUFFER_INFO csbi;
-	DWORD dwConSize; // Number of cells to overwrite.
-	COORD oldCordinates; // Save original coordinates.
-
-	// Get the console screen buffer info. 
-	if (!GetConsoleScreenBufferInfo(hStdout, &csbi)) {
-		return 0;
-	}
-
-	dwConSize = csbi.dwSize.X * (endY - startY + 1);
-	oldCordinates = csbi.dwCursorPosition;
-
-	// Fill the entire screen with blanks.
+	COORD coordScreen = { 0, startY };    // First cell to clear.
+	COORD sizeConsole = GetSizeConsole();
 
-	if (!FillConsoleOutputCharacter(hStdout,        // Handle to console screen buffer 
-		(TCHAR) ' ',     // Character to write to the buffer
-		dwConSize,       // Number of cells to write 
-		coordScreen,     // Coordinates of first cell 
-		&cCharsWritten)) // Receive number of characters written
-	{
-		return 0;
-	}
-
-	// Get the current text attribute.
-
-	if (!GetConsoleScreenBufferInfo(hStdout, &csbi)) {
-		return 0;
-	}
-
-	// Set the buffer's attributes accordingly.
-
-	if (!FillConsoleOutputAttribute(hStdout, // Handle to console screen buffer 
-		csbi.wAttributes, // Character attributes to use
-		dwConSize,        // Number of cells to set attribute 
-		coordScreen,      // Coordinates of first cell 
-		&cCharsWritten))  // Receive number of characters written
-	{
-		return 0;
-	}
+	// Fill the lines with blanks, the cursor stays where it is.
 
-	// Put the cursor at its original coordinates.
-
-	SetConsoleCursorPosition(hStdout, oldCordinates);
+	FillConsole(coordScreen, sizeConsole.X * (endY - startY + 1), ' ', GetAttributesConsole());
 
 	return 1;
 }
 
+#ifdef _WIN32
 // Formats a message string using the specified message and variable
 // list of arguments.
 LPWSTR GetFormattedMessage(LPWSTR pMessage, ...) {
 	LPWSTR pBuffer = NULL;
 
-	va_list args = NULL;
+	va_list args;
 	va_start(args, pMessage);
 
 	FormatMessage(FORMAT_MESSAGE_FROM_STRING |
@@ -141,6 +127,8 @@ LPWSTR GetFormattedMessage(LPWSTR pMessage, ...) {
 	return pBuffer;
 }
 
+#endif
+
 int PrintToConsole(const string format, ...) {
 	va_list args;
 	va_start(args, format);
@@ -148,17 +136,7 @@ int PrintToConsole(const string format, ...) {
 	string buf = newArray(len, char);
 	vsprintf(buf, format, args);
 
-	DWORD cWritten;
-	if (!WriteFile(
-		hStdout,               // output handle 
-		buf,                   // string buffer
-		lstrlenA(buf),         // string length 
-		&cWritten,             // bytes written 
-		NULL))                 // not overlapped 
-	{
-		freeBlock(buf);
-		return -1;
-	}
+	int cWritten = WriteTextConsole(buf, (int) strlen(buf));
 	freeBlock(buf);
 
 	return cWritten;
@@ -176,120 +154,55 @@ int PrintToConsoleFormatted(unsigned short options, const string format, ...) {
 	vsprintf(buf, format, args);
 
 	if (options & CENTER_ALIGN || options & MIDDLE) {
-		CONSOLE_SCREEN_BUFFER_INFO csbi;
-		COORD sizeConsole;
-		COORD cursorPosition;
-
-		// Get the current screen sb size and window position. 
+		COORD sizeConsole = GetSizeConsole();
+		COORD cursorPosition = GetCursorConsole();
 
-		if (!GetConsoleScreenBufferInfo(hStdout, &csbi)) {
-			freeBlock(buf);
-			return -1;
-		}
-		sizeConsole = csbi.dwSize;
-		cursorPosition = csbi.dwCursorPosition;
 		if (options & CENTER_ALIGN) {
 			cursorPosition.X = (sizeConsole.X - len) / 2;
 		}
 		if (options & MIDDLE) {
 			cursorPosition.Y = sizeConsole.Y / 2;
 		}
-		SetConsoleCursorPosition(hStdout, cursorPosition);
+		SetCursorConsole(cursorPosition);
 	}
 	if (options & HIGHLIGHT) {
-		CONSOLE_SCREEN_BUFFER_INFO csbi;
-
-		// Save the current text colors. 
-		if (!GetConsoleScreenBufferInfo(hStdout, &csbi)) {
-			freeBlock(buf);
-			return -1;
-		}
-
-		wOldColor = csbi.wAttributes;
-
-		// Set the text attributes. 
-		if (!SetConsoleTextAttribute(hStdout, HIGHLIGHT_ATTRIBUTES)) {
-			freeBlock(buf);
-			return -1;
-		}
+		// Save the current text colors and set the highlight.
+		wOldColor = GetAttributesConsole();
+		SetAttributesConsole(HIGHLIGHT_ATTRIBUTES);
 	}
 
-	DWORD cWritten;
-	if (!WriteFile(
-		hStdout,               // output handle 
-		buf,                   // string buffer
-		lstrlenA(buf),         // string length 
-		&cWritten,             // bytes written 
-		NULL))                 // not overlapped 
-	{
-		freeBlock(buf);
-		return -1;
-	}
+	int cWritten = WriteTextConsole(buf, (int) strlen(buf));
 	freeBlock(buf);
 
 	if (options & HIGHLIGHT) {
 		// Restore the original text colors. 
-		SetConsoleTextAttribute(hStdout, wOldColor);
+		SetAttributesConsole(wOldColor);
 	}
 
 	return cWritten;
 }
 
 void hideCursor(void) {
-	CONSOLE_CURSOR_INFO info;
-	info.dwSize = 100;
-	info.bVisible = FALSE;
-	SetConsoleCursorInfo(hStdout, &info);
+	ShowCursorConsole(false);
 }
 
 void showCursor(void) {
-	CONSOLE_CURSOR_INFO info;
-	info.dwSize = 100;
-	info.bVisible = TRUE;
-	SetConsoleCursorInfo(hStdout, &info);
-}
-
-static int split(Vector vector, int begin, int end, CompareFn compareFn) {
-	int i = begin, j = end;
-	void* pivot = getVector(vector, begin);
-	while (i < j) {
-		while (compareFn(getVector(vector, i), pivot) <= 0 && i < j) {
-			i++;
-		}
-		while (compareFn(getVector(vector, j), pivot) > 0) {
-			j--;
-		}
-		if (i < j) {
-			void* temp = getVector(vector, i);
-			setVector(vector, i, getVector(vector, j));
-			setVector(vector, j, temp);
-		}
-	}
-	setVector(vector, begin, getVector(vector, j));
-	setVector(vector, j, pivot);
-	return j;
+	ShowCursorConsole(true);
 }
 
 void QuickSortVector(Vector vector, int begin, int end, CompareFn compareFn) {
+	// The end index is inclusive here, the vector sort takes the index after the last element.
 	if (begin < end) {
-		int pivot = split(vector, begin, end, compareFn);
-		QuickSortVector(vector, begin, pivot - 1, compareFn);
-		QuickSortVector(vector, pivot + 1, end, compareFn);
+		TraceSpan span = BeginTraceSpan("QuickSortVector");
+		sortVectorRange(vector, begin, end + 1, compareFn);
+		EndTraceSpan(span);
 	}
 }
 
 void advanceCursor(int count) {
-	CONSOLE_SCREEN_BUFFER_INFO csbiInfo;
-	COORD cursorPosition;
-
-	// Get the current screen sb size and window position. 
-
-	if (!GetConsoleScreenBufferInfo(hStdout, &csbiInfo)) {
-		error_msg("GetConsoleScreenBufferInfo (%d)\n", GetLastError());
-	}
-	cursorPosition = csbiInfo.dwCursorPosition;
+	COORD cursorPosition = GetCursorConsole();
 	cursorPosition.Y += count;
-	SetConsoleCursorPosition(hStdout, cursorPosition);
+	SetCursorConsole(cursorPosition);
 }
 
 char* ReadString(FILE* inf) {
@@ -339,6 +252,12 @@ Event ReadEvent(FILE* filepoint) {
 	setEventCategory(e, eventCategory);
 	setEventTime(e, eventTime);
 
+	// The event keeps shared copies of the strings and only the ID of the interned category.
+	free(eventName);
+	free(eventDescription);
+	free(eventLocation);
+	free(eventCategory);
+
 	return e;
 }
 
@@ -353,29 +272,31 @@ bool fileExists(string path) {
 }
 
 Vector ReadEventsFromFile(string fileName) {
-	FILE* filepoint;
-	errno_t err;
-
-	if ((err = fopen_s(&filepoint, fileName, "rb")) != 0) {
-		// File could not be opened. filepoint was set to NULL
-		// error code is returned in err.
-		// error message can be retrieved with strerror(err);
-
-		error_msg("Nije moguće otvoriti fajl %s", fileName);
-	}
-	else {
-		// File was opened, filepoint can be used to read the stream.
-
-		Vector events = newVector();
-		size_t count;
-		fread(&count, sizeof count, 1, filepoint);
-		for (size_t i = 0; i < count; i++) {
-			Event e = ReadEvent(filepoint);
-			addVector(events, e);
+	TraceSpan span = BeginTraceSpan("ReadEventsFromFile");
+	uint32_t sequence = 0;
+	Vector events = ReadEventsGeneration(fileName, &sequence);
+	if (events == NULL) {
+		// The data file is damaged, so the previous generation is read instead.
+		string backupName = GetBackupNameAtomicFile(fileName);
+		events = ReadEventsGeneration(backupName, &sequence);
+		freeBlock(backupName);
+
+		// The damaged file is moved aside, so the next save does not make it the backup.
+		if (events != NULL && fileExists(fileName)) {
+			string damagedName = concat(fileName, ".damaged");
+			remove(damagedName);
+			rename(fileName, damagedName);
+			freeBlock(damagedName);
 		}
-		fclose(filepoint);
-		return events;
 	}
+	if (events == NULL) {
+		error_msg(fileExists(fileName) ? "Fajl %s je oštećen" : "Nije moguće otvoriti fajl %s", fileName);
+	}
+
+	// Apply the changes made since the file was written.
+	ReplayEventJournalAfter(events, fileName, sequence);
+	EndTraceSpan(span);
+	return events;
 }
 
 size_t WriteStringToFile(FILE* filepoint, string outString) {
@@ -397,37 +318,39 @@ void WriteEventToFile(FILE* filepoint, Event e) {
 }
 
 void SaveEventsToFile(Vector events, string fileName) {
+	TraceSpan span = BeginTraceSpan("SaveEventsToFile");
 	FILE* filepoint;
-	errno_t err;
-
-	if ((err = fopen_s(&filepoint, fileName, "wb")) != 0) {
-		// File could not be opened. filepoint was set to NULL
-		// error code is returned in err.
-		// error message can be retrieved with strerror(err);
 
+	// The events are written into a temporary file that replaces the data file once it is complete.
+	if ((filepoint = OpenAtomicFile(fileName)) == NULL) {
 		error_msg("Nije moguće otvoriti fajl %s", fileName);
 	}
 	else {
-		// File was opened, filepoint can be used to read the stream.
 
-		CompareFn cmpFn = CompareEventTimesDescending;
-		QuickSortVector(events, 0, sizeVector(events) - 1, cmpFn);
-		size_t count = sizeVector(events);
-		fwrite(&count, sizeof count, 1, filepoint);
-		for (size_t i = 0; i < count; i++) {
-			Event e = getVector(events, i);
-			WriteEventToFile(filepoint, e);
+		SortKey keys[] = {
+			{ CompareEventTimesDescending, SORT_ASCENDING },
+			{ CompareEventNames, SORT_ASCENDING }
+		};
+		sortVectorByKeys(events, keys, sizeof keys / sizeof keys[0]);
+		WriteEventFile(filepoint, events, GetEventJournalSequence());
+		if (!CommitAtomicFile(filepoint, fileName)) {
+			error_msg("Nije moguće sačuvati fajl %s", fileName);
 		}
 
-		fclose(filepoint);
+		// All journaled changes are now part of the data file.
+		ResetEventJournal(fileName);
 	}
+	EndTraceSpan(span);
 }
 
 EventCategory ReadCategory(FILE* filepoint) {
 	string categoryName = ReadString(filepoint);
 
+	// The categories are the first names in the category symbol table, and they share its copies
+	// of the names.
 	EventCategory cat = newEventCategory();
-	setEventCategoryName(cat, categoryName);
+	setEventCategoryName(cat, getInternedEventCategory(internEventCategory(categoryName)));
+	free(categoryName);
 
 	return cat;
 }
@@ -465,17 +388,13 @@ void WriteCategoryToFile(FILE* filepoint, EventCategory cat) {
 
 void SaveCategoriesToFile(Vector categories, string fileName) {
 	FILE* filepoint;
-	errno_t err;
-
-	if ((err = fopen_s(&filepoint, fileName, "wb")) != 0) {
-		// File could not be opened. filepoint was set to NULL
-		// error code is returned in err.
-		// error message can be retrieved with strerror(err);
 
+	// The categories are written into a temporary file that replaces the data file once it is
+	// complete.
+	if ((filepoint = OpenAtomicFile(fileName)) == NULL) {
 		error_msg("Nije moguće otvoriti fajl %s", fileName);
 	}
 	else {
-		// File was opened, filepoint can be used to read the stream.
 
 		CompareFn cmpFn = CompareEventCategoryName;
 		QuickSortVector(categories, 0, sizeVector(categories) - 1, cmpFn);
@@ -485,74 +404,32 @@ void SaveCategoriesToFile(Vector categories, string fileName) {
 			EventCategory cat = getVector(categories, i);
 			WriteCategoryToFile(filepoint, cat);
 		}
-
-		fclose(filepoint);
+		if (!CommitAtomicFile(filepoint, fileName)) {
+			error_msg("Nije moguće sačuvati fajl %s", fileName);
+		}
 	}
 }
 
 void clearCordinates(int startX, int startY, int height, int width) {
 	COORD here;
-	DWORD cWritten;
+	here.X = startX;
 	for (int i = 0; i < height; i++) {
 		here.Y = startY + i;
-		for (int j = 0; j < width; j++) {
-			here.X = startX + j;
-			WriteConsoleOutputCharacter(hStdout, L" ", 1, here, &cWritten);
-		}
+		FillConsole(here, width, ' ', GetAttributesConsole());
 	}
-
 }
 
-void cls(HANDLE hConsole) {
-	COORD coordScreen = { 0, 0 };    // home for the cursor 
-	DWORD cCharsWritten;
-	CONSOLE_SCREEN_BUFFER_INFO csbi;
-	DWORD dwConSize;
-	COORD oldCordinates;
-
-	// Get the number of character cells in the current buffer. 
-
-	if (!GetConsoleScreenBufferInfo(hConsole, &csbi)) {
-		return;
-	}
-
-	dwConSize = csbi.dwSize.X * csbi.dwSize.Y;
-	oldCordinates = csbi.dwCursorPosition;
-
-	// Fill the entire screen with blanks.
-
-	if (!FillConsoleOutputCharacter(hConsole,        // Handle to console screen buffer 
-		(TCHAR) ' ',     // Character to write to the buffer
-		dwConSize,       // Number of cells to write 
-		coordScreen,     // Coordinates of first cell 
-		&cCharsWritten))// Receive number of characters written
-	{
-		return;
-	}
-
-	// Get the current text attribute.
-
-	if (!GetConsoleScreenBufferInfo(hConsole, &csbi)) {
-		return;
-	}
+void cls(void) {
+	COORD coordScreen = { 0, 0 };    // First cell to clear.
+	COORD sizeConsole = GetSizeConsole();
 
-	// Set the buffer's attributes accordingly.
+	// Fill the entire screen with blanks, the cursor stays where it is.
 
-	if (!FillConsoleOutputAttribute(hConsole,         // Handle to console screen buffer 
-		csbi.wAttributes, // Character attributes to use
-		dwConSize,        // Number of cells to set attribute 
-		coordScreen,      // Coordinates of first cell 
-		&cCharsWritten)) // Receive number of characters written
-	{
-		return;
-	}
-
-	// Put the cursor at its home coordinates.
-
-	SetConsoleCursorPosition(hConsole, oldCordinates);
+	FillConsole(coordScreen, sizeConsole.X * sizeConsole.Y, ' ', GetAttributesConsole());
 }
 
-Vector EventToVector(Event event) {
+Vector EventToVector(void* p, Arena arena) {
+	Event event = (Event) p;
 	Vector vector = newVector();
 	addVector(vector, getEventName(event));
 	addVector(vector, getEventLocation(event));
@@ -573,18 +450,21 @@ Vector EventToVector(Event event) {
 		return NULL;
 	}
 
-	string tmp = copyString(buff);
+	string tmp = copyStringToArena(arena, buff);
 	addVector(vector, tmp);
 
 	return vector;
 }
 
 void FreeEventStringVector(Vector vector) {
-	freeBlock(getVector(vector, 3)); //todo:magic num
+	// The strings belong to the table arena.
 	freeVector(vector);
 }
 
-Vector EventCategoryToVector(EventCategory category) {
+Vector EventCategoryToVector(void* p, Arena arena) {
+	EventCategory category = (EventCategory) p;
+	// The arena is taken only to match the ToStringVector signature, the name needs no copy.
+	(void) arena;
 	Vector vector = newVector();
 	addVector(vector, getEventCategoryName(category));
 	return vector;
@@ -596,81 +476,41 @@ void FreeEventCategoryStringVector(Vector vector) {
 
 void PrintTitle(const string title) {
 	COORD coordScreen = { 0, 0 };    // home for the cursor 
-	DWORD cCharsWritten;
-	CONSOLE_SCREEN_BUFFER_INFO csbi;
-	DWORD dwConSize;
-
-	// Get the number of character cells in the current buffer. 
-	// 
-	if (!GetConsoleScreenBufferInfo(hStdout, &csbi)) {
-		return;
-	}
-
-	dwConSize = csbi.dwSize.X;
 
 	// Fill the title line with attributes.
 	// 
-	if (!FillConsoleOutputAttribute(hStdout,         // Handle to console screen buffer 
-		HIGHLIGHT_ATTRIBUTES, // Character attributes to use
-		dwConSize,            // Number of cells to set attribute 
-		coordScreen,          // Coordinates of first cell 
-		&cCharsWritten))      // Receive number of characters written
-	{
-		return;
-	}
+	FillConsole(coordScreen, GetSizeConsole().X, ' ', HIGHLIGHT_ATTRIBUTES);
 
+	SetCursorConsole(coordScreen);
 	PrintToConsoleFormatted(CENTER_ALIGN | HIGHLIGHT, title);
 	++coordScreen.Y;
-	SetConsoleCursorPosition(hStdout, coordScreen);
+	SetCursorConsole(coordScreen);
 }
 
 void PrintStatusLine(const string format) {
-	DWORD cCharsWritten;
-	CONSOLE_SCREEN_BUFFER_INFO csbi;
+	COORD sizeConsole = GetSizeConsole();
 	COORD position;
-	DWORD dwConSize;
 
-	// Get the number of character cells in the current buffer. 
-	// 
-	if (!GetConsoleScreenBufferInfo(hStdout, &csbi)) {
-		return;
-	}
-
-	dwConSize = csbi.dwSize.X;
 	position.X = 0;
-	position.Y = csbi.dwSize.Y - 1;
-	SetConsoleCursorPosition(hStdout, position);
+	position.Y = sizeConsole.Y - 1;
+	SetCursorConsole(position);
 
-	// Fill the title line with attributes.
+	// Fill the status line with attributes.
 	// 
-	if (!FillConsoleOutputAttribute(hStdout,         // Handle to console screen buffer 
-		HIGHLIGHT_ATTRIBUTES, // Character attributes to use
-		dwConSize,            // Number of cells to set attribute 
-		position,          // Coordinates of first cell 
-		&cCharsWritten))      // Receive number of characters written
-	{
-		return;
-	}
+	FillConsole(position, sizeConsole.X, ' ', HIGHLIGHT_ATTRIBUTES);
 
 	PrintToConsoleFormatted(HIGHLIGHT, format);
 
-	SetConsoleCursorPosition(hStdout, position);
+	SetCursorConsole(position);
 }
 
 void SetCursorPositionMiddle() {
-	CONSOLE_SCREEN_BUFFER_INFO csbi;
-	COORD sizeConsole;
+	COORD sizeConsole = GetSizeConsole();
 	COORD cursorPosition;
 
-	// Get the current screen sb size and window position. 
-
-	if (!GetConsoleScreenBufferInfo(hStdout, &csbi)) {
-		error_msg("GetConsoleScreenBufferInfo");
-	}
-	sizeConsole = csbi.dwSize;
 	cursorPosition.X = 0;
 	cursorPosition.Y = (sizeConsole.Y - 3) / 2;
-	SetConsoleCursorPosition(hStdout, cursorPosition);
+	SetCursorConsole(cursorPosition);
 }
 
 string ShowPrompt(const string title, const string footer, const string format, ...) {
@@ -682,26 +522,19 @@ string ShowPrompt(const string title, const string footer, const string format,
 	string buf = newArray(len, char);
 	vsprintf(buf, format, args);
 
-	system("cls");
+	ClearConsole();
 
 	PrintTitle(title);
 	PrintStatusLine(footer);
 
-	CONSOLE_SCREEN_BUFFER_INFO csbi;
-	COORD sizeConsole;
+	COORD sizeConsole = GetSizeConsole();
 	COORD cursorPosition;
 
-	// Get the current screen sb size and window position. 
-
-	if (!GetConsoleScreenBufferInfo(hStdout, &csbi)) {
-		freeBlock(buf);
-		return NULL;
-	}
-	sizeConsole = csbi.dwSize;
 	cursorPosition.X = sizeConsole.X / 3;
 	cursorPosition.Y = (sizeConsole.Y - 3) / 2;
-	SetConsoleCursorPosition(hStdout, cursorPosition);
+	SetCursorConsole(cursorPosition);
 	PrintToConsole(buf);
+	freeBlock(buf);
 
 	// Variable for registering end.
 	BOOL done = FALSE;
@@ -709,10 +542,13 @@ string ShowPrompt(const string title, const string footer, const string format,
 	string inputString = NULL;
 
 	while (!done) {
-		inputString = getLine();
-		if (strlen(inputString) != 0) {
+		inputString = ReadLineConsole();
+		if (inputString == NULL || strlen(inputString) != 0) {
 			done = TRUE;
 		}
+		else {
+			freeBlock(inputString);
+		}
 	}
 
 	return inputString;
@@ -720,10 +556,7 @@ string ShowPrompt(const string title, const string footer, const string format,
 
 int YesNoPrompt(const string title, const string format, ...) {
 	// Hide the cursor inside the table.
-	CONSOLE_CURSOR_INFO info;
-	info.dwSize = 100;
-	info.bVisible = FALSE;
-	SetConsoleCursorInfo(hStdout, &info);
+	ShowCursorConsole(false);
 
 	va_list args;
 	va_start(args, format);
@@ -731,201 +564,72 @@ int YesNoPrompt(const string title, const string format, ...) {
 	string buf = newArray(len, char);
 	vsprintf(buf, format, args);
 
-	system("cls");
+	ClearConsole();
 
 	PrintTitle(title);
 	PrintStatusLine(" F9: Da. | F10: Ne.");
 
-	CONSOLE_SCREEN_BUFFER_INFO csbi;
-	COORD sizeConsole;
+	COORD sizeConsole = GetSizeConsole();
 	COORD cursorPosition;
 
-	// Get the current screen sb size and window position. 
-
-	if (!GetConsoleScreenBufferInfo(hStdout, &csbi)) {
-		freeBlock(buf);
-		return -1;
-	}
-	sizeConsole = csbi.dwSize;
 	cursorPosition.X = 0;
 	cursorPosition.Y = (sizeConsole.Y - 3) / 2;
-	SetConsoleCursorPosition(hStdout, cursorPosition);
+	SetCursorConsole(cursorPosition);
 	PrintToConsoleFormatted(CENTER_ALIGN, buf);
+	freeBlock(buf);
 
 	// Variable for registering end.
 	BOOL done = FALSE;
 
-	// Registered event that has happend.
-	INPUT_RECORD event;
-
-	// Number of read characters.
-	DWORD cRead;
-
 	// Keeping track of the current option selection.
 	int selection = 0;
 
 	while (!done) {
-		system("pause>nul");
-		if (WaitForSingleObject(hStdin, INFINITE) == WAIT_OBJECT_0)  /* if kbhit */
-		{
-			/* Get the input event */
-			ReadConsoleInput(hStdin, &event, 1, &cRead);
-
-			/* Only respond to key release events */
-			if (event.EventType == KEY_EVENT)
-				switch (event.Event.KeyEvent.wVirtualKeyCode) {
-				case VK_F9:
-					selection = 1;
-					done = TRUE;
-					break;
-				case VK_F10:
-					selection = 0;
-					done = TRUE;
-					break;
-				default:
-					break;
-				}
+		switch (ReadKeyConsole()) {
+		case VK_F9:
+			selection = 1;
+			done = TRUE;
+			break;
+		case VK_F10:
+		case 0:
+			selection = 0;
+			done = TRUE;
+			break;
+		default:
+			break;
 		}
 	}
 
 	// Show the cursor.
-	info.bVisible = TRUE;
-	SetConsoleCursorInfo(hStdout, &info);
+	ShowCursorConsole(true);
 
 	return selection;
 }
 
-CHAR_INFO* SaveScreenBuffer(void) {
-	CHAR_INFO* chiBuffer;
-	CONSOLE_SCREEN_BUFFER_INFO csbi;
-	SMALL_RECT srctRect;
-	COORD coordBufSize;
-	COORD coordBufCoord;
-	BOOL fSuccess;
-
-	// Get the console screen buffer info. 
-	if (!GetConsoleScreenBufferInfo(hStdout, &csbi)) {
-		return NULL;
-	}
-
-	coordBufSize = csbi.dwSize;
-
-	chiBuffer = newArray(coordBufSize.X * coordBufSize.Y, CHAR_INFO);
-
-	// Set the source rectangle.
-
-	srctRect.Top = 0;
-	srctRect.Left = 0;
-	srctRect.Bottom = coordBufSize.Y - 1;
-	srctRect.Right = coordBufSize.X - 1;
-
-	// The top left destination cell of the temporary buffer is 
-	// row 0, col 0. 
+ConsoleCell* SaveScreenBuffer(void) {
+	COORD coordBufCoord = { 0, 0 };
+	COORD coordBufSize = GetSizeConsole();
+	ConsoleCell* cells = newArray(coordBufSize.X * coordBufSize.Y, ConsoleCell);
 
-	coordBufCoord.X = 0;
-	coordBufCoord.Y = 0;
+	// Copy the whole screen to the buffer.
 
-	// Copy the block from the screen buffer to the temp. buffer. 
-
-	fSuccess = ReadConsoleOutput(
-		hStdout,        // screen buffer to read from 
-		chiBuffer,      // buffer to copy into 
-		coordBufSize,   // col-row size of chiBuffer 
-		coordBufCoord,  // top left dest. cell in chiBuffer 
-		&srctRect); // screen buffer source rectangle 
-	if (!fSuccess) {
+	if (!ReadCellsConsole(cells, coordBufCoord, coordBufSize)) {
+		freeBlock(cells);
 		return NULL;
 	}
-	return chiBuffer;
+	return cells;
 }
 
-int RecoverScreenBuffer(CHAR_INFO* chiBuffer) {
-	CONSOLE_SCREEN_BUFFER_INFO csbi;
-	SMALL_RECT srctRect;
-	COORD coordBufSize;
-	COORD coordBufCoord;
-	BOOL fSuccess;
+int RecoverScreenBuffer(ConsoleCell* cells) {
+	COORD coordBufCoord = { 0, 0 };
 
-	// Get the console screen buffer info. 
-	if (!GetConsoleScreenBufferInfo(hStdout, &csbi)) {
+	if (cells == NULL) {
 		return 0;
 	}
 
-	coordBufSize = csbi.dwSize;
-
-	// Set the destination rectangle. 
-
-	srctRect.Top = 0;
-	srctRect.Left = 0;
-	srctRect.Bottom = coordBufSize.Y - 1;
-	srctRect.Right = coordBufSize.X - 1;
-
-	// The top left destination cell of the temporary buffer is 
-	// row 0, col 0. 
-
-	coordBufCoord.X = 0;
-	coordBufCoord.Y = 0;
+	// Copy from the buffer back to the screen.
 
-	// Copy from the temporary buffer to the new screen buffer. 
-
-	fSuccess = WriteConsoleOutput(
-		hStdout, // screen buffer to write to 
-		chiBuffer,        // buffer to copy from 
-		coordBufSize,     // col-row size of chiBuffer 
-		coordBufCoord,    // top left src cell in chiBuffer 
-		&srctRect);  // dest. screen buffer rectangle 
-	if (!fSuccess) {
-		return 0;
-	}
-	return 1;
-}
-
-void SetConsoleWindowSize(int x, int y) {
-	HANDLE h = GetStdHandle(STD_OUTPUT_HANDLE);
-
-	if (h == INVALID_HANDLE_VALUE)
-		error_msg("Unable to get stdout handle.");
-
-	// If either dimension is greater than the largest console window we can have,
-	// there is no point in attempting the change.
-	{
-		COORD largestSize = GetLargestConsoleWindowSize(h);
-		if (x > largestSize.X)
-			error_msg("The x dimension is too large.");
-		if (y > largestSize.Y)
-			error_msg("The y dimension is too large.");
-	}
-
-
-	CONSOLE_SCREEN_BUFFER_INFO bufferInfo;
-	if (!GetConsoleScreenBufferInfo(h, &bufferInfo))
-		error_msg("Unable to retrieve screen buffer info.");
-
-	SMALL_RECT winInfo = bufferInfo.srWindow;
-	COORD windowSize = { winInfo.Right - winInfo.Left + 1, winInfo.Bottom - winInfo.Top + 1 };
-
-	if (windowSize.X > x || windowSize.Y > y) {
-		// window size needs to be adjusted before the sb size can be reduced.
-		SMALL_RECT info =
-		{
-			0,
-			0,
-			x < windowSize.X ? x - 1 : windowSize.X - 1,
-			y < windowSize.Y ? y - 1 : windowSize.Y - 1
-		};
-
-		if (!SetConsoleWindowInfo(h, TRUE, &info))
-			error_msg("Unable to resize window before resizing buffer.");
-	}
-
-	COORD size = { x, y };
-	if (!SetConsoleScreenBufferSize(h, size))
-		error_msg("Unable to resize screen buffer.");
-
-
-	SMALL_RECT info = { 0, 0, x - 1, y - 1 };
-	if (!SetConsoleWindowInfo(h, TRUE, &info))
-		error_msg("Unable to resize window after resizing buffer.");
+	return WriteCellsConsole(cells, coordBufCoord, GetSizeConsole()) ? 1 : 0;
 }
 
 /**
@@ -943,6 +647,7 @@ void SetConsoleWindowSize(int x, int y) {
  */
 
 int fileToMap(string filename, Map map) {
+	TraceSpan span = BeginTraceSpan("fileToMap");
 	FILE* inFile = fopen(filename, "r");
 	if (!inFile) {
 		error_msg("fopen()");
@@ -954,10 +659,12 @@ int fileToMap(string filename, Map map) {
 		string key = substring(line, 0, delimPos - 1);
 		string value = substring(line, delimPos + 1, stringLength(line) - 1);
 		if (stringLength(key) == 0 || stringLength(value) == 0) {
+			EndTraceSpan(span);
 			return 0;
 		}
 		else {
 			if (containsKeyMap(map, key) == true) {
+				EndTraceSpan(span);
 				return 0;
 			}
 			putMap(map, key, value);
@@ -965,6 +672,7 @@ int fileToMap(string filename, Map map) {
 		freeBlock(line);
 	}
 	fclose(inFile);
+	EndTraceSpan(span);
 	return 1;
 }
 
@@ -994,3 +702,27 @@ void freeMapFields(Map Map) {
 
 	freeMap(Map);
 }
+
+// Private functions
+
+static Vector ReadEventsGeneration(string fileName, uint32_t* sequence) {
+	FILE* filepoint;
+	if (fopen_s(&filepoint, fileName, "rb") != 0) {
+		return NULL;
+	}
+
+	if (eventsArena == NULL) {
+		eventsArena = newArena();
+	}
+	Vector events;
+	if (IsEventFile(filepoint)) {
+		events = ReadEventFile(filepoint, eventsArena);
+		*sequence = GetEventFileSequence(filepoint);
+	}
+	else {
+		events = ReadLegacyEventFile(filepoint);
+		*sequence = 0;
+	}
+	fclose(filepoint);
+	return events;
+}
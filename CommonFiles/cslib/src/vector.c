@@ -4,6 +4,9 @@
  * This file implements the vector.h interface.
  */
 
+#ifdef _WIN32
+#include <Windows.h>
+#endif
 #include <stdio.h>
 #include "cslib.h"
 #include "iterator.h"
@@ -18,6 +21,18 @@
 
 #define INITIAL_CAPACITY 10
 
+/**
+ * @brief Ranges of at most this many elements are sorted by insertion sort.
+ */
+
+#define INSERTION_SORT_THRESHOLD 16
+
+/**
+ * @brief The stable sort extends shorter runs to this many elements by insertion sort before merging them.
+ */
+
+#define MIN_RUN 16
+
 /**
  * @brief The type VectorCDT is the concrete representation of the type Vector defined by the interface.
  */
@@ -27,12 +42,46 @@ struct VectorCDT {
    void **elements;
    int count;
    int capacity;
+   unsigned long version;
 };
 
+/**
+ * @brief Holds the last version given to a vector. Versions are shared by all vectors, so a new vector never gets the
+ * version of a freed one. It is advanced atomically, because the autosave worker sorts its snapshots on its own thread.
+ */
+
+static volatile long lastVersion = 0;
+
+#ifdef _WIN32
+#define NextVersion() InterlockedIncrement(&lastVersion)
+#else
+#define NextVersion() __atomic_add_fetch(&lastVersion, 1, __ATOMIC_RELAXED)
+#endif
+
+/**
+ * @brief The cursor of a vector iterator, which is the vector and the index of the next element.
+ */
+
+typedef struct {
+   Vector vector;
+   int index;
+} VectorCursor;
+
 /* Private function prototypes */
 
 static void expandCapacity(Vector vector);
+static void touchVector(Vector vector);
 static Iterator newVectorIterator(void *collection);
+static bool stepVectorIterator(Iterator iterator, void *dst);
+static void introSort(void **array, int begin, int end, int depthLimit, CompareFn cmpFn);
+static void insertionSort(void **array, int begin, int end, CompareFn cmpFn);
+static void heapSort(void **array, int begin, int end, CompareFn cmpFn);
+static void siftDown(void **array, int begin, int root, int count, CompareFn cmpFn);
+static bool isSortedRange(void **array, int begin, int end, CompareFn cmpFn);
+static bool reverseDescendingRange(void **array, int begin, int end, CompareFn cmpFn);
+static int compareByKeys(const void *p1, const void *p2, SortKey keys[], int nKeys);
+static void mergeSort(void **array, int count, SortKey keys[], int nKeys);
+static void mergeRuns(void **array, void **buffer, int begin, int mid, int end, SortKey keys[], int nKeys);
 
 /* Exported entries */
 
@@ -44,6 +93,7 @@ Vector newVector(void) {
    vector->elements = newArray(INITIAL_CAPACITY, void *);
    vector->count = 0;
    vector->capacity = INITIAL_CAPACITY;
+   touchVector(vector);
    return vector;
 }
 
@@ -65,6 +115,7 @@ Vector arrayToVector(void *array[], int n) {
    for (i = 0; i < n; i++) {
       vector->elements[i] = array[i];
    }
+   touchVector(vector);
    return vector;
 }
 
@@ -92,6 +143,7 @@ int sizeVector(Vector vector) {
 
 void clearVector(Vector vector) {
    vector->count = 0;
+   touchVector(vector);
 }
 
 Vector cloneVector(Vector vector) {
@@ -106,6 +158,7 @@ Vector cloneVector(Vector vector) {
    for (i = 0; i < vector->count; i++) {
       newvec->elements[i] = vector->elements[i];
    }
+   touchVector(newvec);
    return newvec;
 }
 
@@ -121,6 +174,7 @@ void setVector(Vector vector, int index, void *value) {
       error("get: Index value out of range");
    }
    vector->elements[index] = value;
+   touchVector(vector);
 }
 
 void addVector(Vector vector, void *value) {
@@ -128,6 +182,7 @@ void addVector(Vector vector, void *value) {
       expandCapacity(vector);
    }
    vector->elements[vector->count++] = value;
+   touchVector(vector);
 }
 
 void insert(Vector vector, int index, void *value) {
@@ -144,6 +199,7 @@ void insert(Vector vector, int index, void *value) {
    }
    vector->elements[index] = value;
    vector->count++;
+   touchVector(vector);
 }
 
 void removeVector(Vector vector, int index) {
@@ -156,10 +212,283 @@ void removeVector(Vector vector, int index) {
    for (i = index; i < vector->count; i++) {
       vector->elements[i] = vector->elements[i + 1];
    }
+   touchVector(vector);
+}
+
+unsigned long versionVector(Vector vector) {
+   return vector->version;
+}
+
+void sortVector(Vector vector, CompareFn cmpFn) {
+   sortVectorRange(vector, 0, vector->count, cmpFn);
+}
+
+void sortVectorRange(Vector vector, int begin, int end, CompareFn cmpFn) {
+   int n, depthLimit;
+
+   if (begin < 0 || end > vector->count) {
+      error("sortVectorRange: Index value out of range");
+   }
+   if (end - begin < 2) return;
+   touchVector(vector);
+   if (isSortedRange(vector->elements, begin, end, cmpFn)) return;
+   if (reverseDescendingRange(vector->elements, begin, end, cmpFn)) return;
+   depthLimit = 0;
+   for (n = end - begin; n > 1; n >>= 1) {
+      depthLimit += 2;
+   }
+   introSort(vector->elements, begin, end, depthLimit, cmpFn);
+}
+
+void stableSortVector(Vector vector, CompareFn cmpFn) {
+   SortKey key;
+
+   key.cmpFn = cmpFn;
+   key.direction = SORT_ASCENDING;
+   sortVectorByKeys(vector, &key, 1);
+}
+
+void sortVectorByKeys(Vector vector, SortKey keys[], int nKeys) {
+   if (nKeys <= 0) return;
+   mergeSort(vector->elements, vector->count, keys, nKeys);
+   touchVector(vector);
+}
+
+int insertSortedVector(Vector vector, void *value, SortKey keys[], int nKeys) {
+   int low, high, mid;
+
+   low = 0;
+   high = vector->count;
+   while (low < high) {
+      mid = low + (high - low) / 2;
+      if (compareByKeys(value, vector->elements[mid], keys, nKeys) < 0) {
+         high = mid;
+      } else {
+         low = mid + 1;
+      }
+   }
+   insert(vector, low, value);
+   return low;
 }
 
 /* Private functions */
 
+/**
+ * @brief Gives the vector a new version after every change.
+ */
+
+static void touchVector(Vector vector) {
+   vector->version = (unsigned long) NextVersion();
+}
+
+/**
+ * @brief Sorts the range by quicksort with a median-of-three pivot. The smaller partition is sorted recursively and the
+ * larger one in the loop, so the stack depth stays logarithmic. Once the depth limit is used up the range is finished by
+ * heapsort, and small ranges are left to insertion sort.
+ */
+
+static void introSort(void **array, int begin, int end, int depthLimit, CompareFn cmpFn) {
+   void *pivot, *tmp;
+   int mid, last, i, j;
+
+   while (end - begin > INSERTION_SORT_THRESHOLD) {
+      if (depthLimit-- == 0) {
+         heapSort(array, begin, end, cmpFn);
+         return;
+      }
+      last = end - 1;
+      mid = begin + (end - begin) / 2;
+
+      /* Order the first, middle and last element, which also places sentinels at both ends. */
+      if (cmpFn(array[mid], array[begin]) < 0) {
+         tmp = array[mid]; array[mid] = array[begin]; array[begin] = tmp;
+      }
+      if (cmpFn(array[last], array[mid]) < 0) {
+         tmp = array[last]; array[last] = array[mid]; array[mid] = tmp;
+         if (cmpFn(array[mid], array[begin]) < 0) {
+            tmp = array[mid]; array[mid] = array[begin]; array[begin] = tmp;
+         }
+      }
+
+      /* Park the pivot next to the last element and partition the range between the sentinels. */
+      pivot = array[mid];
+      array[mid] = array[last - 1];
+      array[last - 1] = pivot;
+      i = begin;
+      j = last - 1;
+      while (true) {
+         while (cmpFn(array[++i], pivot) < 0);
+         while (cmpFn(pivot, array[--j]) < 0);
+         if (i >= j) break;
+         tmp = array[i]; array[i] = array[j]; array[j] = tmp;
+      }
+      array[last - 1] = array[i];
+      array[i] = pivot;
+
+      if (i - begin < end - i - 1) {
+         introSort(array, begin, i, depthLimit, cmpFn);
+         begin = i + 1;
+      } else {
+         introSort(array, i + 1, end, depthLimit, cmpFn);
+         end = i;
+      }
+   }
+   insertionSort(array, begin, end, cmpFn);
+}
+
+static void insertionSort(void **array, int begin, int end, CompareFn cmpFn) {
+   void *value;
+   int i, j;
+
+   for (i = begin + 1; i < end; i++) {
+      value = array[i];
+      for (j = i; j > begin && cmpFn(value, array[j - 1]) < 0; j--) {
+         array[j] = array[j - 1];
+      }
+      array[j] = value;
+   }
+}
+
+static void heapSort(void **array, int begin, int end, CompareFn cmpFn) {
+   void *tmp;
+   int count, i;
+
+   count = end - begin;
+   for (i = count / 2 - 1; i >= 0; i--) {
+      siftDown(array, begin, i, count, cmpFn);
+   }
+   for (i = count - 1; i > 0; i--) {
+      tmp = array[begin]; array[begin] = array[begin + i]; array[begin + i] = tmp;
+      siftDown(array, begin, 0, i, cmpFn);
+   }
+}
+
+static void siftDown(void **array, int begin, int root, int count, CompareFn cmpFn) {
+   void *value;
+   int child;
+
+   value = array[begin + root];
+   while ((child = 2 * root + 1) < count) {
+      if (child + 1 < count && cmpFn(array[begin + child], array[begin + child + 1]) < 0) child++;
+      if (cmpFn(value, array[begin + child]) >= 0) break;
+      array[begin + root] = array[begin + child];
+      root = child;
+   }
+   array[begin + root] = value;
+}
+
+static bool isSortedRange(void **array, int begin, int end, CompareFn cmpFn) {
+   int i;
+
+   for (i = begin + 1; i < end; i++) {
+      if (cmpFn(array[i - 1], array[i]) > 0) return false;
+   }
+   return true;
+}
+
+/**
+ * @brief Reverses the range if it is in strictly descending order, which sorts it in linear time.
+ */
+
+static bool reverseDescendingRange(void **array, int begin, int end, CompareFn cmpFn) {
+   void *tmp;
+   int i, j;
+
+   for (i = begin + 1; i < end; i++) {
+      if (cmpFn(array[i - 1], array[i]) <= 0) return false;
+   }
+   for (i = begin, j = end - 1; i < j; i++, j--) {
+      tmp = array[i]; array[i] = array[j]; array[j] = tmp;
+   }
+   return true;
+}
+
+static int compareByKeys(const void *p1, const void *p2, SortKey keys[], int nKeys) {
+   int i, result;
+
+   for (i = 0; i < nKeys; i++) {
+      result = keys[i].cmpFn(p1, p2);
+      if (result != 0) return (keys[i].direction == SORT_DESCENDING) ? -result : result;
+   }
+   return 0;
+}
+
+/**
+ * @brief Natural merge sort. The array is split into the runs that are already ordered (strictly descending runs are
+ * reversed in place, which keeps the sort stable), short runs are extended by insertion sort and the neighbouring runs
+ * are merged until a single run is left.
+ */
+
+static void mergeSort(void **array, int count, SortKey keys[], int nKeys) {
+   void **buffer, *value, *tmp;
+   int *runs, nRuns, begin, end, limit, i, j;
+
+   if (count < 2) return;
+   runs = newArray(count / MIN_RUN + 2, int);
+   nRuns = 0;
+   runs[nRuns++] = 0;
+   for (begin = 0; begin < count; begin = end) {
+      end = begin + 1;
+      if (end < count && compareByKeys(array[end], array[begin], keys, nKeys) < 0) {
+         while (end < count && compareByKeys(array[end], array[end - 1], keys, nKeys) < 0) end++;
+         for (i = begin, j = end - 1; i < j; i++, j--) {
+            tmp = array[i]; array[i] = array[j]; array[j] = tmp;
+         }
+      } else {
+         while (end < count && compareByKeys(array[end], array[end - 1], keys, nKeys) >= 0) end++;
+      }
+      limit = (begin + MIN_RUN < count) ? begin + MIN_RUN : count;
+      for (; end < limit; end++) {
+         value = array[end];
+         for (j = end; j > begin && compareByKeys(value, array[j - 1], keys, nKeys) < 0; j--) {
+            array[j] = array[j - 1];
+         }
+         array[j] = value;
+      }
+      runs[nRuns++] = end;
+   }
+   if (nRuns > 2) {
+      buffer = newArray(count, void *);
+      while (nRuns > 2) {
+         for (i = 0, j = 0; i + 2 < nRuns; i += 2) {
+            mergeRuns(array, buffer, runs[i], runs[i + 1], runs[i + 2], keys, nKeys);
+            runs[j++] = runs[i];
+         }
+         if (i + 1 < nRuns) runs[j++] = runs[i];
+         runs[j++] = runs[nRuns - 1];
+         nRuns = j;
+      }
+      freeBlock(buffer);
+   }
+   freeBlock(runs);
+}
+
+/**
+ * @brief Merges the ordered ranges begin..mid and mid..end. Runs that are already in order are left untouched.
+ */
+
+static void mergeRuns(void **array, void **buffer, int begin, int mid, int end, SortKey keys[], int nKeys) {
+   int i, j, k;
+
+   if (compareByKeys(array[mid], array[mid - 1], keys, nKeys) >= 0) return;
+   for (i = begin; i < mid; i++) {
+      buffer[i] = array[i];
+   }
+   i = begin;
+   j = mid;
+   k = begin;
+   while (i < mid && j < end) {
+      if (compareByKeys(array[j], buffer[i], keys, nKeys) < 0) {
+         array[k++] = array[j++];
+      } else {
+         array[k++] = buffer[i++];
+      }
+   }
+   while (i < mid) {
+      array[k++] = buffer[i++];
+   }
+}
+
 static void expandCapacity(Vector vector) {
    void **array;
    int i, newCapacity;
@@ -175,19 +504,31 @@ static void expandCapacity(Vector vector) {
 }
 
 /**
- * @brief This functions makes it possible to use the general iterator facility on vectors.  For details on the general
- * strategy, see the comments in the itertype.h interface.
+ * @brief This functions makes it possible to use the general iterator facility on vectors.  The iterator is a cursor
+ * that walks the elements in place.  For details on the general strategy, see the comments in the itertype.h
+ * interface.
  */
 
 static Iterator newVectorIterator(void *collection) {
-   Vector vector;
    Iterator iterator;
-   int i;
+   VectorCursor *cursor;
 
-   vector = (Vector) collection;
-   iterator = newListIterator(sizeof (void *), NULL);
-   for (i = 0; i < vector->count; i++) {
-      addToIteratorList(iterator, &vector->elements[i]);
-   }
+   iterator = newCursorIterator(sizeof (void *), sizeof (VectorCursor), stepVectorIterator);
+   cursor = (VectorCursor *) getIteratorCursor(iterator);
+   cursor->vector = (Vector) collection;
+   cursor->index = 0;
    return iterator;
 }
+
+/**
+ * @brief Stores the next element of the vector through dst and advances the cursor.
+ */
+
+static bool stepVectorIterator(Iterator iterator, void *dst) {
+   VectorCursor *cursor;
+
+   cursor = (VectorCursor *) getIteratorCursor(iterator);
+   if (cursor->index >= cursor->vector->count) return false;
+   *((void **) dst) = cursor->vector->elements[cursor->index++];
+   return true;
+}
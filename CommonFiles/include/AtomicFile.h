@@ -0,0 +1,67 @@
+/**
+ * @file	AtomicFile.h.
+ *
+ * @brief	Declares the atomic file replacement interface.
+ *
+ * A data file is never rewritten in place. The new contents are written into a temporary file next
+ * to it (events.dat.tmp for events.dat), which is flushed to the disk and then renamed over the data
+ * file, so after a crash the data file holds either the old or the new contents, never a part of
+ * them. The replaced data file is kept as the backup (events.dat.bak), one generation deep, so it
+ * can be read when the data file turns out to be damaged anyway.
+ */
+
+#ifndef _atomic_file_h
+#define _atomic_file_h
+
+#include <stdio.h>
+#include "cslib.h"
+
+/**
+ * @fn	FILE* OpenAtomicFile(string fileName);
+ *
+ * @brief	Opens the temporary file that replaces the data file once it is committed.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	fileName	Filename of the data file.
+ *
+ * @returns	The stream opened for binary writing, or NULL if the temporary file can not be created.
+ */
+
+FILE* OpenAtomicFile(string fileName);
+
+/**
+ * @fn	bool CommitAtomicFile(FILE* filepoint, string fileName);
+ *
+ * @brief	Writes the temporary file to the disk, closes it, and replaces the data file with it.
+ * 			The data file is kept as the backup. If anything fails, the temporary file is deleted and
+ * 			the data file is left as it was.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param [in]	filepoint	The stream returned by OpenAtomicFile.
+ * @param 	  	fileName 	Filename of the data file.
+ *
+ * @returns	True if the data file has been replaced, false otherwise.
+ */
+
+bool CommitAtomicFile(FILE* filepoint, string fileName);
+
+/**
+ * @fn	string GetBackupNameAtomicFile(string fileName);
+ *
+ * @brief	Gets the name of the backup of the data file.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	fileName	Filename of the data file.
+ *
+ * @returns	The backup file name. The caller is responsible for freeing it.
+ */
+
+string GetBackupNameAtomicFile(string fileName);
+
+#endif // !_atomic_file_h
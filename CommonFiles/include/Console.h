@@ -0,0 +1,377 @@
+/**
+ * @file	Console.h.
+ *
+ * @brief	Declares the terminal interface.
+ *
+ * The applications draw and read the keys only through these functions, so they run in the
+ * Windows console as well as in the terminals of the other platforms. The Windows implementation
+ * uses the console API, while the other one puts the terminal into the raw mode with termios and
+ * draws with ANSI/VT escape sequences.
+ *
+ * The text uses the Windows-1250 code page on every platform. The other implementation converts it
+ * to UTF-8 on the way to the terminal, and the read lines back from UTF-8.
+ *
+ * The positions are zero-based, with the first line on the top of the screen. The attributes and
+ * the key codes are the ones of the Windows console; they are defined here for the other
+ * platforms.
+ */
+
+#ifndef _console_h
+#define _console_h
+
+#include "cslib.h"
+
+#ifdef _WIN32
+
+#include <Windows.h>
+
+#else
+
+/** @brief	Defines an alias representing the 16-bit unsigned number. */
+typedef unsigned short WORD;
+
+/** @brief	Defines an alias representing the 32-bit unsigned number. */
+typedef unsigned int DWORD;
+
+/** @brief	Defines an alias representing the boolean value. */
+typedef int BOOL;
+
+#ifndef TRUE
+#define TRUE 1
+#endif
+
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+/**
+ * @struct	COORD
+ *
+ * @brief	A position on the screen, or the size of a part of it.
+ */
+
+typedef struct {
+	short X;
+	short Y;
+} COORD;
+
+// Text attributes.
+#define FOREGROUND_BLUE      0x0001
+#define FOREGROUND_GREEN     0x0002
+#define FOREGROUND_RED       0x0004
+#define FOREGROUND_INTENSITY 0x0008
+#define BACKGROUND_BLUE      0x0010
+#define BACKGROUND_GREEN     0x0020
+#define BACKGROUND_RED       0x0040
+#define BACKGROUND_INTENSITY 0x0080
+
+// Key codes.
+#define VK_BACK   0x08
+#define VK_TAB    0x09
+#define VK_RETURN 0x0D
+#define VK_ESCAPE 0x1B
+#define VK_SPACE  0x20
+#define VK_PRIOR  0x21
+#define VK_NEXT   0x22
+#define VK_END    0x23
+#define VK_HOME   0x24
+#define VK_LEFT   0x25
+#define VK_UP     0x26
+#define VK_RIGHT  0x27
+#define VK_DOWN   0x28
+#define VK_INSERT 0x2D
+#define VK_DELETE 0x2E
+#define VK_F1     0x70
+#define VK_F2     0x71
+#define VK_F3     0x72
+#define VK_F4     0x73
+#define VK_F5     0x74
+#define VK_F6     0x75
+#define VK_F7     0x76
+#define VK_F8     0x77
+#define VK_F9     0x78
+#define VK_F10    0x79
+#define VK_F11    0x7A
+#define VK_F12    0x7B
+#define VK_OEM_1      0xBA
+#define VK_OEM_PLUS   0xBB
+#define VK_OEM_COMMA  0xBC
+#define VK_OEM_MINUS  0xBD
+#define VK_OEM_PERIOD 0xBE
+#define VK_OEM_2      0xBF
+#define VK_OEM_3      0xC0
+#define VK_OEM_4      0xDB
+#define VK_OEM_5      0xDC
+#define VK_OEM_6      0xDD
+#define VK_OEM_7      0xDE
+#define VK_PACKET     0xE7
+
+#endif
+
+/**
+ * @struct	ConsoleCell
+ *
+ * @brief	A single character cell of the screen.
+ */
+
+typedef struct {
+	char character;
+	WORD attributes;
+} ConsoleCell;
+
+/**
+ * @fn	bool OpenConsole(int width, int height);
+ *
+ * @brief	Prepares the terminal for the application: sets the code page and the size of the
+ * 			screen, and saves the state that is restored by CloseConsole.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	width 	The number of columns.
+ * @param 	height	The number of lines.
+ *
+ * @returns	True on success, false otherwise.
+ */
+
+bool OpenConsole(int width, int height);
+
+/**
+ * @fn	void CloseConsole(void);
+ *
+ * @brief	Restores the terminal to the state it had before OpenConsole.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ */
+
+void CloseConsole(void);
+
+/**
+ * @fn	COORD GetSizeConsole(void);
+ *
+ * @brief	Gets the size of the screen.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @returns	The number of columns and lines.
+ */
+
+COORD GetSizeConsole(void);
+
+/**
+ * @fn	COORD GetCursorConsole(void);
+ *
+ * @brief	Gets the cursor position.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @returns	The cursor position.
+ */
+
+COORD GetCursorConsole(void);
+
+/**
+ * @fn	void SetCursorConsole(COORD position);
+ *
+ * @brief	Moves the cursor.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	position	The new cursor position.
+ */
+
+void SetCursorConsole(COORD position);
+
+/**
+ * @fn	bool IsCursorVisibleConsole(void);
+ *
+ * @brief	Checks if the cursor is shown.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @returns	True if the cursor is shown, false otherwise.
+ */
+
+bool IsCursorVisibleConsole(void);
+
+/**
+ * @fn	void ShowCursorConsole(bool visible);
+ *
+ * @brief	Shows or hides the cursor.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	visible	True to show the cursor, false to hide it.
+ */
+
+void ShowCursorConsole(bool visible);
+
+/**
+ * @fn	WORD GetAttributesConsole(void);
+ *
+ * @brief	Gets the attributes of the written text.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @returns	The text attributes.
+ */
+
+WORD GetAttributesConsole(void);
+
+/**
+ * @fn	void SetAttributesConsole(WORD attributes);
+ *
+ * @brief	Sets the attributes of the written text.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	attributes	The text attributes.
+ */
+
+void SetAttributesConsole(WORD attributes);
+
+/**
+ * @fn	int WriteTextConsole(const char* text, int length);
+ *
+ * @brief	Writes the text at the cursor position with the current attributes, and moves the
+ * 			cursor after it.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	text  	The text.
+ * @param 	length	The number of characters to write.
+ *
+ * @returns	The number of written characters, or -1 on failure.
+ */
+
+int WriteTextConsole(const char* text, int length);
+
+/**
+ * @fn	void FillConsole(COORD position, int count, char character, WORD attributes);
+ *
+ * @brief	Fills the cells from the position on with the character. The cursor is not moved.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	position  	The first cell.
+ * @param 	count	  	The number of cells, continuing in the next lines.
+ * @param 	character 	The character.
+ * @param 	attributes	The attributes.
+ */
+
+void FillConsole(COORD position, int count, char character, WORD attributes);
+
+/**
+ * @fn	void ClearConsole(void);
+ *
+ * @brief	Clears the whole screen with the current attributes and moves the cursor to the top
+ * 			left corner.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ */
+
+void ClearConsole(void);
+
+/**
+ * @fn	bool ReadCellsConsole(ConsoleCell* cells, COORD position, COORD size);
+ *
+ * @brief	Reads the shown cells of the rectangle, line by line.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param [out]	cells   	The array of size.X * size.Y cells.
+ * @param 	   	position	The top left corner of the rectangle.
+ * @param 	   	size		The size of the rectangle.
+ *
+ * @returns	True on success, false otherwise.
+ */
+
+bool ReadCellsConsole(ConsoleCell* cells, COORD position, COORD size);
+
+/**
+ * @fn	bool WriteCellsConsole(const ConsoleCell* cells, COORD position, COORD size);
+ *
+ * @brief	Writes the cells of the rectangle, line by line, with a single write. The cursor is not
+ * 			moved.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	cells   	The array of size.X * size.Y cells.
+ * @param 	position	The top left corner of the rectangle.
+ * @param 	size		The size of the rectangle.
+ *
+ * @returns	True on success, false otherwise.
+ */
+
+bool WriteCellsConsole(const ConsoleCell* cells, COORD position, COORD size);
+
+/**
+ * @fn	WORD ReadKeyConsole(void);
+ *
+ * @brief	Waits for a key press. The releases and the modifier keys on their own are skipped.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @returns	The key code of the pressed key, or 0 on failure. The character keys have the key codes of
+ * 			the Windows console for the US layout on both platforms, so a character is never taken
+ * 			for a special key; the typed character is given by GetKeyCharConsole.
+ */
+
+WORD ReadKeyConsole(void);
+
+/**
+ * @fn	char GetKeyCharConsole(void);
+ *
+ * @brief	Gets the character of the key that was last read by ReadKeyConsole, in the
+ * 			Windows-1250 code page.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @returns	The character, or 0 if the key has no character.
+ */
+
+char GetKeyCharConsole(void);
+
+/**
+ * @fn	int ReadCharConsole(void);
+ *
+ * @brief	Reads a single character without showing it. The keys that have no character are
+ * 			reported as 0, followed by a code of the key on the next call.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @returns	The character.
+ */
+
+int ReadCharConsole(void);
+
+/**
+ * @fn	string ReadLineConsole(void);
+ *
+ * @brief	Reads a line of text, which is shown while it is typed.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @returns	The line without the line end, or NULL at the end of the input.
+ */
+
+string ReadLineConsole(void);
+
+#endif // !_console_h
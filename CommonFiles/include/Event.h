@@ -37,7 +37,7 @@ Event newEvent(void);
 /**
  * @fn	void freeEvent(Event event);
  *
- * @brief	Free event
+ * @brief	Free event, and give back its references to the shared strings.
  *
  * @author	Pynikleois
  * @date	26.12.2019.
@@ -47,6 +47,39 @@ Event newEvent(void);
 
 void freeEvent(Event event);
 
+/**
+ * @fn	Event cloneEvent(Event event);
+ *
+ * @brief	Creates a copy of the event. The copy shares the field strings with the original, taking
+ * 			its own references to them, so the setters and freeEvent of one event do not affect
+ * 			the other.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	event	The event.
+ *
+ * @returns	A copy of the event.
+ */
+
+Event cloneEvent(Event event);
+
+/**
+ * @fn	bool equalEvents(Event first, Event second);
+ *
+ * @brief	Checks if two events have equal values in all of their fields.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	first 	The first event.
+ * @param 	second	The second event.
+ *
+ * @returns	True if the events are equal, false otherwise.
+ */
+
+bool equalEvents(Event first, Event second);
+
 /**
  * @fn	string getEventName(Event event);
  *
@@ -65,7 +98,7 @@ string getEventName(Event event);
 /**
  * @fn	void setEventName(Event event, string name);
  *
- * @brief	Sets event name
+ * @brief	Sets event name. The event keeps a shared copy of the name, so the caller still owns it.
  *
  * @author	Pynikleois
  * @date	26.12.2019.
@@ -94,7 +127,8 @@ string getEventDescription(Event event);
 /**
  * @fn	void setEventDescription(Event event, string desc);
  *
- * @brief	Sets event description
+ * @brief	Sets event description. The event keeps a shared copy of the description, so the caller
+ * 			still owns it.
  *
  * @author	Pynikleois
  * @date	26.12.2019.
@@ -123,7 +157,8 @@ string getEventLocation(Event event);
 /**
  * @fn	void setEventLocation(Event event, string location);
  *
- * @brief	Sets event location
+ * @brief	Sets event location. The event keeps a shared copy of the location, so the caller still
+ * 			owns it.
  *
  * @author	Pynikleois
  * @date	26.12.2019.
@@ -134,6 +169,40 @@ string getEventLocation(Event event);
 
 void setEventLocation(Event event, string location);
 
+/**
+ * @fn	void pinEventStrings(Event event, string name, string desc, string location);
+ *
+ * @brief	Sets the event name, description and location without copying them. The strings must
+ * 			outlive the event and all of its clones, like those of the mapped data file.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	event   	The event.
+ * @param 	name    	The name.
+ * @param 	desc    	The description.
+ * @param 	location	The location.
+ */
+
+void pinEventStrings(Event event, string name, string desc, string location);
+
+/**
+ * @fn	void adoptEventStrings(Event event, string name, string desc, string location);
+ *
+ * @brief	Sets the event name, description and location to shared strings without copying them.
+ * 			The event takes over the caller's references to the strings.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	event   	The event.
+ * @param 	name    	The shared name.
+ * @param 	desc    	The shared description.
+ * @param 	location	The shared location.
+ */
+
+void adoptEventStrings(Event event, string name, string desc, string location);
+
 /**
  * @fn	string getEventCategory(Event event);
  *
@@ -149,10 +218,26 @@ void setEventLocation(Event event, string location);
 
 string getEventCategory(Event event);
 
+/**
+ * @fn	int getEventCategoryId(Event event);
+ *
+ * @brief	Gets the ID of the event category in the category symbol table.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	event	The event.
+ *
+ * @returns	The category ID, or NO_EVENT_CATEGORY if the event has no category.
+ */
+
+int getEventCategoryId(Event event);
+
 /**
  * @fn	void setEventCategory(Event event, string category);
  *
- * @brief	Sets event category
+ * @brief	Sets event category. The name is interned in the category symbol table, so the event
+ * 			keeps only its ID and the caller keeps the ownership of the string.
  *
  * @author	Pynikleois
  * @date	26.12.2019.
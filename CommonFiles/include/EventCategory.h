@@ -9,6 +9,9 @@
 
 #include "cslib.h"
 
+/** @brief	The category ID of an event without a category. */
+#define NO_EVENT_CATEGORY -1
+
 /**
  * @typedef	EventCategoryCDT*
  *
@@ -77,4 +80,64 @@ void setEventCategoryName(EventCategory category, string name);
 
 int CompareEventCategoryName(const void* p1, const void* p2);
 
+/**
+ * @fn	int internEventCategory(string name);
+ *
+ * @brief	Gets the ID of the category name from the category symbol table, adding the name on the
+ * 			first use. The IDs are given out from zero on, in the order the names are added, so the
+ * 			categories read from the categories data file come first.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	name	The category name. It is copied, the caller keeps the ownership.
+ *
+ * @returns	The category ID, or NO_EVENT_CATEGORY if the name is NULL.
+ */
+
+int internEventCategory(string name);
+
+/**
+ * @fn	int findEventCategoryId(string name);
+ *
+ * @brief	Looks the category name up in the category symbol table, without adding it.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	name	The category name.
+ *
+ * @returns	The category ID, or NO_EVENT_CATEGORY if the name was never added.
+ */
+
+int findEventCategoryId(string name);
+
+/**
+ * @fn	string getInternedEventCategory(int id);
+ *
+ * @brief	Gets the category name of the ID from the category symbol table.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	id	The category ID.
+ *
+ * @returns	The category name, which belongs to the symbol table, or NULL for NO_EVENT_CATEGORY.
+ */
+
+string getInternedEventCategory(int id);
+
+/**
+ * @fn	int countEventCategoryIds(void);
+ *
+ * @brief	Gets the number of the names in the category symbol table.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @returns	The number of category IDs.
+ */
+
+int countEventCategoryIds(void);
+
 #endif // !_event_category_h
@@ -0,0 +1,117 @@
+/**
+ * @file	EventCategoryIndex.h.
+ *
+ * @brief	Declares the event category index interface.
+ *
+ * The index keeps a posting list for every category: the positions of the events of the category in
+ * the events vector, in the ascending order. The lists are found by the IDs of the interned
+ * categories, so browsing a category costs as much as the number of its events, and the names are
+ * never compared. All lists are built together by a single pass over the events. An inserted, a
+ * deleted or a changed event is put into the list of its category or taken out of it, and the lists
+ * are built again only when the events vector has changed in another way, such as by sorting.
+ */
+
+#ifndef _event_category_index_h
+#define _event_category_index_h
+
+#include "cslib.h"
+#include "vector.h"
+#include "Event.h"
+
+/** @brief	Defines an alias representing the event category index. */
+typedef struct EventCategoryIndexCDT* EventCategoryIndex;
+
+/**
+ * @fn	EventCategoryIndex NewEventCategoryIndex(Vector events);
+ *
+ * @brief	Creates the category index of the events. The vector is not copied, it has to outlive
+ * 			the index.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	events	The events vector.
+ *
+ * @returns	The new index.
+ */
+
+EventCategoryIndex NewEventCategoryIndex(Vector events);
+
+/**
+ * @fn	void FreeEventCategoryIndex(EventCategoryIndex index);
+ *
+ * @brief	Frees the index. The events are not freed.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	index	The index.
+ */
+
+void FreeEventCategoryIndex(EventCategoryIndex index);
+
+/**
+ * @fn	void InsertEventCategoryIndex(EventCategoryIndex index, int row, unsigned long version);
+ *
+ * @brief	Adds the event that has been inserted into the events vector to the index.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	index  	The index.
+ * @param 	row	   	The position of the inserted event.
+ * @param 	version	The version of the events vector before the insertion.
+ */
+
+void InsertEventCategoryIndex(EventCategoryIndex index, int row, unsigned long version);
+
+/**
+ * @fn	void DeleteEventCategoryIndex(EventCategoryIndex index, int row, Event event, unsigned long version);
+ *
+ * @brief	Removes the event that has been removed from the events vector from the index.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	index  	The index.
+ * @param 	row	   	The position the event had.
+ * @param 	event  	The removed event.
+ * @param 	version	The version of the events vector before the removal.
+ */
+
+void DeleteEventCategoryIndex(EventCategoryIndex index, int row, Event event, unsigned long version);
+
+/**
+ * @fn	void UpdateEventCategoryIndex(EventCategoryIndex index, int row, Event oldEvent);
+ *
+ * @brief	Moves the changed event into the list of its new category.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	index   	The index.
+ * @param 	row			The position of the changed event.
+ * @param 	oldEvent	A copy of the event values before the change.
+ */
+
+void UpdateEventCategoryIndex(EventCategoryIndex index, int row, Event oldEvent);
+
+/**
+ * @fn	int GetRowsEventCategoryIndex(EventCategoryIndex index, string category, const int** rows);
+ *
+ * @brief	Gets the posting list of the category.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	index   	The index.
+ * @param 	category	The category name.
+ * @param 	rows		Set to the positions of the events of the category in the events vector. The
+ * 						array belongs to the index and is valid until the vector changes.
+ *
+ * @returns	The number of the events of the category.
+ */
+
+int GetRowsEventCategoryIndex(EventCategoryIndex index, string category, const int** rows);
+
+#endif // !_event_category_index_h
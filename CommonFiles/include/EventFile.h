@@ -0,0 +1,283 @@
+/**
+ * @file	EventFile.h.
+ *
+ * @brief	Declares the events data file interface.
+ *
+ * The events data file starts with a fixed size header that holds the magic, the format version,
+ * the number of events, the sequence number of the last journal record the file already contains
+ * (see EventJournal.h) and the position of the offset table. The header is followed by the event
+ * records and the offset table that holds the position of every record, so any event can be read
+ * directly. The file ends with the checksum of all of the above, so a damaged or a partly written
+ * file is not mistaken for a valid one. All numbers are stored in little-endian byte order
+ * regardless of the platform.
+ *
+ * Every string is stored as a 32-bit length followed by the characters and a terminating NUL
+ * character, and the time is stored as a 64-bit number of seconds.
+ *
+ * Files written by the older versions of the applications (a raw count followed by NUL terminated
+ * strings and raw time values) are still readable, and can be converted to the current format.
+ */
+
+#ifndef _event_file_h
+#define _event_file_h
+
+#include <stdio.h>
+#include <stdint.h>
+#include "cslib.h"
+#include "vector.h"
+#include "arena.h"
+#include "Event.h"
+
+/** @brief	The magic that marks an events data file. */
+#define EVENT_FILE_MAGIC "SDGE"
+
+/** @brief	The current version of the events data file format. */
+#define EVENT_FILE_VERSION 2
+
+/** @brief	Size of the events data file header in bytes. */
+#define EVENT_FILE_HEADER_SIZE 24
+
+/** @brief	Defines an alias representing the events data file writer. */
+typedef struct EventFileWriterCDT* EventFileWriter;
+
+/** @brief	Defines an alias representing the read-only mapping of the events data file. */
+typedef struct EventFileMappingCDT* EventFileMapping;
+
+/**
+ * @fn	bool IsEventFile(FILE* filepoint);
+ *
+ * @brief	Checks if the stream holds an events data file in the current format. The stream is
+ * 			rewound afterwards.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param [in]	filepoint	The stream opened for binary reading.
+ *
+ * @returns	True if the stream starts with the events data file magic, false otherwise.
+ */
+
+bool IsEventFile(FILE* filepoint);
+
+/**
+ * @fn	Vector ReadEventFile(FILE* filepoint, Arena arena);
+ *
+ * @brief	Reads all events from the stream. The whole file is read with a single call and the
+ * 			records are parsed from memory. The strings are allocated from the arena, so they are
+ * 			released together with it.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param [in]	filepoint	The stream opened for binary reading.
+ * @param 	  	arena	 	The arena that holds the strings. It has to outlive the events.
+ *
+ * @returns	The events vector, or NULL if the stream does not hold a valid events data file or its
+ * 			checksum does not match.
+ */
+
+Vector ReadEventFile(FILE* filepoint, Arena arena);
+
+/**
+ * @fn	EventFileMapping MapEventFile(string fileName);
+ *
+ * @brief	Maps the events data file into memory for reading.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	fileName	Filename of the events data file.
+ *
+ * @returns	The mapping, or NULL if the file can not be mapped or is not in the current format.
+ */
+
+EventFileMapping MapEventFile(string fileName);
+
+/**
+ * @fn	Vector ReadMappedEventFile(EventFileMapping mapping);
+ *
+ * @brief	Creates the events whose fields point straight into the mapped file, without copying
+ * 			the strings. The strings are read-only; the setters only replace the field pointer, so
+ * 			a changed field is the only one that lives outside the mapping. The mapping has to
+ * 			outlive the events.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	mapping	The mapping.
+ *
+ * @returns	The events vector, or NULL if the mapped file is not valid or its checksum does not
+ * 			match.
+ */
+
+Vector ReadMappedEventFile(EventFileMapping mapping);
+
+/**
+ * @fn	void UnmapEventFile(EventFileMapping mapping);
+ *
+ * @brief	Unmaps the events data file and frees the mapping.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	mapping	The mapping.
+ */
+
+void UnmapEventFile(EventFileMapping mapping);
+
+/**
+ * @fn	Event ReadEventFileAt(FILE* filepoint, size_t index);
+ *
+ * @brief	Reads a single event using the offset table, without reading the preceding events. The
+ * 			checksum is not verified.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param [in]	filepoint	The stream opened for binary reading.
+ * @param 	  	index	 	Zero-based index of the event.
+ *
+ * @returns	The event, or NULL if the index is out of range or the file is not valid.
+ */
+
+Event ReadEventFileAt(FILE* filepoint, size_t index);
+
+/**
+ * @fn	Vector ReadLegacyEventFile(FILE* filepoint);
+ *
+ * @brief	Reads all events from the stream that holds an events data file in the legacy format.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param [in]	filepoint	The stream opened for binary reading.
+ *
+ * @returns	The events vector.
+ */
+
+Vector ReadLegacyEventFile(FILE* filepoint);
+
+/**
+ * @fn	size_t WriteEventRecord(FILE* filepoint, Event event);
+ *
+ * @brief	Writes a single event record at the current position of the stream.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param [in]	filepoint	The stream opened for binary writing.
+ * @param 	  	event	 	The event.
+ *
+ * @returns	The number of bytes written.
+ */
+
+size_t WriteEventRecord(FILE* filepoint, Event event);
+
+/**
+ * @fn	Event ReadEventRecord(FILE* filepoint);
+ *
+ * @brief	Reads a single event record from the current position of the stream.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param [in]	filepoint	The stream opened for binary reading.
+ *
+ * @returns	The event, or NULL if the stream ends before the whole record is read.
+ */
+
+Event ReadEventRecord(FILE* filepoint);
+
+/**
+ * @fn	EventFileWriter NewEventFileWriter(FILE* filepoint, uint32_t sequence);
+ *
+ * @brief	Creates a writer that writes the events data file to the stream one event at a time.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param [in]	filepoint	The stream opened for binary writing.
+ * @param 	  	sequence 	The sequence number of the last journal record the events contain.
+ *
+ * @returns	The writer.
+ */
+
+EventFileWriter NewEventFileWriter(FILE* filepoint, uint32_t sequence);
+
+/**
+ * @fn	void AppendEventFileWriter(EventFileWriter writer, Event event);
+ *
+ * @brief	Appends the event to the events data file.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	writer	The writer.
+ * @param 	event 	The event.
+ */
+
+void AppendEventFileWriter(EventFileWriter writer, Event event);
+
+/**
+ * @fn	void CloseEventFileWriter(EventFileWriter writer);
+ *
+ * @brief	Writes the offset table, completes the header and frees the writer. The stream is not
+ * 			closed.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	writer	The writer.
+ */
+
+void CloseEventFileWriter(EventFileWriter writer);
+
+/**
+ * @fn	void WriteEventFile(FILE* filepoint, Vector events, uint32_t sequence);
+ *
+ * @brief	Writes all events to the stream in the current format.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param [in]	filepoint	The stream opened for binary writing.
+ * @param 	  	events   	The events vector.
+ * @param 	  	sequence 	The sequence number of the last journal record the events contain.
+ */
+
+void WriteEventFile(FILE* filepoint, Vector events, uint32_t sequence);
+
+/**
+ * @fn	uint32_t GetEventFileSequence(FILE* filepoint);
+ *
+ * @brief	Reads the sequence number of the last journal record the events data file contains.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param [in]	filepoint	The stream opened for binary reading.
+ *
+ * @returns	The sequence number, or zero if the file holds no journal records or is not an events
+ * 			data file.
+ */
+
+uint32_t GetEventFileSequence(FILE* filepoint);
+
+/**
+ * @fn	bool ConvertLegacyEventFile(string fileName);
+ *
+ * @brief	Converts the events data file from the legacy format to the current one. Files that are
+ * 			already in the current format are left as they are. The legacy file is kept as the
+ * 			backup (see AtomicFile.h).
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	fileName	Filename of the events data file.
+ *
+ * @returns	True if the file has been converted, false otherwise.
+ */
+
+bool ConvertLegacyEventFile(string fileName);
+
+#endif // !_event_file_h
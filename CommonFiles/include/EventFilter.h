@@ -0,0 +1,163 @@
+/**
+ * @file	EventFilter.h.
+ *
+ * @brief	Declares the event filter interface.
+ *
+ * The filter is typed right into a view of an events table: the view then shows only the events that
+ * have a word starting with every typed word in their names or locations (see EventPrefixIndex.h),
+ * in the order of the view. The matching events are shown through another view, so nothing is
+ * copied while the filter is being typed. The prefix index is built when the first character is
+ * typed.
+ */
+
+#ifndef _event_filter_h
+#define _event_filter_h
+
+#include "cslib.h"
+#include "Console.h"
+#include "Table.h"
+
+/** @brief	Defines an alias representing the event filter. */
+typedef struct EventFilterCDT* EventFilter;
+
+/**
+ * @fn	EventFilter NewEventFilter(TableView events);
+ *
+ * @brief	Creates an empty filter of the view of the events table.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	events	The view of the events table. It has to outlive the filter.
+ *
+ * @returns	The new filter.
+ */
+
+EventFilter NewEventFilter(TableView events);
+
+/**
+ * @fn	void FreeEventFilter(EventFilter filter);
+ *
+ * @brief	Frees the filter. The filtered view is not freed.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	filter	The filter.
+ */
+
+void FreeEventFilter(EventFilter filter);
+
+/**
+ * @fn	bool IsActiveEventFilter(EventFilter filter);
+ *
+ * @brief	Checks whether anything is typed into the filter.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	filter	The filter.
+ *
+ * @returns	True if the filter is active, false otherwise.
+ */
+
+bool IsActiveEventFilter(EventFilter filter);
+
+/**
+ * @fn	bool TypeEventFilter(EventFilter filter, char ch);
+ *
+ * @brief	Adds the typed character to the filter. Only the letters, the digits and the spaces
+ * 			between the words are taken.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	filter	The filter.
+ * @param 	ch	  	The character, in the Windows-1250 code page.
+ *
+ * @returns	True if the character was taken, false otherwise.
+ */
+
+bool TypeEventFilter(EventFilter filter, char ch);
+
+/**
+ * @fn	bool EraseEventFilter(EventFilter filter);
+ *
+ * @brief	Removes the last typed character from the filter.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	filter	The filter.
+ *
+ * @returns	True if a character was removed, false if the filter was empty.
+ */
+
+bool EraseEventFilter(EventFilter filter);
+
+/**
+ * @fn	int ClearEventFilter(EventFilter filter, int selection);
+ *
+ * @brief	Removes the whole filter, so the view shows all its events again.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	filter   	The filter.
+ * @param 	selection	The selection among the matching events.
+ *
+ * @returns	The selection of the same event in the view.
+ */
+
+int ClearEventFilter(EventFilter filter, int selection);
+
+/**
+ * @fn	void RefreshEventFilter(EventFilter filter);
+ *
+ * @brief	Applies the filter again after the events have been added, changed, removed or sorted,
+ * 			or the view has been sorted.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	filter	The filter.
+ */
+
+void RefreshEventFilter(EventFilter filter);
+
+/**
+ * @fn	int GetRowEventFilter(EventFilter filter, int selection);
+ *
+ * @brief	Gets the position of the selected event in the data of the table.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	filter   	The filter.
+ * @param 	selection	The selection among the matching events, or in the view if the filter is
+ * 						not active.
+ *
+ * @returns	The position, or -1 if no event is selected.
+ */
+
+int GetRowEventFilter(EventFilter filter, int selection);
+
+/**
+ * @fn	int MainEventFilter(EventFilter filter, int* selection, WORD* keyCode);
+ *
+ * @brief	Shows the matching events, or the whole view if the filter is not active, the same as
+ * 			MainTable.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 		  	filter   	The filter.
+ * @param [in,out]	selection	The selection among the shown events.
+ * @param [out]   	keyCode  	The key that closed the table.
+ *
+ * @returns	1 on success, 0 otherwise.
+ */
+
+int MainEventFilter(EventFilter filter, int* selection, WORD* keyCode);
+
+#endif // !_event_filter_h
@@ -0,0 +1,192 @@
+/**
+ * @file	EventJournal.h.
+ *
+ * @brief	Declares the events journal interface.
+ *
+ * The journal is an append-only log that lives next to the events data file (events.dat.log for
+ * events.dat). Instead of rewriting the whole data file after every change, the admin application
+ * appends a small insert, delete or update record to the journal. The journal is replayed on top of
+ * the data file when the events are read, and it is periodically compacted into the data file.
+ *
+ * Every record has a sequence number, and the data file holds the sequence number of the last
+ * record it contains. When the data file is written by the autosave worker (see EventSaver.h), the
+ * journal keeps growing until the worker catches up, and the records that are already in the data
+ * file are skipped when the journal is replayed.
+ */
+
+#ifndef _event_journal_h
+#define _event_journal_h
+
+#include "cslib.h"
+#include "vector.h"
+#include <stdint.h>
+#include "Event.h"
+#include "EventSaver.h"
+
+/** @brief	Number of journal records after which the journal is compacted into the data file. */
+#define JOURNAL_COMPACT_THRESHOLD 256
+
+/**
+ * @fn	string GetEventJournalName(string fileName);
+ *
+ * @brief	Gets the name of the journal that belongs to the events data file.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	fileName	Filename of the events data file.
+ *
+ * @returns	The journal file name. The caller is responsible for freeing it.
+ */
+
+string GetEventJournalName(string fileName);
+
+/**
+ * @fn	void JournalEventInsert(Vector events, string fileName, Event event);
+ *
+ * @brief	Records that the event has been added to the events vector.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	events  	The events vector (used when the journal needs compacting).
+ * @param 	fileName	Filename of the events data file.
+ * @param 	event   	The added event.
+ */
+
+void JournalEventInsert(Vector events, string fileName, Event event);
+
+/**
+ * @fn	void JournalEventDelete(Vector events, string fileName, Event event);
+ *
+ * @brief	Records that the event has been removed from the events vector.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	events  	The events vector (used when the journal needs compacting).
+ * @param 	fileName	Filename of the events data file.
+ * @param 	event   	The removed event.
+ */
+
+void JournalEventDelete(Vector events, string fileName, Event event);
+
+/**
+ * @fn	void JournalEventUpdate(Vector events, string fileName, Event oldEvent, Event newEvent);
+ *
+ * @brief	Records that the event has been changed.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	events  	The events vector (used when the journal needs compacting).
+ * @param 	fileName	Filename of the events data file.
+ * @param 	oldEvent	The event values before the change.
+ * @param 	newEvent	The event values after the change.
+ */
+
+void JournalEventUpdate(Vector events, string fileName, Event oldEvent, Event newEvent);
+
+/**
+ * @fn	int ReplayEventJournal(Vector events, string fileName);
+ *
+ * @brief	Applies the journal records to the events read from the data file. A torn record at the
+ * 			end of the journal is ignored.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	events  	The events read from the data file.
+ * @param 	fileName	Filename of the events data file.
+ *
+ * @returns	The number of applied records.
+ */
+
+int ReplayEventJournal(Vector events, string fileName);
+
+/**
+ * @fn	int ReplayEventJournalAfter(Vector events, string fileName, uint32_t folded);
+ *
+ * @brief	Applies the journal records to the events, skipping the records the events already
+ * 			contain. Used when the events were read from a file other than the data file, like its
+ * 			backup.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	events  	The events read from the file.
+ * @param 	fileName	Filename of the events data file.
+ * @param 	folded  	The sequence number of the last journal record the events contain.
+ *
+ * @returns	The number of applied records.
+ */
+
+int ReplayEventJournalAfter(Vector events, string fileName, uint32_t folded);
+
+/**
+ * @fn	void ResetEventJournal(string fileName);
+ *
+ * @brief	Deletes the journal. Called once its records are contained in the data file.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	fileName	Filename of the events data file.
+ */
+
+void ResetEventJournal(string fileName);
+
+/**
+ * @fn	void CompactEventJournal(Vector events, string fileName);
+ *
+ * @brief	Writes all events into the data file and deletes the journal. With an attached autosave
+ * 			worker the events are queued for writing, and the journal is deleted with the first
+ * 			change after the worker has written them.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	events  	The events vector.
+ * @param 	fileName	Filename of the events data file.
+ */
+
+void CompactEventJournal(Vector events, string fileName);
+
+/**
+ * @fn	uint32_t GetEventJournalSequence(void);
+ *
+ * @brief	Gets the sequence number of the last journal record.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @returns	The sequence number, or the sequence number of the data file if the journal is empty.
+ */
+
+uint32_t GetEventJournalSequence(void);
+
+/**
+ * @fn	void AttachEventJournalSaver(EventSaver saver);
+ *
+ * @brief	Makes the journal compact into the data file through the autosave worker.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	saver	The saver.
+ */
+
+void AttachEventJournalSaver(EventSaver saver);
+
+/**
+ * @fn	void DetachEventJournalSaver(void);
+ *
+ * @brief	Makes the journal compact into the data file right away again.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ */
+
+void DetachEventJournalSaver(void);
+
+#endif // !_event_journal_h
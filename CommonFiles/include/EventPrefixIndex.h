@@ -0,0 +1,89 @@
+/**
+ * @file	EventPrefixIndex.h.
+ *
+ * @brief	Declares the event prefix index interface.
+ *
+ * The index holds every folded word (see TextFold.h) of the names and the locations of the events,
+ * sorted, so the words that start with a prefix are next to each other and are found with two
+ * binary searches. An event matches a filter if every word of the filter starts a word of its name
+ * or location.
+ *
+ * The filter is usually typed a character at a time. When the new filter only extends the previous
+ * one, the search is limited to the words and the events the previous filter has found, so every
+ * keystroke narrows the previous result instead of looking at all events again.
+ *
+ * The index follows the order of the events vector: it is rebuilt on the first query after the
+ * vector has changed, and the events are reported by their positions in it.
+ */
+
+#ifndef _event_prefix_index_h
+#define _event_prefix_index_h
+
+#include "cslib.h"
+#include "vector.h"
+
+/** @brief	Defines an alias representing the event prefix index. */
+typedef struct EventPrefixIndexCDT* EventPrefixIndex;
+
+/**
+ * @fn	EventPrefixIndex NewEventPrefixIndex(Vector events);
+ *
+ * @brief	Creates the prefix index of the events. The vector is not copied, it has to outlive the
+ * 			index.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	events	The events vector.
+ *
+ * @returns	The new index.
+ */
+
+EventPrefixIndex NewEventPrefixIndex(Vector events);
+
+/**
+ * @fn	void FreeEventPrefixIndex(EventPrefixIndex index);
+ *
+ * @brief	Frees the index. The events are not freed.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	index	The index.
+ */
+
+void FreeEventPrefixIndex(EventPrefixIndex index);
+
+/**
+ * @fn	void InvalidateEventPrefixIndex(EventPrefixIndex index);
+ *
+ * @brief	Makes the index rebuild itself on the next query. It is needed when an event is changed
+ * 			in place, which the events vector does not notice.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	index	The index.
+ */
+
+void InvalidateEventPrefixIndex(EventPrefixIndex index);
+
+/**
+ * @fn	int QueryEventPrefixIndex(EventPrefixIndex index, string filter, const int** rows);
+ *
+ * @brief	Finds the events that match the filter.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	index	The index.
+ * @param 	filter	The filter. Every event matches a filter without words.
+ * @param 	rows  	Set to the positions of the found events in the events vector, in the ascending
+ * 					order. The array belongs to the index and is valid until the next call.
+ *
+ * @returns	The number of the found events.
+ */
+
+int QueryEventPrefixIndex(EventPrefixIndex index, string filter, const int** rows);
+
+#endif // !_event_prefix_index_h
@@ -0,0 +1,105 @@
+/**
+ * @file	EventSaver.h.
+ *
+ * @brief	Declares the autosave worker interface.
+ *
+ * The saver writes the events and the categories data files on a background thread, so the user
+ * interface does not wait for the disk. The user interface thread hands the saver a snapshot of the
+ * events or the categories, and the worker writes it into a temporary file that replaces the data
+ * file at once, so the data file is never seen half written. The snapshots travel through a
+ * single-producer, single-consumer queue without locks. When several snapshots are waiting, the
+ * worker writes only the newest one of each kind.
+ *
+ * Every events snapshot carries the sequence number of the last journal record it contains (see
+ * EventJournal.h), which is stored in the data file, so the journal records are not applied twice
+ * after the data file has been replaced.
+ */
+
+#ifndef _event_saver_h
+#define _event_saver_h
+
+#include <stdint.h>
+#include "cslib.h"
+#include "vector.h"
+
+/** @brief	Defines an alias representing the autosave worker. */
+typedef struct EventSaverCDT* EventSaver;
+
+/**
+ * @fn	EventSaver NewEventSaver(string eventsFileName, string categoriesFileName);
+ *
+ * @brief	Starts the autosave worker.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	eventsFileName	  	Filename of the events data file.
+ * @param 	categoriesFileName	Filename of the categories data file.
+ *
+ * @returns	The new saver.
+ */
+
+EventSaver NewEventSaver(string eventsFileName, string categoriesFileName);
+
+/**
+ * @fn	void SaveEventsEventSaver(EventSaver saver, Vector events, uint32_t sequence);
+ *
+ * @brief	Takes a snapshot of the events and queues it for writing. The events are copied, so the
+ * 			caller can change them right away.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	saver   	The saver.
+ * @param 	events  	The events vector.
+ * @param 	sequence	The sequence number of the last journal record the events contain.
+ */
+
+void SaveEventsEventSaver(EventSaver saver, Vector events, uint32_t sequence);
+
+/**
+ * @fn	void SaveCategoriesEventSaver(EventSaver saver, Vector categories);
+ *
+ * @brief	Takes a snapshot of the categories and queues it for writing. The categories are copied,
+ * 			so the caller can change them right away.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	saver	  	The saver.
+ * @param 	categories	The categories vector.
+ */
+
+void SaveCategoriesEventSaver(EventSaver saver, Vector categories);
+
+/**
+ * @fn	uint32_t GetSavedSequenceEventSaver(EventSaver saver);
+ *
+ * @brief	Gets the sequence number of the newest events snapshot that is in the data file.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	saver	The saver.
+ *
+ * @returns	The sequence number, or zero if no events snapshot has been written yet.
+ */
+
+uint32_t GetSavedSequenceEventSaver(EventSaver saver);
+
+/**
+ * @fn	bool CloseEventSaver(EventSaver saver);
+ *
+ * @brief	Writes the queued snapshots, stops the worker and frees the saver.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	saver	The saver.
+ *
+ * @returns	True if every snapshot has been written, false if a data file could not be written.
+ */
+
+bool CloseEventSaver(EventSaver saver);
+
+#endif // !_event_saver_h
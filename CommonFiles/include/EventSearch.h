@@ -0,0 +1,117 @@
+/**
+ * @file	EventSearch.h.
+ *
+ * @brief	Declares the event search interface.
+ *
+ * The search index is an inverted index over the names, the descriptions and the locations of the
+ * events: every word points to the list of the events that hold it. The words are folded (see
+ * TextFold.h), so "Čačak", "cacak" and "CACAK" are the same word, and "đ" is the same as "dj".
+ *
+ * An event matches a query if it holds every word of the query. The hits are ranked by the sum of
+ * the weights of the query words in the event, where a word counts more in the name than in the
+ * location, and more in the location than in the description, and the rare words count more than
+ * the common ones.
+ *
+ * The index does not follow the events vector, it has to be told about every event that is added,
+ * changed or removed.
+ */
+
+#ifndef _event_search_h
+#define _event_search_h
+
+#include "cslib.h"
+#include "vector.h"
+#include "Event.h"
+
+/** @brief	Defines an alias representing the event search index. */
+typedef struct EventSearchCDT* EventSearch;
+
+/**
+ * @fn	EventSearch NewEventSearch(Vector events);
+ *
+ * @brief	Creates the search index of the events.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	events	The events vector.
+ *
+ * @returns	The new index.
+ */
+
+EventSearch NewEventSearch(Vector events);
+
+/**
+ * @fn	void FreeEventSearch(EventSearch search);
+ *
+ * @brief	Frees the index. The events are not freed.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	search	The index.
+ */
+
+void FreeEventSearch(EventSearch search);
+
+/**
+ * @fn	void InsertEventSearch(EventSearch search, Event event);
+ *
+ * @brief	Adds the words of the event to the index.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	search	The index.
+ * @param 	event 	The added event.
+ */
+
+void InsertEventSearch(EventSearch search, Event event);
+
+/**
+ * @fn	void DeleteEventSearch(EventSearch search, Event event);
+ *
+ * @brief	Removes the event from the index.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	search	The index.
+ * @param 	event 	The removed event, with the values it had when it was added.
+ */
+
+void DeleteEventSearch(EventSearch search, Event event);
+
+/**
+ * @fn	void UpdateEventSearch(EventSearch search, Event oldEvent, Event event);
+ *
+ * @brief	Replaces the words of the changed event in the index.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	search  	The index.
+ * @param 	oldEvent	A copy of the event values before the change.
+ * @param 	event   	The changed event.
+ */
+
+void UpdateEventSearch(EventSearch search, Event oldEvent, Event event);
+
+/**
+ * @fn	Vector QueryEventSearch(EventSearch search, string query);
+ *
+ * @brief	Finds the events that hold every word of the query.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	search	The index.
+ * @param 	query 	The query.
+ *
+ * @returns	A new vector of the found events, the best hit first. It is empty if the query has no
+ * 			words. The caller is responsible for freeing it, but not the events.
+ */
+
+Vector QueryEventSearch(EventSearch search, string query);
+
+#endif // !_event_search_h
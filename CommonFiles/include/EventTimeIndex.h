@@ -0,0 +1,138 @@
+/**
+ * @file	EventTimeIndex.h.
+ *
+ * @brief	Declares the event time index interface.
+ *
+ * The index holds the times of the events of a vector, sorted in the ascending order, together with
+ * the positions of the events in the vector. The events that fall into a time range are found with
+ * two binary searches for the range boundaries, and their positions are then handed out as a slice
+ * of the index, so no event outside of the range is looked at and nothing is copied. The index is
+ * rebuilt on the first query after the events vector has changed.
+ */
+
+#ifndef _event_time_index_h
+#define _event_time_index_h
+
+#include <time.h>
+#include "cslib.h"
+#include "vector.h"
+#include "Event.h"
+
+/** @brief	Defines an alias representing the event time index. */
+typedef struct EventTimeIndexCDT* EventTimeIndex;
+
+/**
+ * @fn	EventTimeIndex NewEventTimeIndex(Vector events);
+ *
+ * @brief	Creates the time index of the events. The vector is not copied, it has to outlive the
+ * 			index.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	events	The events vector.
+ *
+ * @returns	The new index.
+ */
+
+EventTimeIndex NewEventTimeIndex(Vector events);
+
+/**
+ * @fn	void FreeEventTimeIndex(EventTimeIndex index);
+ *
+ * @brief	Frees the index. The events are not freed.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	index	The index.
+ */
+
+void FreeEventTimeIndex(EventTimeIndex index);
+
+/**
+ * @fn	int SizeEventTimeIndex(EventTimeIndex index);
+ *
+ * @brief	Gets the number of the indexed events.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	index	The index.
+ *
+ * @returns	The number of events.
+ */
+
+int SizeEventTimeIndex(EventTimeIndex index);
+
+/**
+ * @fn	int LowerBoundEventTimeIndex(EventTimeIndex index, time_t time);
+ *
+ * @brief	Finds the position of the first event that is not earlier than the time.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	index	The index.
+ * @param 	time 	The time.
+ *
+ * @returns	The position, or the number of events if every event is earlier.
+ */
+
+int LowerBoundEventTimeIndex(EventTimeIndex index, time_t time);
+
+/**
+ * @fn	int UpperBoundEventTimeIndex(EventTimeIndex index, time_t time);
+ *
+ * @brief	Finds the position of the first event that is later than the time.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	index	The index.
+ * @param 	time 	The time.
+ *
+ * @returns	The position, or the number of events if no event is later.
+ */
+
+int UpperBoundEventTimeIndex(EventTimeIndex index, time_t time);
+
+/**
+ * @fn	int SliceEventTimeIndex(EventTimeIndex index, int begin, int end, const int** rows);
+ *
+ * @brief	Gets the events between the two positions of the index, in the ascending order of their
+ * 			times.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	index	The index.
+ * @param 	begin	The position of the first event.
+ * @param 	end  	The position after the last event.
+ * @param 	rows 	Set to the positions of the events in the events vector. The array belongs to the
+ * 					index and is valid until the vector changes.
+ *
+ * @returns	The number of the events.
+ */
+
+int SliceEventTimeIndex(EventTimeIndex index, int begin, int end, const int** rows);
+
+/**
+ * @fn	int GetDayEventTimeIndex(EventTimeIndex index, time_t time, const int** rows);
+ *
+ * @brief	Gets the events of the local calendar day the time belongs to.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	index	The index.
+ * @param 	time 	Any time during the day.
+ * @param 	rows 	Set to the positions of the events in the events vector. The array belongs to the
+ * 					index and is valid until the vector changes.
+ *
+ * @returns	The number of the events.
+ */
+
+int GetDayEventTimeIndex(EventTimeIndex index, time_t time, const int** rows);
+
+#endif // !_event_time_index_h
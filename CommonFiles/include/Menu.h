@@ -3,7 +3,7 @@
 
 #include "cslib.h"
 #include "vector.h"
-#include <Windows.h>
+#include "Console.h"
 
 #define MENU_CANCEL -1
 
@@ -11,6 +11,8 @@ typedef struct MenuCDT* Menu;
 
 Menu newMenu(void);
 
+void freeMenu(Menu menu);
+
 void addMenu(Menu m, string option);
 
 Vector getMenuOptions(Menu m);
@@ -0,0 +1,186 @@
+/**
+ * @file	Screen.h.
+ *
+ * @brief	Declares the off-screen console buffer interface.
+ *
+ * A frame is composed in memory as a grid of character cells, and then compared with the frame
+ * that is already shown. Only the cells that differ are sent to the console, with a single write
+ * per frame. Cells that are not drawn in a frame are left as they are on the console, so a frame
+ * can cover just a part of it.
+ */
+
+#ifndef _screen_h
+#define _screen_h
+
+#include "cslib.h"
+#include "Console.h"
+
+/** @brief	Defines an alias representing the off-screen console buffer. */
+typedef struct ScreenCDT* Screen;
+
+/**
+ * @fn	Screen NewScreen(void);
+ *
+ * @brief	Creates the buffer as big as the console.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @returns	The screen.
+ */
+
+Screen NewScreen(void);
+
+/**
+ * @fn	void FreeScreen(Screen screen);
+ *
+ * @brief	Frees the screen.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	screen	The screen.
+ */
+
+void FreeScreen(Screen screen);
+
+/**
+ * @fn	Screen GetScreen(void);
+ *
+ * @brief	Gets the screen of the standard output, which is shared by the tables and the menus. It
+ * 			is created on the first use.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @returns	The screen.
+ */
+
+Screen GetScreen(void);
+
+/**
+ * @fn	int GetWidthScreen(Screen screen);
+ *
+ * @brief	Gets the number of columns.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	screen	The screen.
+ *
+ * @returns	The width.
+ */
+
+int GetWidthScreen(Screen screen);
+
+/**
+ * @fn	int GetHeightScreen(Screen screen);
+ *
+ * @brief	Gets the number of lines.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	screen	The screen.
+ *
+ * @returns	The height.
+ */
+
+int GetHeightScreen(Screen screen);
+
+/**
+ * @fn	WORD GetAttributesScreen(Screen screen);
+ *
+ * @brief	Gets the text attributes the console had when the screen was last invalidated.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	screen	The screen.
+ *
+ * @returns	The attributes.
+ */
+
+WORD GetAttributesScreen(Screen screen);
+
+/**
+ * @fn	void InvalidateScreen(Screen screen);
+ *
+ * @brief	Forgets the shown frame. It has to be called whenever something else wrote to the
+ * 			console. The console contents are read back, so the next frame is compared with them.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	screen	The screen.
+ */
+
+void InvalidateScreen(Screen screen);
+
+/**
+ * @fn	void BeginScreen(Screen screen);
+ *
+ * @brief	Starts composing a new frame, in which no cell is drawn yet.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	screen	The screen.
+ */
+
+void BeginScreen(Screen screen);
+
+/**
+ * @fn	void FillScreen(Screen screen, int x, int y, int width, int height, WORD attributes);
+ *
+ * @brief	Draws blanks over the rectangle. The parts outside of the screen are ignored.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	screen	  	The screen.
+ * @param 	x		  	The left column.
+ * @param 	y		  	The top line.
+ * @param 	width	  	The width.
+ * @param 	height	  	The height.
+ * @param 	attributes	The text attributes.
+ */
+
+void FillScreen(Screen screen, int x, int y, int width, int height, WORD attributes);
+
+/**
+ * @fn	int WriteScreen(Screen screen, int x, int y, string text, WORD attributes);
+ *
+ * @brief	Draws the text in a single line. The text is cut at the end of the line.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	screen	  	The screen.
+ * @param 	x		  	The column of the first character.
+ * @param 	y		  	The line.
+ * @param 	text	  	The text.
+ * @param 	attributes	The text attributes.
+ *
+ * @returns	The number of drawn cells.
+ */
+
+int WriteScreen(Screen screen, int x, int y, string text, WORD attributes);
+
+/**
+ * @fn	int PresentScreen(Screen screen);
+ *
+ * @brief	Writes the cells of the frame that differ from the shown frame to the console. The
+ * 			cursor position is not changed.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	screen	The screen.
+ *
+ * @returns	1 on success, 0 otherwise.
+ */
+
+int PresentScreen(Screen screen);
+
+#endif // !_screen_h
@@ -0,0 +1,80 @@
+/**
+ * @file	SharedString.h.
+ *
+ * @brief	Declares the shared string interface.
+ *
+ * A shared string is an immutable copy of a string with a reference count. Whoever keeps the string
+ * holds a reference to it, taken by NewSharedString, NewSharedStringOfLength or RetainSharedString
+ * and given back by ReleaseSharedString, and the string is freed when the last reference is given back. The
+ * references may be taken and given back from different threads.
+ *
+ * The shared string is an ordinary string for reading, so it can be passed to the strlib functions,
+ * but it must never be changed or freed with freeBlock.
+ */
+
+#ifndef _shared_string_h
+#define _shared_string_h
+
+#include "cslib.h"
+
+/**
+ * @fn	string NewSharedString(const string text);
+ *
+ * @brief	Creates a shared string with the copy of the text.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	text	The text to copy.
+ *
+ * @returns	The shared string, with a single reference held by the caller.
+ */
+
+string NewSharedString(const string text);
+
+/**
+ * @fn	string NewSharedStringOfLength(size_t length);
+ *
+ * @brief	Creates a shared string with room for the given number of characters, for the caller to
+ * 			fill in before the string is shared with anyone.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	length	The number of characters, without the terminating null character.
+ *
+ * @returns	The shared string, terminated after the length, with a single reference held by the
+ * 			caller.
+ */
+
+string NewSharedStringOfLength(size_t length);
+
+/**
+ * @fn	string RetainSharedString(string shared);
+ *
+ * @brief	Takes another reference to the shared string.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	shared	The shared string.
+ *
+ * @returns	The same shared string.
+ */
+
+string RetainSharedString(string shared);
+
+/**
+ * @fn	void ReleaseSharedString(string shared);
+ *
+ * @brief	Gives back a reference to the shared string, and frees it if it was the last one.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	shared	The shared string.
+ */
+
+void ReleaseSharedString(string shared);
+
+#endif // !_shared_string_h
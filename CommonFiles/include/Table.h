@@ -2,11 +2,16 @@
 #define _table_h
 
 #include "vector.h"
-#include <Windows.h>
+#include "arena.h"
+#include "Console.h"
 
 typedef struct TableCDT* Table;
 
-typedef Vector(*ToStringVector)(void*);
+typedef struct TableViewCDT* TableView;
+
+#define MAX_SORT_KEYS 4
+
+typedef Vector(*ToStringVector)(void*, Arena);
 
 typedef void (*FreeStringVector)(Vector);
 
@@ -64,8 +69,46 @@ CompareFn GetCompareFnTable(Table t);
 
 void SetCompareFnTable(Table t, CompareFn cmpFn);
 
+void PushSortKeyTable(Table t, CompareFn cmpFn, SortDirection direction);
+
+void ClearSortKeysTable(Table t);
+
+void InvalidateSortTable(Table t);
+
+int InsertSortedTable(Table t, void* record);
+
+void RemoveRecordTable(Table t, int index);
+
 Table CloneTable(Table table);
 
+void SortTable(Table table);
+
 int MainTable(Table table, int* selection, WORD* keyCode);
 
+TableView NewTableView(Table table);
+
+void FreeTableView(TableView view);
+
+Table GetTableTableView(TableView view);
+
+bool IsWholeTableView(TableView view);
+
+void SetRowsTableView(TableView view, const int* rows, int count);
+
+void SetRecordsTableView(TableView view, Vector records);
+
+int GetTotalTableView(TableView view);
+
+int GetRowTableView(TableView view, int index);
+
+void SetFooterTableView(TableView view, Vector footer);
+
+void PushSortKeyTableView(TableView view, CompareFn cmpFn, SortDirection direction);
+
+void ClearSortKeysTableView(TableView view);
+
+void SortTableView(TableView view);
+
+int MainTableView(TableView view, int* selection, WORD* keyCode);
+
 #endif // !_table_h
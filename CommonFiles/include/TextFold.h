@@ -0,0 +1,69 @@
+/**
+ * @file	TextFold.h.
+ *
+ * @brief	Declares the text folding interface.
+ *
+ * The text is folded for the comparisons that ignore the case and the diacritics: the letters are
+ * turned into the lower case, "č", "ć", "š" and "ž" lose their diacritics, and "đ" becomes "dj".
+ * The text is in the Windows-1250 code page. The letters and the digits are the only characters
+ * that belong to the words.
+ */
+
+#ifndef _text_fold_h
+#define _text_fold_h
+
+#include "cslib.h"
+#include "strbuf.h"
+
+/** @brief	Defines an alias representing the function that is called for every folded word. */
+typedef void (*FoldedWordFn)(string word, void* data);
+
+/**
+ * @fn	bool IsFoldedChar(char ch);
+ *
+ * @brief	Checks whether the character belongs to the words, that is, whether it is a letter or a
+ * 			digit.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	ch	The character.
+ *
+ * @returns	True if it belongs to the words, false otherwise.
+ */
+
+bool IsFoldedChar(char ch);
+
+/**
+ * @fn	bool AppendFoldedChar(StringBuffer sb, char ch);
+ *
+ * @brief	Appends the folded character to the buffer, if it is a letter or a digit.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	sb	The buffer.
+ * @param 	ch	The character.
+ *
+ * @returns	True if the character was appended, false if it does not belong to the words.
+ */
+
+bool AppendFoldedChar(StringBuffer sb, char ch);
+
+/**
+ * @fn	void ForEachFoldedWord(StringBuffer sb, string text, FoldedWordFn fn, void* data);
+ *
+ * @brief	Calls the function for every folded word of the text.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	sb  	The buffer that holds the words. It is cleared first.
+ * @param 	text	The text, or NULL.
+ * @param 	fn  	The function. The word is valid only during the call.
+ * @param 	data	The last argument of the function.
+ */
+
+void ForEachFoldedWord(StringBuffer sb, string text, FoldedWordFn fn, void* data);
+
+#endif // !_text_fold_h
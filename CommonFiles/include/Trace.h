@@ -0,0 +1,132 @@
+/**
+ * @file	Trace.h.
+ *
+ * @brief	Declares the tracing interface.
+ *
+ * A span measures how long a piece of code takes: it is begun before the code and ended after it,
+ * and the ended spans are kept in a ring buffer of the thread that ran them, so the threads never
+ * wait for each other and only the newest spans are kept. The spans are written as the Chrome trace
+ * events (chrome://tracing or https://ui.perfetto.dev) when the application exits, or when F12 is
+ * pressed.
+ *
+ * The tracing is turned on by the SUDOGU_TRACE environment variable, which holds the name of the
+ * trace file. When it is off, a span costs a single test. Defining SUDOGU_NO_TRACE removes the spans
+ * from the build altogether.
+ */
+
+#ifndef _trace_h
+#define _trace_h
+
+#include <stdint.h>
+#include "cslib.h"
+#include "Console.h"
+
+/**
+ * @struct	TraceSpan
+ *
+ * @brief	A begun span.
+ */
+
+typedef struct {
+	/** @brief	The name of the span, a string literal, or NULL if the tracing is off. */
+	string name;
+	/** @brief	The time the span was begun. */
+	uint64_t start;
+} TraceSpan;
+
+#ifdef SUDOGU_NO_TRACE
+
+#define InitTrace() ((void) 0)
+#define NameTraceThread(name) ((void) 0)
+#define BeginTraceSpan(name) ((TraceSpan) { NULL, 0 })
+#define EndTraceSpan(span) ((void) (span))
+#define HandleTraceKey(key) false
+#define DumpTrace() false
+
+#else
+
+/**
+ * @fn	void InitTrace(void);
+ *
+ * @brief	Turns the tracing on if the SUDOGU_TRACE environment variable is set. The trace is then
+ * 			written when the application exits.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ */
+
+void InitTrace(void);
+
+/**
+ * @fn	void NameTraceThread(string name);
+ *
+ * @brief	Names the calling thread in the trace.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	name	The name of the thread, a string literal.
+ */
+
+void NameTraceThread(string name);
+
+/**
+ * @fn	TraceSpan BeginTraceSpan(string name);
+ *
+ * @brief	Begins the span.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	name	The name of the span, a string literal.
+ *
+ * @returns	The span, to be passed to EndTraceSpan.
+ */
+
+TraceSpan BeginTraceSpan(string name);
+
+/**
+ * @fn	void EndTraceSpan(TraceSpan span);
+ *
+ * @brief	Ends the span and records it.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	span	The span returned by BeginTraceSpan.
+ */
+
+void EndTraceSpan(TraceSpan span);
+
+/**
+ * @fn	bool HandleTraceKey(WORD key);
+ *
+ * @brief	Writes the trace if the key is the trace key (F12) and the tracing is on.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	key	The virtual key code.
+ *
+ * @returns	True if the key has been handled, false if it belongs to the application.
+ */
+
+bool HandleTraceKey(WORD key);
+
+/**
+ * @fn	bool DumpTrace(void);
+ *
+ * @brief	Writes the recorded spans of all threads into the trace file.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @returns	True if the trace has been written, false if the tracing is off or the file can not be
+ * 			written.
+ */
+
+bool DumpTrace(void);
+
+#endif
+
+#endif // !_trace_h
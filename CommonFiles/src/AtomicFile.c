@@ -0,0 +1,112 @@
+/**
+ * @file	AtomicFile.c.
+ *
+ * @brief	Atomic file replacement implementation.
+ *
+ * On Windows the data file is replaced by ReplaceFile, which moves it to the backup name in the
+ * same step. Elsewhere the backup is made as a hard link to the data file, so the data file keeps
+ * its name until the rename takes it over, and the directory is synced afterwards, so the rename
+ * itself survives a crash.
+ */
+
+#include "AtomicFile.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+#include "cslib.h"
+#include "strlib.h"
+#include "utilities.h"
+#include "platform.h"
+
+/** @brief	The suffix of the temporary file name. */
+#define TEMP_SUFFIX ".tmp"
+
+/** @brief	The suffix of the backup file name. */
+#define BACKUP_SUFFIX ".bak"
+
+static bool ReplaceWithTemp(string tempName, string fileName, string backupName);
+#ifndef _WIN32
+static void SyncDirectory(string fileName);
+#endif
+
+FILE* OpenAtomicFile(string fileName) {
+	string tempName = concat(fileName, TEMP_SUFFIX);
+	FILE* filepoint;
+	errno_t err = fopen_s(&filepoint, tempName, "wb");
+	freeBlock(tempName);
+	return (err == 0) ? filepoint : NULL;
+}
+
+bool CommitAtomicFile(FILE* filepoint, string fileName) {
+	string tempName = concat(fileName, TEMP_SUFFIX);
+	string backupName = GetBackupNameAtomicFile(fileName);
+
+	// The contents have to be on the disk before the rename, or a crash could leave the data file
+	// name pointing to a file that was never written.
+	bool written = fflush(filepoint) == 0 && !ferror(filepoint) && _commit(_fileno(filepoint)) == 0;
+	written = (fclose(filepoint) == 0) && written;
+
+	bool replaced = written && ReplaceWithTemp(tempName, fileName, backupName);
+	if (!replaced) {
+		remove(tempName);
+	}
+	freeBlock(tempName);
+	freeBlock(backupName);
+	return replaced;
+}
+
+string GetBackupNameAtomicFile(string fileName) {
+	return concat(fileName, BACKUP_SUFFIX);
+}
+
+// Private functions
+
+#ifdef _WIN32
+
+static bool ReplaceWithTemp(string tempName, string fileName, string backupName) {
+	if (fileExists(fileName)) {
+		return ReplaceFileA(fileName, tempName, backupName, REPLACEFILE_IGNORE_MERGE_ERRORS, NULL, NULL) != 0;
+	}
+	return MoveFileExA(tempName, fileName, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+#else
+
+static bool ReplaceWithTemp(string tempName, string fileName, string backupName) {
+	if (fileExists(fileName)) {
+		// Without the hard links the data file is replaced without the backup.
+		remove(backupName);
+		link(fileName, backupName);
+	}
+	if (rename(tempName, fileName) != 0) {
+		return false;
+	}
+	SyncDirectory(fileName);
+	return true;
+}
+
+static void SyncDirectory(string fileName) {
+	char* slash = strrchr(fileName, '/');
+	string directory;
+	if (slash == NULL) {
+		directory = copyString(".");
+	}
+	else {
+		directory = (slash == fileName) ? copyString("/") : substring(fileName, 0, (int) (slash - fileName) - 1);
+	}
+
+	// Not every file system can sync a directory, and there is nothing to do about it then.
+	int fd = open(directory, O_RDONLY);
+	if (fd >= 0) {
+		fsync(fd);
+		close(fd);
+	}
+	freeBlock(directory);
+}
+
+#endif
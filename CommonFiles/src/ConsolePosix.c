@@ -0,0 +1,642 @@
+/**
+ * @file	ConsolePosix.c.
+ *
+ * @brief	Terminal implementation for the POSIX terminals.
+ *
+ * The terminal is kept in the raw mode while the application runs, so the pressed keys are not
+ * echoed over the drawn screen. A copy of the shown cells is kept, because a terminal cannot be
+ * read back; the cells that are written again with the same contents are not sent to it. All the
+ * output of a call is collected and sent with a single write.
+ */
+
+#include "Console.h"
+
+#ifndef _WIN32
+
+#include <ctype.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#include "strbuf.h"
+#include "strlib.h"
+#include "Trace.h"
+
+// How long to wait for the rest of an escape sequence, in milliseconds.
+#define ESCAPE_TIMEOUT 50
+
+/** @brief	True while the terminal is prepared for the application. */
+static bool opened = false;
+
+/** @brief	The terminal mode before OpenConsole. */
+static struct termios oldMode;
+
+/** @brief	The terminal mode in which the keys are read. */
+static struct termios rawMode;
+
+/** @brief	The number of columns. */
+static int width = 0;
+
+/** @brief	The number of lines. */
+static int height = 0;
+
+/** @brief	The shown cells, line by line. */
+static ConsoleCell* cells = NULL;
+
+/** @brief	The cursor position. */
+static COORD cursor = { 0, 0 };
+
+/** @brief	The attributes of the written text. */
+static WORD attributes = FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE;
+
+/** @brief	The attributes last sent to the terminal, or -1 if not known. */
+static int terminalAttributes = -1;
+
+/** @brief	True if the cursor is shown. */
+static bool cursorVisible = true;
+
+/** @brief	The key code that ReadCharConsole reports on the next call, or 0. */
+static int pendingKey = 0;
+
+/** @brief	The character of the last key read by ReadKeyConsole, 0 if it has none. */
+static char keyChar = 0;
+
+/** @brief	The output collected for the next write. */
+static StringBuffer output = NULL;
+
+/** @brief	The Unicode code points of the Windows-1250 characters 0x80 - 0xFF. */
+static const unsigned short cp1250[128] = {
+	0x20AC, 0x003F, 0x201A, 0x003F, 0x201E, 0x2026, 0x2020, 0x2021,
+	0x003F, 0x2030, 0x0160, 0x2039, 0x015A, 0x0164, 0x017D, 0x0179,
+	0x003F, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+	0x003F, 0x2122, 0x0161, 0x203A, 0x015B, 0x0165, 0x017E, 0x017A,
+	0x00A0, 0x02C7, 0x02D8, 0x0141, 0x00A4, 0x0104, 0x00A6, 0x00A7,
+	0x00A8, 0x00A9, 0x015E, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x017B,
+	0x00B0, 0x00B1, 0x02DB, 0x0142, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+	0x00B8, 0x0105, 0x015F, 0x00BB, 0x013D, 0x02DD, 0x013E, 0x017C,
+	0x0154, 0x00C1, 0x00C2, 0x0102, 0x00C4, 0x0139, 0x0106, 0x00C7,
+	0x010C, 0x00C9, 0x0118, 0x00CB, 0x011A, 0x00CD, 0x00CE, 0x010E,
+	0x0110, 0x0143, 0x0147, 0x00D3, 0x00D4, 0x0150, 0x00D6, 0x00D7,
+	0x0158, 0x016E, 0x00DA, 0x0170, 0x00DC, 0x00DD, 0x0162, 0x00DF,
+	0x0155, 0x00E1, 0x00E2, 0x0103, 0x00E4, 0x013A, 0x0107, 0x00E7,
+	0x010D, 0x00E9, 0x0119, 0x00EB, 0x011B, 0x00ED, 0x00EE, 0x010F,
+	0x0111, 0x0144, 0x0148, 0x00F3, 0x00F4, 0x0151, 0x00F6, 0x00F7,
+	0x0159, 0x016F, 0x00FA, 0x0171, 0x00FC, 0x00FD, 0x0163, 0x02D9,
+};
+
+static void PutCell(int x, int y, char character, WORD cellAttributes);
+static void NewLine(bool emit);
+static void PutText(const char* text, int length, bool emit);
+static void EmitCursor(void);
+static void EmitAttributes(WORD cellAttributes);
+static void EmitChar(char character);
+static int AnsiColor(WORD color);
+static bool Flush(void);
+static int ReadByte(int timeout);
+static int ReadUtf8(int lead);
+static WORD ReadEscape(void);
+static WORD TildeKey(int parameter);
+static WORD CharKey(int ch);
+
+bool OpenConsole(int columns, int lines) {
+	if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO) || tcgetattr(STDIN_FILENO, &oldMode) != 0) {
+		return false;
+	}
+
+	// The screen is the requested size, as far as it fits into the terminal.
+	struct winsize ws;
+	if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0 && ws.ws_row > 0) {
+		width = (columns < ws.ws_col) ? columns : ws.ws_col;
+		height = (lines < ws.ws_row) ? lines : ws.ws_row;
+	} else {
+		width = columns;
+		height = lines;
+	}
+
+	// The keys are read one by one, without the echo. Ctrl+C still stops the application.
+	rawMode = oldMode;
+	rawMode.c_lflag &= ~(ICANON | ECHO);
+	rawMode.c_iflag &= ~(IXON | ICRNL);
+	rawMode.c_cc[VMIN] = 1;
+	rawMode.c_cc[VTIME] = 0;
+	if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &rawMode) != 0) {
+		return false;
+	}
+
+	cells = newArray(width * height, ConsoleCell);
+	output = newStringBuffer();
+	opened = true;
+	atexit(CloseConsole);
+
+	// The screen scrolls inside the used lines only, like the Windows console buffer.
+	sbprintf(output, "\x1b[1;%dr", height);
+	ClearConsole();
+	return true;
+}
+
+void CloseConsole(void) {
+	if (!opened) {
+		return;
+	}
+	opened = false;
+
+	// Reset the scrolling, the colors and the cursor, and leave the cursor under the screen.
+	sbprintf(output, "\x1b[r\x1b[0m\x1b[?25h\x1b[%d;1H\n", height);
+	Flush();
+	tcsetattr(STDIN_FILENO, TCSAFLUSH, &oldMode);
+
+	freeBlock(cells);
+	freeStringBuffer(output);
+	cells = NULL;
+	output = NULL;
+}
+
+COORD GetSizeConsole(void) {
+	COORD size = { (short) width, (short) height };
+	return size;
+}
+
+COORD GetCursorConsole(void) {
+	return cursor;
+}
+
+void SetCursorConsole(COORD position) {
+	cursor = position;
+	EmitCursor();
+	Flush();
+}
+
+bool IsCursorVisibleConsole(void) {
+	return cursorVisible;
+}
+
+void ShowCursorConsole(bool visible) {
+	cursorVisible = visible;
+	appendString(output, visible ? "\x1b[?25h" : "\x1b[?25l");
+	Flush();
+}
+
+WORD GetAttributesConsole(void) {
+	return attributes;
+}
+
+void SetAttributesConsole(WORD textAttributes) {
+	attributes = textAttributes;
+}
+
+int WriteTextConsole(const char* text, int length) {
+	PutText(text, length, true);
+	return Flush() ? length : -1;
+}
+
+void FillConsole(COORD position, int count, char character, WORD fillAttributes) {
+	int start = position.Y * width + position.X;
+	int end = start + count;
+	if (end > width * height) {
+		end = width * height;
+	}
+
+	bool moved = false;
+	for (int i = start; i < end; i++) {
+		if (cells[i].character == character && cells[i].attributes == fillAttributes) {
+			moved = true;
+			continue;
+		}
+		if (moved || i == start || i % width == 0) {
+			sbprintf(output, "\x1b[%d;%dH", i / width + 1, i % width + 1);
+			moved = false;
+		}
+		PutCell(i % width, i / width, character, fillAttributes);
+	}
+	EmitCursor();
+	Flush();
+}
+
+void ClearConsole(void) {
+	for (int i = 0; i < width * height; i++) {
+		cells[i].character = ' ';
+		cells[i].attributes = attributes;
+	}
+	cursor.X = cursor.Y = 0;
+
+	// The erased cells take the background of the current attributes.
+	EmitAttributes(attributes);
+	appendString(output, "\x1b[H\x1b[2J");
+	Flush();
+}
+
+bool ReadCellsConsole(ConsoleCell* buffer, COORD position, COORD size) {
+	if (position.X < 0 || position.Y < 0 || position.X + size.X > width || position.Y + size.Y > height) {
+		return false;
+	}
+	for (int row = 0; row < size.Y; row++) {
+		memcpy(&buffer[row * size.X], &cells[(position.Y + row) * width + position.X], size.X * sizeof(ConsoleCell));
+	}
+	return true;
+}
+
+bool WriteCellsConsole(const ConsoleCell* buffer, COORD position, COORD size) {
+	if (position.X < 0 || position.Y < 0 || position.X + size.X > width || position.Y + size.Y > height) {
+		return false;
+	}
+
+	for (int row = 0; row < size.Y; row++) {
+		// Runs of changed cells are written without moving the cursor.
+		bool moved = true;
+		for (int column = 0; column < size.X; column++) {
+			const ConsoleCell* cell = &buffer[row * size.X + column];
+			int x = position.X + column;
+			int y = position.Y + row;
+			ConsoleCell* shown = &cells[y * width + x];
+			if (shown->character == cell->character && shown->attributes == cell->attributes) {
+				moved = true;
+				continue;
+			}
+			if (moved) {
+				sbprintf(output, "\x1b[%d;%dH", y + 1, x + 1);
+				moved = false;
+			}
+			PutCell(x, y, cell->character, cell->attributes);
+		}
+	}
+	EmitCursor();
+	return Flush();
+}
+
+WORD ReadKeyConsole(void) {
+	keyChar = 0;
+	for (;;) {
+		int ch = ReadByte(-1);
+		if (ch < 0) {
+			return 0;
+		}
+
+		switch (ch) {
+		case 0x1b:
+		{
+			WORD key = ReadEscape();
+			// The trace key is taken here, so it works on every screen.
+			if (key != 0 && !HandleTraceKey(key)) {
+				return key;
+			}
+			break;
+		}
+		case '\r':
+		case '\n':
+			return VK_RETURN;
+		case 0x7f:
+		case '\b':
+			return VK_BACK;
+		default:
+			if (ch >= 0x80) {
+				keyChar = (char) ReadUtf8(ch);
+				return VK_PACKET;
+			}
+			keyChar = (char) ch;
+			return CharKey(ch);
+		}
+	}
+}
+
+char GetKeyCharConsole(void) {
+	return keyChar;
+}
+
+int ReadCharConsole(void) {
+	if (pendingKey != 0) {
+		int key = pendingKey;
+		pendingKey = 0;
+		return key;
+	}
+
+	for (;;) {
+		int ch = ReadByte(-1);
+		if (ch < 0) {
+			return '\r';
+		}
+
+		switch (ch) {
+		case 0x1b:
+		{
+			WORD key = ReadEscape();
+			if (key == VK_ESCAPE) {
+				return 0x1b;
+			}
+			if (key != 0) {
+				pendingKey = key;
+				return 0;
+			}
+			break;
+		}
+		case '\n':
+			return '\r';
+		case 0x7f:
+			return '\b';
+		default:
+			return (ch >= 0x80) ? ReadUtf8(ch) : ch;
+		}
+	}
+}
+
+string ReadLineConsole(void) {
+	// The line is typed with the line editing and the echo of the terminal.
+	EmitAttributes(attributes);
+	Flush();
+	tcsetattr(STDIN_FILENO, TCSANOW, &oldMode);
+
+	StringBuffer sb = newStringBuffer();
+	bool end = true;
+	unsigned char ch;
+	while (read(STDIN_FILENO, &ch, 1) == 1) {
+		end = false;
+		if (ch == '\n') {
+			break;
+		}
+		if (ch == '\r') {
+			continue;
+		}
+		// The UTF-8 sequences are converted to Windows-1250.
+		pushChar(sb, (char) ((ch < 0x80) ? ch : ReadUtf8(ch)));
+	}
+	tcsetattr(STDIN_FILENO, TCSANOW, &rawMode);
+
+	string line = NULL;
+	if (!end) {
+		line = copyString(getString(sb));
+
+		// The terminal has shown the line already.
+		PutText(line, (int) strlen(line), false);
+		NewLine(false);
+	}
+	freeStringBuffer(sb);
+	return line;
+}
+
+// Private functions
+
+static void PutCell(int x, int y, char character, WORD cellAttributes) {
+	EmitAttributes(cellAttributes);
+	EmitChar(character);
+	cells[y * width + x].character = character;
+	cells[y * width + x].attributes = cellAttributes;
+}
+
+static void NewLine(bool emit) {
+	cursor.X = 0;
+	if (cursor.Y < height - 1) {
+		cursor.Y++;
+	} else {
+		// Scroll up, the new line takes the current attributes.
+		memmove(cells, cells + width, (height - 1) * width * sizeof(ConsoleCell));
+		for (int x = 0; x < width; x++) {
+			cells[(height - 1) * width + x].character = ' ';
+			cells[(height - 1) * width + x].attributes = attributes;
+		}
+		if (emit) {
+			EmitAttributes(attributes);
+		}
+	}
+	if (emit) {
+		appendString(output, "\r\n");
+	}
+}
+
+static void PutText(const char* text, int length, bool emit) {
+	for (int i = 0; i < length; i++) {
+		char character = text[i];
+		switch (character) {
+		case '\n':
+			NewLine(emit);
+			break;
+		case '\r':
+			cursor.X = 0;
+			if (emit) {
+				pushChar(output, '\r');
+			}
+			break;
+		case '\b':
+			if (cursor.X > 0) {
+				cursor.X--;
+				if (emit) {
+					pushChar(output, '\b');
+				}
+			}
+			break;
+		case '\t':
+			// Blanks up to the next tab stop.
+			do {
+				PutText(" ", 1, emit);
+			} while (cursor.X % 8 != 0);
+			break;
+		default:
+			if ((unsigned char) character < ' ') {
+				break;
+			}
+			if (emit) {
+				PutCell(cursor.X, cursor.Y, character, attributes);
+			} else {
+				cells[cursor.Y * width + cursor.X].character = character;
+				cells[cursor.Y * width + cursor.X].attributes = attributes;
+			}
+			// The line wraps here, whatever the width of the terminal is.
+			if (++cursor.X == width) {
+				NewLine(emit);
+			}
+			break;
+		}
+	}
+}
+
+static void EmitCursor(void) {
+	sbprintf(output, "\x1b[%d;%dH", cursor.Y + 1, cursor.X + 1);
+}
+
+static void EmitAttributes(WORD cellAttributes) {
+	if (cellAttributes == terminalAttributes) {
+		return;
+	}
+	sbprintf(output, "\x1b[0;%d;%dm",
+		((cellAttributes & FOREGROUND_INTENSITY) ? 90 : 30) + AnsiColor(cellAttributes),
+		((cellAttributes & BACKGROUND_INTENSITY) ? 100 : 40) + AnsiColor(cellAttributes >> 4));
+	terminalAttributes = cellAttributes;
+}
+
+static void EmitChar(char character) {
+	unsigned char ch = (unsigned char) character;
+	if (ch < 0x80) {
+		pushChar(output, ch);
+		return;
+	}
+
+	unsigned codePoint = cp1250[ch - 0x80];
+	if (codePoint < 0x800) {
+		pushChar(output, (char) (0xC0 | (codePoint >> 6)));
+	} else {
+		pushChar(output, (char) (0xE0 | (codePoint >> 12)));
+		pushChar(output, (char) (0x80 | ((codePoint >> 6) & 0x3F)));
+	}
+	pushChar(output, (char) (0x80 | (codePoint & 0x3F)));
+}
+
+static int AnsiColor(WORD color) {
+	// The console has blue in the lowest bit, while ANSI has red there.
+	return ((color & FOREGROUND_RED) ? 1 : 0)
+		| ((color & FOREGROUND_GREEN) ? 2 : 0)
+		| ((color & FOREGROUND_BLUE) ? 4 : 0);
+}
+
+static bool Flush(void) {
+	const char* data = getString(output);
+	int length = sizeStringBuffer(output);
+	while (length > 0) {
+		ssize_t written = write(STDOUT_FILENO, data, length);
+		if (written <= 0) {
+			clearStringBuffer(output);
+			return false;
+		}
+		data += written;
+		length -= (int) written;
+	}
+	clearStringBuffer(output);
+	return true;
+}
+
+static int ReadByte(int timeout) {
+	struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+	if (timeout >= 0 && poll(&pfd, 1, timeout) <= 0) {
+		return -1;
+	}
+	unsigned char ch;
+	return (read(STDIN_FILENO, &ch, 1) == 1) ? ch : -1;
+}
+
+static int ReadUtf8(int lead) {
+	int count = (lead >= 0xF0) ? 3 : (lead >= 0xE0) ? 2 : (lead >= 0xC0) ? 1 : 0;
+	unsigned codePoint = lead & (0x3F >> count);
+	while (count-- > 0) {
+		int ch = ReadByte(ESCAPE_TIMEOUT);
+		if (ch < 0) {
+			break;
+		}
+		codePoint = (codePoint << 6) | (ch & 0x3F);
+	}
+	for (int i = 0; i < 128; i++) {
+		if (cp1250[i] == codePoint && codePoint != '?') {
+			return 0x80 + i;
+		}
+	}
+	return '?';
+}
+
+static WORD ReadEscape(void) {
+	// A lone escape is the Esc key itself.
+	int ch = ReadByte(ESCAPE_TIMEOUT);
+	if (ch < 0) {
+		return VK_ESCAPE;
+	}
+	if (ch != '[' && ch != 'O') {
+		return 0;
+	}
+
+	// The parameters come before the final character of the sequence.
+	int parameter = 0;
+	int final;
+	bool first = true;
+	while ((final = ReadByte(ESCAPE_TIMEOUT)) >= 0 && final < 0x40) {
+		if (final == ';') {
+			first = false;
+		} else if (first && isdigit(final)) {
+			parameter = parameter * 10 + (final - '0');
+		}
+	}
+
+	switch (final) {
+	case 'A': return VK_UP;
+	case 'B': return VK_DOWN;
+	case 'C': return VK_RIGHT;
+	case 'D': return VK_LEFT;
+	case 'H': return VK_HOME;
+	case 'F': return VK_END;
+	case 'P': return VK_F1;
+	case 'Q': return VK_F2;
+	case 'R': return VK_F3;
+	case 'S': return VK_F4;
+	case '~': return TildeKey(parameter);
+	default: return 0;
+	}
+}
+
+static WORD TildeKey(int parameter) {
+	switch (parameter) {
+	case 1: case 7: return VK_HOME;
+	case 2: return VK_INSERT;
+	case 3: return VK_DELETE;
+	case 4: case 8: return VK_END;
+	case 5: return VK_PRIOR;
+	case 6: return VK_NEXT;
+	case 11: return VK_F1;
+	case 12: return VK_F2;
+	case 13: return VK_F3;
+	case 14: return VK_F4;
+	case 15: return VK_F5;
+	case 17: return VK_F6;
+	case 18: return VK_F7;
+	case 19: return VK_F8;
+	case 20: return VK_F9;
+	case 21: return VK_F10;
+	case 23: return VK_F11;
+	case 24: return VK_F12;
+	default: return 0;
+	}
+}
+
+static WORD CharKey(int ch) {
+	// The key codes are those the Windows console reports for the US layout, so the characters
+	// never take the codes of the arrows and the other special keys.
+	static const char shiftedDigits[] = ")!@#$%^&*(";
+	static const struct {
+		char plain;
+		char shifted;
+		WORD key;
+	} oemKeys[] = {
+		{ ';', ':', VK_OEM_1 },
+		{ '=', '+', VK_OEM_PLUS },
+		{ ',', '<', VK_OEM_COMMA },
+		{ '-', '_', VK_OEM_MINUS },
+		{ '.', '>', VK_OEM_PERIOD },
+		{ '/', '?', VK_OEM_2 },
+		{ '`', '~', VK_OEM_3 },
+		{ '[', '{', VK_OEM_4 },
+		{ '\\', '|', VK_OEM_5 },
+		{ ']', '}', VK_OEM_6 },
+		{ '\'', '"', VK_OEM_7 }
+	};
+
+	if (ch < ' ') {
+		return (WORD) ch;
+	}
+	if (ch == ' ') {
+		return VK_SPACE;
+	}
+	if (isdigit(ch) || isupper(ch)) {
+		return (WORD) ch;
+	}
+	if (islower(ch)) {
+		return (WORD) toupper(ch);
+	}
+	for (int i = 0; i < 10; i++) {
+		if (shiftedDigits[i] == ch) {
+			return (WORD) ('0' + i);
+		}
+	}
+	for (size_t i = 0; i < sizeof oemKeys / sizeof oemKeys[0]; i++) {
+		if (oemKeys[i].plain == ch || oemKeys[i].shifted == ch) {
+			return oemKeys[i].key;
+		}
+	}
+	return VK_PACKET;
+}
+
+#endif
@@ -0,0 +1,313 @@
+/**
+ * @file	ConsoleWin32.c.
+ *
+ * @brief	Terminal implementation for the Windows console.
+ */
+
+#include "Console.h"
+
+#ifdef _WIN32
+
+#include <Windows.h>
+#include <conio.h>
+#include "cslib.h"
+#include "simpio.h"
+#include "Trace.h"
+
+/** @brief	Handle to the stdout. */
+static HANDLE hStdout = NULL;
+
+/** @brief	Handle to the stdin. */
+static HANDLE hStdin = NULL;
+
+/** @brief	The console input mode before OpenConsole. */
+static DWORD fdwSaveOldMode;
+
+/** @brief	The text attributes before OpenConsole. */
+static WORD wOldColorAttrs;
+
+/** @brief	The cursor before OpenConsole. */
+static CONSOLE_CURSOR_INFO oldCursorInfo;
+
+/** @brief	The character of the last key read by ReadKeyConsole, 0 if it has none. */
+static char keyChar = 0;
+
+/** @brief	Buffer for reading and writing the cells. */
+static CHAR_INFO* chiBuffer = NULL;
+
+/** @brief	Number of cells the buffer can hold. */
+static int chiBufferSize = 0;
+
+static bool SetWindowSize(int x, int y);
+static CHAR_INFO* GetCellBuffer(int count);
+
+bool OpenConsole(int width, int height) {
+	// Set codepage. Needed for Serbian Latin chars.
+	// Also added additional options in project property pages:
+	// /source-charset:windows-1250 /execution-charset:windows-1250
+	//
+	if (!SetConsoleCP(1250) || !SetConsoleOutputCP(1250)) {
+		return false;
+	}
+
+	// Get handles to STDIN and STDOUT.
+	//
+	hStdin = GetStdHandle(STD_INPUT_HANDLE);
+	hStdout = GetStdHandle(STD_OUTPUT_HANDLE);
+	if (hStdin == INVALID_HANDLE_VALUE || hStdout == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	// Disable window resizing and maximizing.
+	//
+	HWND consoleWindow = GetConsoleWindow();
+	SetWindowLong(consoleWindow, GWL_STYLE, GetWindowLong(consoleWindow, GWL_STYLE) & ~WS_MAXIMIZEBOX & ~WS_SIZEBOX);
+	if (!SetWindowSize(width, height)) {
+		return false;
+	}
+
+	// Save the current input mode, the text colors and the cursor, to be restored on exit.
+	//
+	CONSOLE_SCREEN_BUFFER_INFO csbiInfo;
+	if (!GetConsoleMode(hStdin, &fdwSaveOldMode)
+		|| !GetConsoleScreenBufferInfo(hStdout, &csbiInfo)
+		|| !GetConsoleCursorInfo(hStdout, &oldCursorInfo)) {
+		return false;
+	}
+	wOldColorAttrs = csbiInfo.wAttributes;
+	return true;
+}
+
+void CloseConsole(void) {
+	// Restore the original console mode.
+	SetConsoleMode(hStdin, fdwSaveOldMode);
+
+	// Restore the original text colors.
+	SetConsoleTextAttribute(hStdout, wOldColorAttrs);
+
+	// Restore the cursor.
+	SetConsoleCursorInfo(hStdout, &oldCursorInfo);
+
+	if (chiBuffer != NULL) {
+		freeBlock(chiBuffer);
+		chiBuffer = NULL;
+		chiBufferSize = 0;
+	}
+}
+
+COORD GetSizeConsole(void) {
+	CONSOLE_SCREEN_BUFFER_INFO csbi;
+	COORD size = { 0, 0 };
+	if (GetConsoleScreenBufferInfo(hStdout, &csbi)) {
+		size = csbi.dwSize;
+	}
+	return size;
+}
+
+COORD GetCursorConsole(void) {
+	CONSOLE_SCREEN_BUFFER_INFO csbi;
+	COORD position = { 0, 0 };
+	if (GetConsoleScreenBufferInfo(hStdout, &csbi)) {
+		position = csbi.dwCursorPosition;
+	}
+	return position;
+}
+
+void SetCursorConsole(COORD position) {
+	SetConsoleCursorPosition(hStdout, position);
+}
+
+bool IsCursorVisibleConsole(void) {
+	CONSOLE_CURSOR_INFO info;
+	if (!GetConsoleCursorInfo(hStdout, &info)) {
+		return true;
+	}
+	return info.bVisible ? true : false;
+}
+
+void ShowCursorConsole(bool visible) {
+	CONSOLE_CURSOR_INFO info;
+	info.dwSize = 100;
+	info.bVisible = visible ? TRUE : FALSE;
+	SetConsoleCursorInfo(hStdout, &info);
+}
+
+WORD GetAttributesConsole(void) {
+	CONSOLE_SCREEN_BUFFER_INFO csbi;
+	if (!GetConsoleScreenBufferInfo(hStdout, &csbi)) {
+		return wOldColorAttrs;
+	}
+	return csbi.wAttributes;
+}
+
+void SetAttributesConsole(WORD attributes) {
+	SetConsoleTextAttribute(hStdout, attributes);
+}
+
+int WriteTextConsole(const char* text, int length) {
+	DWORD cWritten;
+	if (!WriteFile(
+		hStdout,               // output handle
+		text,                  // string buffer
+		length,                // string length
+		&cWritten,             // bytes written
+		NULL))                 // not overlapped
+	{
+		return -1;
+	}
+	return cWritten;
+}
+
+void FillConsole(COORD position, int count, char character, WORD attributes) {
+	DWORD cCharsWritten;
+	FillConsoleOutputCharacterA(hStdout, character, count, position, &cCharsWritten);
+	FillConsoleOutputAttribute(hStdout, attributes, count, position, &cCharsWritten);
+}
+
+void ClearConsole(void) {
+	COORD coordScreen = { 0, 0 };    // home for the cursor
+	COORD size = GetSizeConsole();
+
+	// Fill the entire screen with blanks, and put the cursor at its home coordinates.
+	FillConsole(coordScreen, size.X * size.Y, ' ', GetAttributesConsole());
+	SetConsoleCursorPosition(hStdout, coordScreen);
+}
+
+bool ReadCellsConsole(ConsoleCell* cells, COORD position, COORD size) {
+	int count = size.X * size.Y;
+	CHAR_INFO* buffer = GetCellBuffer(count);
+	COORD coordBufCoord = { 0, 0 };
+	SMALL_RECT srctRect = { position.X, position.Y, position.X + size.X - 1, position.Y + size.Y - 1 };
+
+	if (!ReadConsoleOutputA(hStdout, buffer, size, coordBufCoord, &srctRect)) {
+		return false;
+	}
+	for (int i = 0; i < count; i++) {
+		cells[i].character = buffer[i].Char.AsciiChar;
+		cells[i].attributes = buffer[i].Attributes;
+	}
+	return true;
+}
+
+bool WriteCellsConsole(const ConsoleCell* cells, COORD position, COORD size) {
+	int count = size.X * size.Y;
+	CHAR_INFO* buffer = GetCellBuffer(count);
+	COORD coordBufCoord = { 0, 0 };
+	SMALL_RECT srctRect = { position.X, position.Y, position.X + size.X - 1, position.Y + size.Y - 1 };
+
+	for (int i = 0; i < count; i++) {
+		buffer[i].Char.AsciiChar = cells[i].character;
+		buffer[i].Attributes = cells[i].attributes;
+	}
+	return WriteConsoleOutputA(hStdout, buffer, size, coordBufCoord, &srctRect) ? true : false;
+}
+
+WORD ReadKeyConsole(void) {
+	INPUT_RECORD event;
+	DWORD cRead;
+
+	keyChar = 0;
+	for (;;) {
+		// The ANSI version gives the character in the input code page, which is Windows-1250.
+		if (!ReadConsoleInputA(hStdin, &event, 1, &cRead)) {
+			return 0;
+		}
+
+		// Only the key presses count, the releases and the modifier keys on their own are skipped.
+		if (event.EventType == KEY_EVENT && event.Event.KeyEvent.bKeyDown) {
+			switch (event.Event.KeyEvent.wVirtualKeyCode) {
+			case VK_SHIFT:
+			case VK_CONTROL:
+			case VK_MENU:
+			case VK_CAPITAL:
+				break;
+			default:
+				// The trace key is taken here, so it works on every screen.
+				if (HandleTraceKey(event.Event.KeyEvent.wVirtualKeyCode)) {
+					break;
+				}
+				keyChar = event.Event.KeyEvent.uChar.AsciiChar;
+				return event.Event.KeyEvent.wVirtualKeyCode;
+			}
+		}
+	}
+}
+
+char GetKeyCharConsole(void) {
+	return keyChar;
+}
+
+int ReadCharConsole(void) {
+	int ch = _getch();
+
+	// The arrows and the other extended keys start with 0xE0 instead of 0.
+	return (ch == 0xE0) ? 0 : ch;
+}
+
+string ReadLineConsole(void) {
+	DWORD fdwOldMode;
+	if (!GetConsoleMode(hStdin, &fdwOldMode)) {
+		return getLine();
+	}
+
+	// The line is typed with the line editing and the echo, whatever the current mode is.
+	SetConsoleMode(hStdin, fdwOldMode | ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT | ENABLE_PROCESSED_INPUT);
+	string line = getLine();
+	SetConsoleMode(hStdin, fdwOldMode);
+	return line;
+}
+
+// Private functions
+
+static bool SetWindowSize(int x, int y) {
+	// If either dimension is greater than the largest console window we can have,
+	// there is no point in attempting the change.
+	COORD largestSize = GetLargestConsoleWindowSize(hStdout);
+	if (x > largestSize.X || y > largestSize.Y) {
+		return false;
+	}
+
+	CONSOLE_SCREEN_BUFFER_INFO bufferInfo;
+	if (!GetConsoleScreenBufferInfo(hStdout, &bufferInfo)) {
+		return false;
+	}
+
+	SMALL_RECT winInfo = bufferInfo.srWindow;
+	COORD windowSize = { winInfo.Right - winInfo.Left + 1, winInfo.Bottom - winInfo.Top + 1 };
+
+	if (windowSize.X > x || windowSize.Y > y) {
+		// window size needs to be adjusted before the buffer size can be reduced.
+		SMALL_RECT info =
+		{
+			0,
+			0,
+			x < windowSize.X ? x - 1 : windowSize.X - 1,
+			y < windowSize.Y ? y - 1 : windowSize.Y - 1
+		};
+
+		if (!SetConsoleWindowInfo(hStdout, TRUE, &info)) {
+			return false;
+		}
+	}
+
+	COORD size = { x, y };
+	if (!SetConsoleScreenBufferSize(hStdout, size)) {
+		return false;
+	}
+
+	SMALL_RECT info = { 0, 0, x - 1, y - 1 };
+	return SetConsoleWindowInfo(hStdout, TRUE, &info) ? true : false;
+}
+
+static CHAR_INFO* GetCellBuffer(int count) {
+	if (count > chiBufferSize) {
+		if (chiBuffer != NULL) {
+			freeBlock(chiBuffer);
+		}
+		chiBuffer = newArray(count, CHAR_INFO);
+		chiBufferSize = count;
+	}
+	return chiBuffer;
+}
+
+#endif
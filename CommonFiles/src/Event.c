@@ -2,11 +2,24 @@
  * @file	Event.c.
  *
  * @brief	Event interface implementation.
+ *
+ * The name, the description and the location of an event are either shared strings, which the
+ * event holds a reference to, or pinned strings, which belong to the mapped data file or an arena
+ * and outlive every event. The events read from the data file keep their strings pinned, so
+ * loading them copies nothing; every string set afterwards is shared. A bit for each field tells
+ * which kind of string it holds.
  */
 
 #include "Event.h"
 #include "cslib.h"
 #include "strlib.h"
+#include "EventCategory.h"
+#include "SharedString.h"
+
+/** @brief	The bits of the string fields in the shared field mask. */
+#define NAME_FIELD 0x01
+#define DESCRIPTION_FIELD 0x02
+#define LOCATION_FIELD 0x04
 
 /**
  * @struct	EventCDT
@@ -22,10 +35,15 @@ struct EventCDT
 	string name;
 	string description;
 	string location;
-	string category;
+	int category;
 	time_t time;
+	/** @brief	The bits of the string fields that hold shared strings. */
+	unsigned char shared;
 };
 
+static void SetField(Event event, string* field, unsigned char bit, string text);
+static void ReleaseField(Event event, string field, unsigned char bit);
+
 Event newEvent(void)
 {
 	Event event;
@@ -33,16 +51,42 @@ Event newEvent(void)
 	event->name = NULL;
 	event->description = NULL;
 	event->location = NULL;
-	event->category = NULL;
+	event->category = NO_EVENT_CATEGORY;
 	event->time = 0;
+	event->shared = 0;
 	return event;
 }
 
 void freeEvent(Event event)
 {
+	ReleaseField(event, event->name, NAME_FIELD);
+	ReleaseField(event, event->description, DESCRIPTION_FIELD);
+	ReleaseField(event, event->location, LOCATION_FIELD);
 	freeBlock(event);
 }
 
+Event cloneEvent(Event event)
+{
+	Event clone;
+	clone = newBlock(Event);
+	clone->name = (event->shared & NAME_FIELD) ? RetainSharedString(event->name) : event->name;
+	clone->description = (event->shared & DESCRIPTION_FIELD) ? RetainSharedString(event->description) : event->description;
+	clone->location = (event->shared & LOCATION_FIELD) ? RetainSharedString(event->location) : event->location;
+	clone->category = event->category;
+	clone->time = event->time;
+	clone->shared = event->shared;
+	return clone;
+}
+
+bool equalEvents(Event first, Event second)
+{
+	return first->time == second->time
+		&& stringEqual(first->name, second->name)
+		&& stringEqual(first->description, second->description)
+		&& stringEqual(first->location, second->location)
+		&& first->category == second->category;
+}
+
 string getEventName(Event event)
 {
 	return event->name;
@@ -50,7 +94,7 @@ string getEventName(Event event)
 
 void setEventName(Event event, string name)
 {
-	event->name = name;
+	SetField(event, &event->name, NAME_FIELD, name);
 }
 
 string getEventDescription(Event event)
@@ -60,7 +104,7 @@ string getEventDescription(Event event)
 
 void setEventDescription(Event event, string desc)
 {
-	event->description = desc;
+	SetField(event, &event->description, DESCRIPTION_FIELD, desc);
 }
 
 string getEventLocation(Event event)
@@ -70,17 +114,44 @@ string getEventLocation(Event event)
 
 void setEventLocation(Event event, string location)
 {
+	SetField(event, &event->location, LOCATION_FIELD, location);
+}
+
+void pinEventStrings(Event event, string name, string desc, string location)
+{
+	ReleaseField(event, event->name, NAME_FIELD);
+	ReleaseField(event, event->description, DESCRIPTION_FIELD);
+	ReleaseField(event, event->location, LOCATION_FIELD);
+	event->name = name;
+	event->description = desc;
 	event->location = location;
+	event->shared = 0;
+}
+
+void adoptEventStrings(Event event, string name, string desc, string location)
+{
+	ReleaseField(event, event->name, NAME_FIELD);
+	ReleaseField(event, event->description, DESCRIPTION_FIELD);
+	ReleaseField(event, event->location, LOCATION_FIELD);
+	event->name = name;
+	event->description = desc;
+	event->location = location;
+	event->shared = NAME_FIELD | DESCRIPTION_FIELD | LOCATION_FIELD;
 }
 
 string getEventCategory(Event event)
+{
+	return getInternedEventCategory(event->category);
+}
+
+int getEventCategoryId(Event event)
 {
 	return event->category;
 }
 
 void setEventCategory(Event event, string category)
 {
-	event->category = category;
+	event->category = internEventCategory(category);
 }
 
 time_t getEventTime(Event event)
@@ -106,23 +177,18 @@ int CompareEventLocations(const void* p1, const void* p2) {
 	Event second = (Event) p2;
 	string firstLocation = getEventLocation(first);
 	string secondLocation = getEventLocation(second);
-	int res = stringCompare(firstLocation, secondLocation);
-	if (res == 0) {
-		res = CompareEventNames(p1, p2);
-	}
-	return res;
+	return stringCompare(firstLocation, secondLocation);
 }
 
 int CompareEventCategories(const void* p1, const void* p2) {
 	Event first = (Event) p1;
 	Event second = (Event) p2;
+	if (getEventCategoryId(first) == getEventCategoryId(second)) {
+		return 0;
+	}
 	string firstCategory = getEventCategory(first);
 	string secondCategory = getEventCategory(second);
-	int res = stringCompare(firstCategory, secondCategory);
-	if (res == 0) {
-		res = CompareEventNames(p1, p2);
-	}
-	return res;
+	return stringCompare(firstCategory, secondCategory);
 }
 
 int CompareEventTimes(const void* p1, const void* p2) {
@@ -131,7 +197,7 @@ int CompareEventTimes(const void* p1, const void* p2) {
 	time_t firstTime = getEventTime(first);
 	time_t secondTime = getEventTime(second);
 	if (firstTime == secondTime) {
-		return CompareEventNames(p1, p2);
+		return 0;
 	}
 	else {
 		return (firstTime < secondTime) ? -1 : +1;
@@ -144,9 +210,32 @@ int CompareEventTimesDescending(const void* p1, const void* p2) {
 	time_t firstTime = getEventTime(first);
 	time_t secondTime = getEventTime(second);
 	if (firstTime == secondTime) {
-		return CompareEventNames(p1, p2);
+		return 0;
 	}
 	else {
 		return (firstTime > secondTime) ? -1 : +1;
 	}
 }
+
+// Private functions
+
+static void SetField(Event event, string* field, unsigned char bit, string text)
+{
+	// The new string is made first, in case the text is the old string itself.
+	string shared = (text != NULL) ? NewSharedString(text) : NULL;
+	ReleaseField(event, *field, bit);
+	*field = shared;
+	if (shared != NULL) {
+		event->shared |= bit;
+	}
+	else {
+		event->shared &= ~bit;
+	}
+}
+
+static void ReleaseField(Event event, string field, unsigned char bit)
+{
+	if (event->shared & bit) {
+		ReleaseSharedString(field);
+	}
+}
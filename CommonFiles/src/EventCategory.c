@@ -7,6 +7,7 @@
 #include "EventCategory.h"
 #include "cslib.h"
 #include "strlib.h"
+#include "map.h"
 
 /**
  * @struct	EventCategoryCDT
@@ -23,6 +24,25 @@ struct EventCategoryCDT
 	string name;
 };
 
+/** @brief	The category IDs by the category names. */
+static Map categoryIds = NULL;
+
+/** @brief	Number of the category names in a page of the names table. */
+#define CATEGORY_PAGE_SIZE 64
+
+/** @brief	The largest number of the pages in the names table. */
+#define CATEGORY_PAGES 1024
+
+/**
+ * @brief	The category names by the category IDs, in pages. A page never moves once it is
+ * 			allocated, so the autosave worker can look the names of the events it writes up while
+ * 			new names are added.
+ */
+static string* categoryPages[CATEGORY_PAGES];
+
+/** @brief	Number of the category names. */
+static int categoryCount = 0;
+
 EventCategory newEventCategory(void)
 {
 	EventCategory category;
@@ -53,3 +73,52 @@ int CompareEventCategoryName(const void* p1, const void* p2) {
 	string secondName = getEventCategoryName(second);
 	return stringCompare(firstName, secondName);
 }
+
+int internEventCategory(string name) {
+	if (name == NULL) {
+		return NO_EVENT_CATEGORY;
+	}
+	int id = findEventCategoryId(name);
+	if (id != NO_EVENT_CATEGORY) {
+		return id;
+	}
+
+	if (categoryIds == NULL) {
+		categoryIds = newMapOfType(HASH_MAP);
+	}
+	int page = categoryCount / CATEGORY_PAGE_SIZE;
+	if (page == CATEGORY_PAGES) {
+		error("internEventCategory: Too many categories");
+	}
+	if (categoryPages[page] == NULL) {
+		categoryPages[page] = newArray(CATEGORY_PAGE_SIZE, string);
+	}
+
+	// The map and the names table share the copy of the name.
+	string symbol = copyString(name);
+	int* value = newBlock(int*);
+	*value = categoryCount;
+	putMap(categoryIds, symbol, value);
+	categoryPages[page][categoryCount % CATEGORY_PAGE_SIZE] = symbol;
+	categoryCount++;
+	return *value;
+}
+
+int findEventCategoryId(string name) {
+	if (name == NULL || categoryIds == NULL) {
+		return NO_EVENT_CATEGORY;
+	}
+	int* value = getMap(categoryIds, name);
+	return (value != NULL) ? *value : NO_EVENT_CATEGORY;
+}
+
+string getInternedEventCategory(int id) {
+	if (id < 0 || id >= categoryCount) {
+		return NULL;
+	}
+	return categoryPages[id / CATEGORY_PAGE_SIZE][id % CATEGORY_PAGE_SIZE];
+}
+
+int countEventCategoryIds(void) {
+	return categoryCount;
+}
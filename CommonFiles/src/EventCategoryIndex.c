@@ -0,0 +1,269 @@
+/**
+ * @file	EventCategoryIndex.c.
+ *
+ * @brief	Event category index implementation.
+ *
+ * Every category ID has its own posting list, an array of the event positions in the ascending
+ * order. The lists are built together by a counting sort of the event positions by their category
+ * IDs. A change of a single event changes only the list of its category: the position is inserted
+ * into it or removed from it with a binary search. The positions that come after an inserted or a
+ * removed event are moved by one in the other lists, which only happens when the event is not the
+ * last one.
+ */
+
+#include "EventCategoryIndex.h"
+#include <string.h>
+#include "cslib.h"
+#include "vector.h"
+#include "Event.h"
+#include "EventCategory.h"
+
+/** @brief	Initial capacity of a posting list. */
+#define INITIAL_LIST_CAPACITY 8
+
+/**
+ * @struct	PostingList
+ *
+ * @brief	The positions of the events of a category.
+ */
+
+typedef struct {
+	/** @brief	The positions, in the ascending order. */
+	int* rows;
+	/** @brief	Number of the positions. */
+	int count;
+	/** @brief	Number of the positions the array can hold. */
+	int capacity;
+} PostingList;
+
+/**
+ * @struct	EventCategoryIndexCDT
+ *
+ * @brief	The event category index.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ */
+
+struct EventCategoryIndexCDT {
+	/** @brief	The events. */
+	Vector events;
+	/** @brief	The version of the events the index is up to date with. */
+	unsigned long version;
+	/** @brief	True if the index is built. */
+	bool built;
+	/** @brief	The posting list of every category ID. */
+	PostingList* lists;
+	/** @brief	Number of the category IDs with a posting list. */
+	int count;
+};
+
+static void RefreshIndex(EventCategoryIndex index);
+static void BuildIndex(EventCategoryIndex index);
+static void FreeEntries(EventCategoryIndex index);
+static bool IsCurrentIndex(EventCategoryIndex index, unsigned long version);
+static PostingList* GetList(EventCategoryIndex index, int id);
+static int FindRow(const PostingList* list, int row);
+static void InsertRow(PostingList* list, int row);
+static void RemoveRow(PostingList* list, int row);
+static void MoveRows(EventCategoryIndex index, int row, int delta);
+
+EventCategoryIndex NewEventCategoryIndex(Vector events) {
+	EventCategoryIndex index = newBlock(EventCategoryIndex);
+	index->events = events;
+	index->version = 0;
+	index->built = false;
+	index->lists = NULL;
+	index->count = 0;
+	RefreshIndex(index);
+	return index;
+}
+
+void FreeEventCategoryIndex(EventCategoryIndex index) {
+	FreeEntries(index);
+	freeBlock(index);
+}
+
+void InsertEventCategoryIndex(EventCategoryIndex index, int row, unsigned long version) {
+	if (!IsCurrentIndex(index, version)) {
+		return;
+	}
+	MoveRows(index, row, 1);
+	int id = getEventCategoryId(getVector(index->events, row));
+	if (id != NO_EVENT_CATEGORY) {
+		InsertRow(GetList(index, id), row);
+	}
+	index->version = versionVector(index->events);
+}
+
+void DeleteEventCategoryIndex(EventCategoryIndex index, int row, Event event, unsigned long version) {
+	if (!IsCurrentIndex(index, version)) {
+		return;
+	}
+	int id = getEventCategoryId(event);
+	if (id != NO_EVENT_CATEGORY) {
+		RemoveRow(GetList(index, id), row);
+	}
+	MoveRows(index, row, -1);
+	index->version = versionVector(index->events);
+}
+
+void UpdateEventCategoryIndex(EventCategoryIndex index, int row, Event oldEvent) {
+	if (!IsCurrentIndex(index, versionVector(index->events))) {
+		return;
+	}
+	int oldId = getEventCategoryId(oldEvent);
+	int id = getEventCategoryId(getVector(index->events, row));
+	if (id == oldId) {
+		return;
+	}
+	if (oldId != NO_EVENT_CATEGORY) {
+		RemoveRow(GetList(index, oldId), row);
+	}
+	if (id != NO_EVENT_CATEGORY) {
+		InsertRow(GetList(index, id), row);
+	}
+}
+
+int GetRowsEventCategoryIndex(EventCategoryIndex index, string category, const int** rows) {
+	RefreshIndex(index);
+	int id = findEventCategoryId(category);
+	if (id < 0 || id >= index->count) {
+		*rows = NULL;
+		return 0;
+	}
+	*rows = index->lists[id].rows;
+	return index->lists[id].count;
+}
+
+// Private functions
+
+static void RefreshIndex(EventCategoryIndex index) {
+	if (!index->built || index->version != versionVector(index->events)) {
+		FreeEntries(index);
+		BuildIndex(index);
+		index->version = versionVector(index->events);
+		index->built = true;
+	}
+}
+
+static void BuildIndex(EventCategoryIndex index) {
+	int n = sizeVector(index->events);
+	index->count = countEventCategoryIds();
+	index->lists = newArray(index->count > 0 ? index->count : 1, PostingList);
+
+	// The sizes of the lists are counted first, so every list is allocated only once.
+	for (int id = 0; id < index->count; id++) {
+		index->lists[id].count = 0;
+	}
+	for (int i = 0; i < n; i++) {
+		int id = getEventCategoryId(getVector(index->events, i));
+		if (id != NO_EVENT_CATEGORY) {
+			index->lists[id].count++;
+		}
+	}
+	for (int id = 0; id < index->count; id++) {
+		PostingList* list = &index->lists[id];
+		list->capacity = (list->count > INITIAL_LIST_CAPACITY) ? list->count : INITIAL_LIST_CAPACITY;
+		list->rows = newArray(list->capacity, int);
+		list->count = 0;
+	}
+
+	// The events are then placed at the ends of their lists, which keeps every list in order.
+	for (int i = 0; i < n; i++) {
+		int id = getEventCategoryId(getVector(index->events, i));
+		if (id != NO_EVENT_CATEGORY) {
+			PostingList* list = &index->lists[id];
+			list->rows[list->count++] = i;
+		}
+	}
+}
+
+static void FreeEntries(EventCategoryIndex index) {
+	if (index->lists != NULL) {
+		for (int id = 0; id < index->count; id++) {
+			freeBlock(index->lists[id].rows);
+		}
+		freeBlock(index->lists);
+		index->lists = NULL;
+	}
+	index->count = 0;
+	index->built = false;
+}
+
+static bool IsCurrentIndex(EventCategoryIndex index, unsigned long version) {
+	// An index that missed a change, such as sorting, is built again, which takes the change in too.
+	if (!index->built || index->version != version) {
+		RefreshIndex(index);
+		return false;
+	}
+	return true;
+}
+
+static PostingList* GetList(EventCategoryIndex index, int id) {
+	// The categories added after the index was built get their lists on the first use.
+	if (id >= index->count) {
+		PostingList* lists = newArray(id + 1, PostingList);
+		memcpy(lists, index->lists, index->count * sizeof(PostingList));
+		for (int i = index->count; i <= id; i++) {
+			lists[i].rows = newArray(INITIAL_LIST_CAPACITY, int);
+			lists[i].count = 0;
+			lists[i].capacity = INITIAL_LIST_CAPACITY;
+		}
+		freeBlock(index->lists);
+		index->lists = lists;
+		index->count = id + 1;
+	}
+	return &index->lists[id];
+}
+
+static int FindRow(const PostingList* list, int row) {
+	// The first position in the list that is not before the row.
+	int low = 0;
+	int high = list->count;
+	while (low < high) {
+		int middle = low + (high - low) / 2;
+		if (list->rows[middle] < row) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+static void InsertRow(PostingList* list, int row) {
+	if (list->count == list->capacity) {
+		int* rows = newArray(list->capacity * 2, int);
+		memcpy(rows, list->rows, list->count * sizeof(int));
+		freeBlock(list->rows);
+		list->rows = rows;
+		list->capacity *= 2;
+	}
+	int i = FindRow(list, row);
+	memmove(list->rows + i + 1, list->rows + i, (list->count - i) * sizeof(int));
+	list->rows[i] = row;
+	list->count++;
+}
+
+static void RemoveRow(PostingList* list, int row) {
+	int i = FindRow(list, row);
+	if (i < list->count && list->rows[i] == row) {
+		memmove(list->rows + i, list->rows + i + 1, (list->count - i - 1) * sizeof(int));
+		list->count--;
+	}
+}
+
+static void MoveRows(EventCategoryIndex index, int row, int delta) {
+	// Only the positions after the row move, and they are at the ends of the lists.
+	for (int id = 0; id < index->count; id++) {
+		PostingList* list = &index->lists[id];
+		if (list->count == 0 || list->rows[list->count - 1] < row) {
+			continue;
+		}
+		for (int i = FindRow(list, row); i < list->count; i++) {
+			list->rows[i] += delta;
+		}
+	}
+}
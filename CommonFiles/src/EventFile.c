@@ -0,0 +1,656 @@
+/**
+ * @file	EventFile.c.
+ *
+ * @brief	Events data file implementation.
+ *
+ * Layout of the header:
+ * 	offset  0	magic (4 bytes)
+ * 	offset  4	format version (16 bits)
+ * 	offset  6	header size (16 bits)
+ * 	offset  8	number of events (32 bits)
+ * 	offset 12	sequence number of the last journal record in the file (32 bits)
+ * 	offset 16	offset table position (64 bits)
+ *
+ * The offset table holds a 64-bit position for every event record. It is followed by the footer, the
+ * CRC-32 of the records and the offset table, continued over the header (32 bits). The footer was
+ * added in the version 2, the files of the version 1 are read without the check.
+ */
+
+#include "EventFile.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <stdint.h>
+#include <string.h>
+#include "cslib.h"
+#include "strlib.h"
+#include "vector.h"
+#include "Event.h"
+#include "arena.h"
+#include "AtomicFile.h"
+#include "SharedString.h"
+#include "utilities.h"
+#include "platform.h"
+
+/** @brief	Size of the offset table entry in bytes. */
+#define INDEX_ENTRY_SIZE 8
+
+/** @brief	Initial capacity of the writer offset table. */
+#define INITIAL_INDEX_CAPACITY 64
+
+/** @brief	Size of the footer in bytes. */
+#define FOOTER_SIZE 4
+
+/** @brief	The first version of the format that has the footer. */
+#define FOOTER_VERSION 2
+
+/** @brief	Number of the characters of a record string read at once. */
+#define RECORD_STRING_CHUNK 4096
+
+/** @brief	The CRC-32 (IEEE 802.3, reflected) of every byte value. */
+static const uint32_t crcTable[256] = {
+	0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F, 0xE963A535, 0x9E6495A3,
+	0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988, 0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91,
+	0x1DB71064, 0x6AB020F2, 0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+	0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5,
+	0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172, 0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B,
+	0x35B5A8FA, 0x42B2986C, 0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+	0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423, 0xCFBA9599, 0xB8BDA50F,
+	0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924, 0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D,
+	0x76DC4190, 0x01DB7106, 0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+	0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D, 0x91646C97, 0xE6635C01,
+	0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E, 0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457,
+	0x65B0D9C6, 0x12B7E950, 0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+	0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB,
+	0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0, 0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9,
+	0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+	0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81, 0xB7BD5C3B, 0xC0BA6CAD,
+	0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A, 0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683,
+	0xE3630B12, 0x94643B84, 0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+	0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7,
+	0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC, 0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5,
+	0xD6D6A3E8, 0xA1D1937E, 0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+	0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55, 0x316E8EEF, 0x4669BE79,
+	0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236, 0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F,
+	0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+	0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F, 0x72076785, 0x05005713,
+	0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38, 0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21,
+	0x86D3D2D4, 0xF1D4E242, 0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+	0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45,
+	0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2, 0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB,
+	0xAED16A4A, 0xD9D65ADC, 0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+	0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693, 0x54DE5729, 0x23D967BF,
+	0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94, 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
+};
+
+/**
+ * @struct	EventFileWriterCDT
+ *
+ * @brief	An events data file writer.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ */
+
+struct EventFileWriterCDT {
+	FILE* filepoint;
+	uint64_t* offsets;
+	uint32_t count;
+	uint32_t capacity;
+	uint32_t sequence;
+	uint64_t position;
+	uint32_t crc;
+};
+
+/**
+ * @struct	EventFileMappingCDT
+ *
+ * @brief	A read-only mapping of the events data file.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ */
+
+struct EventFileMappingCDT {
+#ifdef _WIN32
+	HANDLE file;
+	HANDLE mapping;
+#endif
+	const unsigned char* data;
+	size_t size;
+};
+
+static void PutUInt16(unsigned char* buf, uint16_t value);
+static void PutUInt32(unsigned char* buf, uint32_t value);
+static void PutUInt64(unsigned char* buf, uint64_t value);
+static uint16_t GetUInt16(const unsigned char* buf);
+static uint32_t GetUInt32(const unsigned char* buf);
+static uint64_t GetUInt64(const unsigned char* buf);
+static void EncodeHeader(unsigned char* header, uint32_t count, uint32_t sequence, uint64_t indexOffset);
+static bool ReadHeader(FILE* filepoint, uint32_t* count, uint64_t* indexOffset);
+static bool CheckHeader(const unsigned char* header, uint32_t* count, uint64_t* indexOffset);
+static Vector DecodeEvents(const unsigned char* data, size_t size, Arena arena);
+static string DecodeString(const unsigned char* data, size_t size, size_t* pos, Arena arena);
+static Event DecodeEvent(const unsigned char* data, size_t size, size_t pos, Arena arena);
+static bool CheckFooter(const unsigned char* data, size_t size, uint64_t footerOffset);
+static unsigned char* EncodeEventRecord(Event event, size_t* size);
+static uint32_t UpdateCrc(uint32_t crc, const unsigned char* data, size_t size);
+static string ReadRecordString(FILE* filepoint);
+static void ExpandWriterCapacity(EventFileWriter writer);
+
+bool IsEventFile(FILE* filepoint) {
+	char magic[4];
+	size_t read = fread(magic, 1, sizeof magic, filepoint);
+	rewind(filepoint);
+	return read == sizeof magic && memcmp(magic, EVENT_FILE_MAGIC, sizeof magic) == 0;
+}
+
+Vector ReadEventFile(FILE* filepoint, Arena arena) {
+	// Read the whole file at once.
+	_fseeki64(filepoint, 0, SEEK_END);
+	int64_t end = _ftelli64(filepoint);
+	rewind(filepoint);
+	if (end < EVENT_FILE_HEADER_SIZE || (uint64_t) end > SIZE_MAX) {
+		return NULL;
+	}
+
+	size_t size = (size_t) end;
+	unsigned char* data = newArray(size, unsigned char);
+	if (fread(data, 1, size, filepoint) != size) {
+		freeBlock(data);
+		return NULL;
+	}
+
+	Vector events = DecodeEvents(data, size, arena);
+	freeBlock(data);
+	return events;
+}
+
+#ifdef _WIN32
+
+EventFileMapping MapEventFile(string fileName) {
+	// Deleting is shared, so the file can still be replaced while it is mapped.
+	HANDLE file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return NULL;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart < EVENT_FILE_HEADER_SIZE) {
+		CloseHandle(file);
+		return NULL;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL) {
+		CloseHandle(file);
+		return NULL;
+	}
+
+	const unsigned char* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == NULL || memcmp(data, EVENT_FILE_MAGIC, 4) != 0) {
+		if (data != NULL) UnmapViewOfFile(data);
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return NULL;
+	}
+
+	EventFileMapping eventMapping = newBlock(EventFileMapping);
+	eventMapping->file = file;
+	eventMapping->mapping = mapping;
+	eventMapping->data = data;
+	eventMapping->size = (size_t) size.QuadPart;
+	return eventMapping;
+}
+
+#else
+
+EventFileMapping MapEventFile(string fileName) {
+	int file = open(fileName, O_RDONLY);
+	if (file < 0) {
+		return NULL;
+	}
+
+	struct stat info;
+	if (fstat(file, &info) != 0 || info.st_size < EVENT_FILE_HEADER_SIZE) {
+		close(file);
+		return NULL;
+	}
+
+	// The mapping stays valid after the file is closed, or replaced.
+	void* data = mmap(NULL, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (data == MAP_FAILED) {
+		return NULL;
+	}
+	if (memcmp(data, EVENT_FILE_MAGIC, 4) != 0) {
+		munmap(data, (size_t) info.st_size);
+		return NULL;
+	}
+
+	EventFileMapping eventMapping = newBlock(EventFileMapping);
+	eventMapping->data = data;
+	eventMapping->size = (size_t) info.st_size;
+	return eventMapping;
+}
+
+#endif
+
+Vector ReadMappedEventFile(EventFileMapping mapping) {
+	return DecodeEvents(mapping->data, mapping->size, NULL);
+}
+
+void UnmapEventFile(EventFileMapping mapping) {
+#ifdef _WIN32
+	UnmapViewOfFile(mapping->data);
+	CloseHandle(mapping->mapping);
+	CloseHandle(mapping->file);
+#else
+	munmap((void*) mapping->data, mapping->size);
+#endif
+	freeBlock(mapping);
+}
+
+Event ReadEventFileAt(FILE* filepoint, size_t index) {
+	uint32_t count;
+	uint64_t indexOffset;
+	if (!ReadHeader(filepoint, &count, &indexOffset) || index >= count) {
+		return NULL;
+	}
+
+	unsigned char entry[INDEX_ENTRY_SIZE];
+	uint64_t entryOffset = indexOffset + (uint64_t) index * INDEX_ENTRY_SIZE;
+	if (entryOffset > INT64_MAX || _fseeki64(filepoint, (int64_t) entryOffset, SEEK_SET) != 0
+		|| fread(entry, 1, sizeof entry, filepoint) != sizeof entry) {
+		return NULL;
+	}
+
+	uint64_t recordOffset = GetUInt64(entry);
+	if (recordOffset > INT64_MAX || _fseeki64(filepoint, (int64_t) recordOffset, SEEK_SET) != 0) {
+		return NULL;
+	}
+	return ReadEventRecord(filepoint);
+}
+
+Vector ReadLegacyEventFile(FILE* filepoint) {
+	Vector events = newVector();
+	size_t count;
+	fread(&count, sizeof count, 1, filepoint);
+	for (size_t i = 0; i < count; i++) {
+		Event e = ReadEvent(filepoint);
+		addVector(events, e);
+	}
+	return events;
+}
+
+size_t WriteEventRecord(FILE* filepoint, Event event) {
+	size_t size;
+	unsigned char* record = EncodeEventRecord(event, &size);
+	size_t written = fwrite(record, 1, size, filepoint);
+	freeBlock(record);
+	return written;
+}
+
+Event ReadEventRecord(FILE* filepoint) {
+	string eventName = ReadRecordString(filepoint);
+	string eventDescription = (eventName != NULL) ? ReadRecordString(filepoint) : NULL;
+	string eventLocation = (eventDescription != NULL) ? ReadRecordString(filepoint) : NULL;
+	string eventCategory = (eventLocation != NULL) ? ReadRecordString(filepoint) : NULL;
+	unsigned char time[sizeof(uint64_t)];
+
+	if (eventCategory == NULL || fread(time, 1, sizeof time, filepoint) != sizeof time) {
+		if (eventName != NULL) ReleaseSharedString(eventName);
+		if (eventDescription != NULL) ReleaseSharedString(eventDescription);
+		if (eventLocation != NULL) ReleaseSharedString(eventLocation);
+		if (eventCategory != NULL) ReleaseSharedString(eventCategory);
+		return NULL;
+	}
+
+	// The strings are read as shared strings, so the event takes them over without a copy and
+	// keeps only the ID of the interned category.
+	Event e = newEvent();
+	adoptEventStrings(e, eventName, eventDescription, eventLocation);
+	setEventCategory(e, eventCategory);
+	setEventTime(e, (time_t) (int64_t) GetUInt64(time));
+	ReleaseSharedString(eventCategory);
+
+	return e;
+}
+
+EventFileWriter NewEventFileWriter(FILE* filepoint, uint32_t sequence) {
+	EventFileWriter writer = newBlock(EventFileWriter);
+	writer->filepoint = filepoint;
+	writer->capacity = INITIAL_INDEX_CAPACITY;
+	writer->offsets = newArray(writer->capacity, uint64_t);
+	writer->count = 0;
+	writer->sequence = sequence;
+	writer->position = EVENT_FILE_HEADER_SIZE;
+	writer->crc = 0xFFFFFFFF;
+
+	// The header is completed once all events are written.
+	unsigned char header[EVENT_FILE_HEADER_SIZE];
+	EncodeHeader(header, 0, 0, 0);
+	fwrite(header, 1, sizeof header, filepoint);
+	return writer;
+}
+
+void AppendEventFileWriter(EventFileWriter writer, Event event) {
+	if (writer->count == writer->capacity) {
+		ExpandWriterCapacity(writer);
+	}
+	writer->offsets[writer->count++] = writer->position;
+
+	size_t size;
+	unsigned char* record = EncodeEventRecord(event, &size);
+	writer->crc = UpdateCrc(writer->crc, record, size);
+	writer->position += fwrite(record, 1, size, writer->filepoint);
+	freeBlock(record);
+}
+
+void CloseEventFileWriter(EventFileWriter writer) {
+	size_t size = (size_t) writer->count * INDEX_ENTRY_SIZE;
+	if (size > 0) {
+		unsigned char* index = newArray(size, unsigned char);
+		for (uint32_t i = 0; i < writer->count; i++) {
+			PutUInt64(index + (size_t) i * INDEX_ENTRY_SIZE, writer->offsets[i]);
+		}
+		writer->crc = UpdateCrc(writer->crc, index, size);
+		fwrite(index, 1, size, writer->filepoint);
+		freeBlock(index);
+	}
+
+	// The header is known only now, so the checksum covers it last.
+	unsigned char header[EVENT_FILE_HEADER_SIZE];
+	unsigned char footer[FOOTER_SIZE];
+	EncodeHeader(header, writer->count, writer->sequence, writer->position);
+	PutUInt32(footer, ~UpdateCrc(writer->crc, header, sizeof header));
+	fwrite(footer, 1, sizeof footer, writer->filepoint);
+
+	fseek(writer->filepoint, 0, SEEK_SET);
+	fwrite(header, 1, sizeof header, writer->filepoint);
+	fseek(writer->filepoint, 0, SEEK_END);
+
+	freeBlock(writer->offsets);
+	freeBlock(writer);
+}
+
+void WriteEventFile(FILE* filepoint, Vector events, uint32_t sequence) {
+	EventFileWriter writer = NewEventFileWriter(filepoint, sequence);
+	for (int i = 0; i < sizeVector(events); i++) {
+		AppendEventFileWriter(writer, getVector(events, i));
+	}
+	CloseEventFileWriter(writer);
+}
+
+uint32_t GetEventFileSequence(FILE* filepoint) {
+	unsigned char header[EVENT_FILE_HEADER_SIZE];
+	uint32_t count;
+	uint64_t indexOffset;
+	rewind(filepoint);
+	if (fread(header, 1, sizeof header, filepoint) != sizeof header
+		|| !CheckHeader(header, &count, &indexOffset)) {
+		return 0;
+	}
+	return GetUInt32(header + 12);
+}
+
+bool ConvertLegacyEventFile(string fileName) {
+	FILE* filepoint;
+	if (fopen_s(&filepoint, fileName, "rb") != 0) {
+		return false;
+	}
+	if (IsEventFile(filepoint)) {
+		fclose(filepoint);
+		return false;
+	}
+
+	Vector events = ReadLegacyEventFile(filepoint);
+	fclose(filepoint);
+
+	// The legacy file is kept as the backup.
+	if ((filepoint = OpenAtomicFile(fileName)) == NULL) {
+		error_msg("Nije moguce otvoriti fajl %s", fileName);
+	}
+	WriteEventFile(filepoint, events, 0);
+	if (!CommitAtomicFile(filepoint, fileName)) {
+		error_msg("Nije moguce sacuvati fajl %s", fileName);
+	}
+
+	for (int i = 0; i < sizeVector(events); i++) {
+		freeEvent(getVector(events, i));
+	}
+	freeVector(events);
+	return true;
+}
+
+// Private functions
+
+static void PutUInt16(unsigned char* buf, uint16_t value) {
+	buf[0] = (unsigned char) value;
+	buf[1] = (unsigned char) (value >> 8);
+}
+
+static void PutUInt32(unsigned char* buf, uint32_t value) {
+	PutUInt16(buf, (uint16_t) value);
+	PutUInt16(buf + 2, (uint16_t) (value >> 16));
+}
+
+static void PutUInt64(unsigned char* buf, uint64_t value) {
+	PutUInt32(buf, (uint32_t) value);
+	PutUInt32(buf + 4, (uint32_t) (value >> 32));
+}
+
+static uint16_t GetUInt16(const unsigned char* buf) {
+	return (uint16_t) (buf[0] | (buf[1] << 8));
+}
+
+static uint32_t GetUInt32(const unsigned char* buf) {
+	return GetUInt16(buf) | ((uint32_t) GetUInt16(buf + 2) << 16);
+}
+
+static uint64_t GetUInt64(const unsigned char* buf) {
+	return GetUInt32(buf) | ((uint64_t) GetUInt32(buf + 4) << 32);
+}
+
+static void EncodeHeader(unsigned char* header, uint32_t count, uint32_t sequence, uint64_t indexOffset) {
+	memset(header, 0, EVENT_FILE_HEADER_SIZE);
+	memcpy(header, EVENT_FILE_MAGIC, 4);
+	PutUInt16(header + 4, EVENT_FILE_VERSION);
+	PutUInt16(header + 6, EVENT_FILE_HEADER_SIZE);
+	PutUInt32(header + 8, count);
+	PutUInt32(header + 12, sequence);
+	PutUInt64(header + 16, indexOffset);
+}
+
+static bool ReadHeader(FILE* filepoint, uint32_t* count, uint64_t* indexOffset) {
+	unsigned char header[EVENT_FILE_HEADER_SIZE];
+	rewind(filepoint);
+	if (fread(header, 1, sizeof header, filepoint) != sizeof header) {
+		return false;
+	}
+	return CheckHeader(header, count, indexOffset);
+}
+
+static bool CheckHeader(const unsigned char* header, uint32_t* count, uint64_t* indexOffset) {
+	if (memcmp(header, EVENT_FILE_MAGIC, 4) != 0
+		|| GetUInt16(header + 4) > EVENT_FILE_VERSION
+		|| GetUInt16(header + 6) < EVENT_FILE_HEADER_SIZE) {
+		return false;
+	}
+	*count = GetUInt32(header + 8);
+	*indexOffset = GetUInt64(header + 16);
+	return true;
+}
+
+static Vector DecodeEvents(const unsigned char* data, size_t size, Arena arena) {
+	uint32_t count;
+	uint64_t indexOffset;
+	if (!CheckHeader(data, &count, &indexOffset)
+		|| indexOffset > (uint64_t) size
+		|| (uint64_t) count * INDEX_ENTRY_SIZE > (uint64_t) size - indexOffset) {
+		return NULL;
+	}
+	if (GetUInt16(data + 4) >= FOOTER_VERSION
+		&& !CheckFooter(data, size, indexOffset + (uint64_t) count * INDEX_ENTRY_SIZE)) {
+		return NULL;
+	}
+
+	Vector events = newVector();
+	for (uint32_t i = 0; i < count; i++) {
+		uint64_t offset = GetUInt64(data + indexOffset + (uint64_t) i * INDEX_ENTRY_SIZE);
+		Event e = (offset < (uint64_t) size) ? DecodeEvent(data, size, (size_t) offset, arena) : NULL;
+		if (e == NULL) {
+			for (int j = 0; j < sizeVector(events); j++) {
+				freeEvent(getVector(events, j));
+			}
+			freeVector(events);
+			return NULL;
+		}
+		addVector(events, e);
+	}
+	return events;
+}
+
+static string DecodeString(const unsigned char* data, size_t size, size_t* pos, Arena arena) {
+	if (size - *pos < sizeof(uint32_t)) {
+		return NULL;
+	}
+	uint32_t length = GetUInt32(data + *pos);
+	*pos += sizeof(uint32_t);
+	if (size - *pos < (size_t) length + 1) {
+		return NULL;
+	}
+
+	string str;
+	if (arena == NULL) {
+		// The string is used in place, so it has to be terminated in the file.
+		if (data[*pos + length] != '\0') {
+			return NULL;
+		}
+		str = (string) (data + *pos);
+	}
+	else {
+		str = newArenaArray(arena, length + 1, char);
+		memcpy(str, data + *pos, length);
+		str[length] = '\0';
+	}
+	*pos += (size_t) length + 1;
+	return str;
+}
+
+static Event DecodeEvent(const unsigned char* data, size_t size, size_t pos, Arena arena) {
+	// The strings belong to the mapping or the arena, so there is nothing to free on failure.
+	string eventName = DecodeString(data, size, &pos, arena);
+	string eventDescription = (eventName != NULL) ? DecodeString(data, size, &pos, arena) : NULL;
+	string eventLocation = (eventDescription != NULL) ? DecodeString(data, size, &pos, arena) : NULL;
+	string eventCategory = (eventLocation != NULL) ? DecodeString(data, size, &pos, arena) : NULL;
+
+	if (eventCategory == NULL || size - pos < sizeof(uint64_t)) {
+		return NULL;
+	}
+
+	Event e = newEvent();
+	pinEventStrings(e, eventName, eventDescription, eventLocation);
+	setEventCategory(e, eventCategory);
+	setEventTime(e, (time_t) (int64_t) GetUInt64(data + pos));
+
+	return e;
+}
+
+static bool CheckFooter(const unsigned char* data, size_t size, uint64_t footerOffset) {
+	if (footerOffset > (uint64_t) size || (uint64_t) size - footerOffset < FOOTER_SIZE) {
+		return false;
+	}
+	size_t footer = (size_t) footerOffset;
+	uint32_t crc = UpdateCrc(0xFFFFFFFF, data + EVENT_FILE_HEADER_SIZE, footer - EVENT_FILE_HEADER_SIZE);
+	crc = ~UpdateCrc(crc, data, EVENT_FILE_HEADER_SIZE);
+	return crc == GetUInt32(data + footer);
+}
+
+static unsigned char* EncodeEventRecord(Event event, size_t* size) {
+	string fields[] = {
+		getEventName(event),
+		getEventDescription(event),
+		getEventLocation(event),
+		getEventCategory(event)
+	};
+	size_t lengths[sizeof fields / sizeof fields[0]];
+
+	// Build the whole record in memory, so it is written with a single call.
+	size_t recordSize = sizeof(uint64_t);
+	for (size_t i = 0; i < sizeof fields / sizeof fields[0]; i++) {
+		lengths[i] = strlen(fields[i]);
+		recordSize += sizeof(uint32_t) + lengths[i] + 1;
+	}
+
+	unsigned char* record = newArray(recordSize, unsigned char);
+	size_t pos = 0;
+	for (size_t i = 0; i < sizeof fields / sizeof fields[0]; i++) {
+		PutUInt32(record + pos, (uint32_t) lengths[i]);
+		pos += sizeof(uint32_t);
+		memcpy(record + pos, fields[i], lengths[i] + 1);
+		pos += lengths[i] + 1;
+	}
+	PutUInt64(record + pos, (uint64_t) (int64_t) getEventTime(event));
+
+	*size = recordSize;
+	return record;
+}
+
+static uint32_t UpdateCrc(uint32_t crc, const unsigned char* data, size_t size) {
+	for (size_t i = 0; i < size; i++) {
+		crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	}
+	return crc;
+}
+
+static string ReadRecordString(FILE* filepoint) {
+	unsigned char buf[sizeof(uint32_t)];
+	if (fread(buf, 1, sizeof buf, filepoint) != sizeof buf) {
+		return NULL;
+	}
+
+	// A damaged length may be far larger than the rest of the file, so the string is grown only as
+	// its characters are actually read, and the record is torn if the file ends first. The capacity
+	// never passes the size, so the last string is exactly as long as the one in the file.
+	uint64_t size = (uint64_t) GetUInt32(buf) + 1;
+	size_t capacity = (size < RECORD_STRING_CHUNK) ? (size_t) size : RECORD_STRING_CHUNK;
+	string str = NewSharedStringOfLength(capacity - 1);
+	size_t read = 0;
+	while (true) {
+		read += fread(str + read, 1, capacity - read, filepoint);
+		if (read == size) {
+			break;
+		}
+		if (read < capacity) {
+			ReleaseSharedString(str);
+			return NULL;
+		}
+
+		size_t newCapacity = (size - capacity < capacity) ? (size_t) size : capacity * 2;
+		string newStr = NewSharedStringOfLength(newCapacity - 1);
+		memcpy(newStr, str, read);
+		ReleaseSharedString(str);
+		str = newStr;
+		capacity = newCapacity;
+	}
+	str[size - 1] = '\0';
+	return str;
+}
+
+static void ExpandWriterCapacity(EventFileWriter writer) {
+	uint32_t newCapacity = writer->capacity * 2;
+	uint64_t* offsets = newArray(newCapacity, uint64_t);
+	for (uint32_t i = 0; i < writer->count; i++) {
+		offsets[i] = writer->offsets[i];
+	}
+	freeBlock(writer->offsets);
+	writer->offsets = offsets;
+	writer->capacity = newCapacity;
+}
@@ -0,0 +1,217 @@
+﻿/**
+ * @file	EventFilter.c.
+ *
+ * @brief	Event filter implementation.
+ */
+
+#include "EventFilter.h"
+#include <stdlib.h>
+#include "cslib.h"
+#include "cmpfn.h"
+#include "strbuf.h"
+#include "vector.h"
+#include "Console.h"
+#include "Table.h"
+#include "EventPrefixIndex.h"
+#include "TextFold.h"
+
+/** @brief	The footer column that shows the filter. */
+#define FILTER_FOOTER_TEXT 2
+
+/**
+ * @struct	EventFilterCDT
+ *
+ * @brief	The event filter.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ */
+
+struct EventFilterCDT {
+	/** @brief	The filtered view. */
+	TableView source;
+	/** @brief	The events table. */
+	Table events;
+	/** @brief	The typed filter. */
+	StringBuffer text;
+	/** @brief	The prefix index of the events, NULL until the first character is typed. */
+	EventPrefixIndex index;
+	/** @brief	The view of the matching events. */
+	TableView view;
+	/** @brief	The footer of the filtered view. */
+	Vector footer;
+	/** @brief	The footer column that shows the filter. */
+	StringBuffer label;
+	/** @brief	The places of the events in the filtered view by their positions, -1 for the others. */
+	int* ranks;
+	/** @brief	True if the places are up to date. */
+	bool ranked;
+};
+
+static void ApplyFilter(EventFilter filter);
+static void RankRows(EventFilter filter);
+
+EventFilter NewEventFilter(TableView source) {
+	EventFilter filter = newBlock(EventFilter);
+	filter->source = source;
+	filter->events = GetTableTableView(source);
+	filter->text = newStringBuffer();
+	filter->index = NULL;
+
+	// The matching events are shown in the order of the filtered view, which they are found in.
+	filter->view = NewTableView(filter->events);
+	SetRowsTableView(filter->view, NULL, 0);
+	ClearSortKeysTableView(filter->view);
+
+	filter->footer = newVector();
+	addVector(filter->footer, "ESC: Poništi filter.");
+	addVector(filter->footer, "BACKSPACE: Briši znak.");
+	addVector(filter->footer, "");
+	filter->label = newStringBuffer();
+	SetFooterTableView(filter->view, filter->footer);
+	filter->ranks = NULL;
+	filter->ranked = false;
+	return filter;
+}
+
+void FreeEventFilter(EventFilter filter) {
+	if (filter->index != NULL) {
+		FreeEventPrefixIndex(filter->index);
+	}
+	if (filter->ranks != NULL) {
+		freeBlock(filter->ranks);
+	}
+	FreeTableView(filter->view);
+	freeVector(filter->footer);
+	freeStringBuffer(filter->label);
+	freeStringBuffer(filter->text);
+	freeBlock(filter);
+}
+
+bool IsActiveEventFilter(EventFilter filter) {
+	return !isEmptyStringBuffer(filter->text);
+}
+
+bool TypeEventFilter(EventFilter filter, char ch) {
+	// The filter does not start with a space, and the words are separated by a single one.
+	if (ch == ' ') {
+		string text = getString(filter->text);
+		int length = sizeStringBuffer(filter->text);
+		if (length == 0 || text[length - 1] == ' ') {
+			return false;
+		}
+	}
+	else if (!IsFoldedChar(ch)) {
+		return false;
+	}
+	pushChar(filter->text, ch);
+	ApplyFilter(filter);
+	return true;
+}
+
+bool EraseEventFilter(EventFilter filter) {
+	if (isEmptyStringBuffer(filter->text)) {
+		return false;
+	}
+	popChar(filter->text);
+	if (IsActiveEventFilter(filter)) {
+		ApplyFilter(filter);
+	}
+	return true;
+}
+
+int ClearEventFilter(EventFilter filter, int selection) {
+	if (!IsActiveEventFilter(filter)) {
+		return selection;
+	}
+	int row = GetRowEventFilter(filter, selection);
+	clearStringBuffer(filter->text);
+	if (row < 0) {
+		return 0;
+	}
+	if (IsWholeTableView(filter->source)) {
+		return row;
+	}
+	RankRows(filter);
+	return filter->ranks[row];
+}
+
+void RefreshEventFilter(EventFilter filter) {
+	if (filter->index != NULL) {
+		// The events could have been changed in place, which the index does not see by itself.
+		InvalidateEventPrefixIndex(filter->index);
+	}
+	filter->ranked = false;
+	if (IsActiveEventFilter(filter)) {
+		ApplyFilter(filter);
+	}
+}
+
+int GetRowEventFilter(EventFilter filter, int selection) {
+	TableView view = IsActiveEventFilter(filter) ? filter->view : filter->source;
+	return (selection >= 0 && selection < GetTotalTableView(view)) ? GetRowTableView(view, selection) : -1;
+}
+
+int MainEventFilter(EventFilter filter, int* selection, WORD* keyCode) {
+	if (!IsActiveEventFilter(filter)) {
+		return MainTableView(filter->source, selection, keyCode);
+	}
+	return MainTableView(filter->view, selection, keyCode);
+}
+
+// Private functions
+
+static void ApplyFilter(EventFilter filter) {
+	// The rows of the view are the positions in the table data, so the filtered view is sorted
+	// before they are found and stays that way while the view is shown.
+	SortTableView(filter->source);
+	if (filter->index == NULL) {
+		filter->index = NewEventPrefixIndex(GetDataTable(filter->events));
+	}
+
+	const int* rows;
+	int count = QueryEventPrefixIndex(filter->index, getString(filter->text), &rows);
+	if (IsWholeTableView(filter->source)) {
+		// The whole table is in the order of the positions, the same as the found events.
+		SetRowsTableView(filter->view, rows, count);
+	}
+	else {
+		// Only the found events of the filtered view are kept, sorted by their places in it.
+		RankRows(filter);
+		int* places = newArray(count > 0 ? count : 1, int);
+		int kept = 0;
+		for (int i = 0; i < count; i++) {
+			if (filter->ranks[rows[i]] >= 0) {
+				places[kept++] = filter->ranks[rows[i]];
+			}
+		}
+		qsort(places, kept, sizeof(int), intCmpFn);
+		for (int i = 0; i < kept; i++) {
+			places[i] = GetRowTableView(filter->source, places[i]);
+		}
+		SetRowsTableView(filter->view, places, kept);
+		freeBlock(places);
+	}
+
+	clearStringBuffer(filter->label);
+	sbprintf(filter->label, "Filter: %s", getString(filter->text));
+	setVector(filter->footer, FILTER_FOOTER_TEXT, getString(filter->label));
+}
+
+static void RankRows(EventFilter filter) {
+	if (filter->ranked) {
+		return;
+	}
+	if (filter->ranks != NULL) {
+		freeBlock(filter->ranks);
+	}
+	int n = GetTotalTable(filter->events);
+	filter->ranks = newArray(n > 0 ? n : 1, int);
+	for (int i = 0; i < n; i++) {
+		filter->ranks[i] = -1;
+	}
+	for (int i = 0; i < GetTotalTableView(filter->source); i++) {
+		filter->ranks[GetRowTableView(filter->source, i)] = i;
+	}
+	filter->ranked = true;
+}
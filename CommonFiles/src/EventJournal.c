@@ -0,0 +1,466 @@
+/**
+ * @file	EventJournal.c.
+ *
+ * @brief	Events journal implementation.
+ *
+ * Every record starts with a single byte that holds the record type and the sequence number of the
+ * record (32 bits, little endian), followed by the events in the same record layout the events data
+ * file uses. An insert and a delete record hold one event, an update record holds the old and then
+ * the new event values. The records written before the sequence numbers were introduced use the
+ * upper case record types and have no sequence number.
+ *
+ * The journal is kept open while the application runs, and every record is forced to the disk
+ * before the change is taken as done. The replay finds the deleted and the updated events through
+ * a hash table of the events by their times and names, which is built on the first such record.
+ */
+
+#include "EventJournal.h"
+#include <ctype.h>
+#include <stdint.h>
+#include "cslib.h"
+#include "strlib.h"
+#include "vector.h"
+#include "Event.h"
+#include "EventFile.h"
+#include "EventSaver.h"
+#include "utilities.h"
+#include "platform.h"
+
+/** @brief	The smallest capacity of the replay table, a power of two. */
+#define MIN_REPLAY_CAPACITY 64
+
+/**
+ * @enum	JOURNAL_RECORD
+ *
+ * @brief	Values that represent the journal record types.
+ */
+
+enum JOURNAL_RECORD {
+	///< An enum constant representing the inserted event record
+	JOURNAL_INSERT = 'I',
+	///< An enum constant representing the deleted event record
+	JOURNAL_DELETE = 'D',
+	///< An enum constant representing the updated event record
+	JOURNAL_UPDATE = 'U',
+	///< An enum constant representing the inserted event record with a sequence number
+	JOURNAL_SEQUENCED_INSERT = 'i',
+	///< An enum constant representing the deleted event record with a sequence number
+	JOURNAL_SEQUENCED_DELETE = 'd',
+	///< An enum constant representing the updated event record with a sequence number
+	JOURNAL_SEQUENCED_UPDATE = 'u'
+};
+
+/**
+ * @struct	ReplaySlot
+ *
+ * @brief	A slot of the replay table.
+ */
+
+typedef struct {
+	/** @brief	The event, or NULL if the slot is free. */
+	Event event;
+	/** @brief	The position of the event in the events vector, or -1 if the event was taken out. */
+	int index;
+	/** @brief	The hash of the event. */
+	uint32_t hash;
+} ReplaySlot;
+
+/**
+ * @struct	ReplayTable
+ *
+ * @brief	The open-addressing hash table of the events, used while the journal is replayed.
+ */
+
+typedef struct {
+	/** @brief	The slots. */
+	ReplaySlot* slots;
+	/** @brief	Number of the slots, a power of two. */
+	int capacity;
+	/** @brief	Number of the slots that are not free, including the taken out ones. */
+	int used;
+} *ReplayTable;
+
+/** @brief	The journal opened for appending, or NULL. */
+static FILE* journalFile = NULL;
+
+/** @brief	The name of the data file whose journal is open. */
+static string journalFileName = NULL;
+
+/** @brief	Number of records in the journal. */
+static int journalRecords = 0;
+
+/** @brief	Number of records since the events were last handed to the data file. */
+static int pendingRecords = 0;
+
+/** @brief	The sequence number of the last journal record. */
+static uint32_t journalSequence = 0;
+
+/** @brief	The autosave worker that writes the data file, or NULL to write it right away. */
+static EventSaver journalSaver = NULL;
+
+static FILE* OpenJournal(string fileName, const string mode);
+static FILE* GetJournalFile(string fileName);
+static void CloseJournalFile(void);
+static void AppendRecord(Vector events, string fileName, int type, Event first, Event second);
+static void TrimJournal(string fileName);
+static uint32_t ReadDataFileSequence(string fileName);
+static void WriteSequence(FILE* filepoint, uint32_t sequence);
+static bool ReadSequence(FILE* filepoint, uint32_t* sequence);
+static ReplayTable NewReplayTable(Vector events);
+static void FreeReplayTable(ReplayTable table);
+static void AddReplayEvent(ReplayTable table, Event event, int index);
+static int TakeReplayEvent(ReplayTable table, Event event);
+static uint32_t HashEvent(Event event);
+static void RemoveDeletedEvents(Vector events);
+
+string GetEventJournalName(string fileName) {
+	return concat(fileName, ".log");
+}
+
+void JournalEventInsert(Vector events, string fileName, Event event) {
+	AppendRecord(events, fileName, JOURNAL_SEQUENCED_INSERT, event, NULL);
+}
+
+void JournalEventDelete(Vector events, string fileName, Event event) {
+	AppendRecord(events, fileName, JOURNAL_SEQUENCED_DELETE, event, NULL);
+}
+
+void JournalEventUpdate(Vector events, string fileName, Event oldEvent, Event newEvent) {
+	AppendRecord(events, fileName, JOURNAL_SEQUENCED_UPDATE, oldEvent, newEvent);
+}
+
+int ReplayEventJournal(Vector events, string fileName) {
+	return ReplayEventJournalAfter(events, fileName, ReadDataFileSequence(fileName));
+}
+
+int ReplayEventJournalAfter(Vector events, string fileName, uint32_t folded) {
+	// The records up to the folded one were written into the data file before the journal was
+	// trimmed.
+	journalSequence = folded;
+	pendingRecords = 0;
+	CloseJournalFile();
+
+	FILE* filepoint = OpenJournal(fileName, "rb");
+	if (filepoint == NULL) {
+		// There were no changes since the last compaction.
+		journalRecords = 0;
+		return 0;
+	}
+
+	// The deleted events are left as NULL until the end, so the positions in the table stay valid.
+	ReplayTable table = NULL;
+	bool deleted = false;
+	int applied = 0;
+	int records = 0;
+	int type;
+	while ((type = fgetc(filepoint)) != EOF) {
+		uint32_t sequence = 0;
+		if (type == JOURNAL_SEQUENCED_INSERT || type == JOURNAL_SEQUENCED_DELETE || type == JOURNAL_SEQUENCED_UPDATE) {
+			if (!ReadSequence(filepoint, &sequence)) {
+				break;
+			}
+			type = toupper(type);
+		}
+		if (type != JOURNAL_INSERT && type != JOURNAL_DELETE && type != JOURNAL_UPDATE) {
+			// Unknown record, the rest of the journal can not be trusted.
+			break;
+		}
+		Event first = ReadEventRecord(filepoint);
+		Event second = (first != NULL && type == JOURNAL_UPDATE) ? ReadEventRecord(filepoint) : NULL;
+
+		// The application was interrupted while the last record was written.
+		if (first == NULL || (type == JOURNAL_UPDATE && second == NULL)) {
+			if (first != NULL) {
+				freeEvent(first);
+			}
+			break;
+		}
+		++records;
+		if (sequence > journalSequence) {
+			journalSequence = sequence;
+		}
+
+		// The data file already contains the record.
+		if (sequence != 0 && sequence <= folded) {
+			if (second != NULL) {
+				freeEvent(second);
+			}
+			freeEvent(first);
+			continue;
+		}
+
+		if (type == JOURNAL_INSERT) {
+			addVector(events, first);
+			if (table != NULL) {
+				AddReplayEvent(table, first, sizeVector(events) - 1);
+			}
+			++applied;
+			continue;
+		}
+
+		if (table == NULL) {
+			table = NewReplayTable(events);
+		}
+		int index = TakeReplayEvent(table, first);
+		if (index != -1) {
+			freeEvent(getVector(events, index));
+			if (type == JOURNAL_DELETE) {
+				setVector(events, index, NULL);
+				deleted = true;
+			}
+			else {
+				setVector(events, index, second);
+				AddReplayEvent(table, second, index);
+				second = NULL;
+			}
+			++applied;
+		}
+		if (second != NULL) {
+			freeEvent(second);
+		}
+		freeEvent(first);
+	}
+	fclose(filepoint);
+
+	if (table != NULL) {
+		FreeReplayTable(table);
+	}
+	if (deleted) {
+		RemoveDeletedEvents(events);
+	}
+	journalRecords = records;
+	return applied;
+}
+
+void ResetEventJournal(string fileName) {
+	CloseJournalFile();
+	string journalName = GetEventJournalName(fileName);
+	if (fileExists(journalName)) {
+		remove(journalName);
+	}
+	freeBlock(journalName);
+	journalRecords = 0;
+	pendingRecords = 0;
+}
+
+void CompactEventJournal(Vector events, string fileName) {
+	if (journalSaver != NULL) {
+		// The journal is trimmed once the worker has written the data file.
+		SaveEventsEventSaver(journalSaver, events, journalSequence);
+		pendingRecords = 0;
+	}
+	else {
+		// SaveEventsToFile resets the journal once the data file is written.
+		SaveEventsToFile(events, fileName);
+	}
+}
+
+uint32_t GetEventJournalSequence(void) {
+	return journalSequence;
+}
+
+void AttachEventJournalSaver(EventSaver saver) {
+	journalSaver = saver;
+}
+
+void DetachEventJournalSaver(void) {
+	journalSaver = NULL;
+}
+
+// Private functions
+
+static FILE* OpenJournal(string fileName, const string mode) {
+	string journalName = GetEventJournalName(fileName);
+	FILE* filepoint;
+	errno_t err = fopen_s(&filepoint, journalName, mode);
+	freeBlock(journalName);
+	return (err == 0) ? filepoint : NULL;
+}
+
+static FILE* GetJournalFile(string fileName) {
+	if (journalFile != NULL && !stringEqual(journalFileName, fileName)) {
+		CloseJournalFile();
+	}
+	if (journalFile == NULL) {
+		journalFile = OpenJournal(fileName, "ab");
+		if (journalFile != NULL) {
+			journalFileName = copyString(fileName);
+		}
+	}
+	return journalFile;
+}
+
+static void CloseJournalFile(void) {
+	if (journalFile != NULL) {
+		fclose(journalFile);
+		freeBlock(journalFileName);
+		journalFile = NULL;
+		journalFileName = NULL;
+	}
+}
+
+static void AppendRecord(Vector events, string fileName, int type, Event first, Event second) {
+	TrimJournal(fileName);
+
+	// The number is taken even if the record can not be written, so the snapshot that replaces the
+	// record is newer than the data file.
+	uint32_t sequence = ++journalSequence;
+	FILE* filepoint = GetJournalFile(fileName);
+	if (filepoint == NULL) {
+		// Journal is not available, fall back to rewriting the data file.
+		CompactEventJournal(events, fileName);
+		return;
+	}
+
+	// The change is done only once its record is on the disk.
+	fputc(type, filepoint);
+	WriteSequence(filepoint, sequence);
+	WriteEventRecord(filepoint, first);
+	if (second != NULL) {
+		WriteEventRecord(filepoint, second);
+	}
+	if (fflush(filepoint) != 0 || ferror(filepoint) || _commit(_fileno(filepoint)) != 0) {
+		CloseJournalFile();
+		CompactEventJournal(events, fileName);
+		return;
+	}
+
+	++journalRecords;
+	if (++pendingRecords >= JOURNAL_COMPACT_THRESHOLD) {
+		CompactEventJournal(events, fileName);
+	}
+}
+
+static void TrimJournal(string fileName) {
+	// The worker has written every record into the data file, so the journal can start over. Until
+	// then the records the data file already contains are skipped by their sequence numbers.
+	if (journalSaver != NULL && journalRecords > 0 && GetSavedSequenceEventSaver(journalSaver) == journalSequence) {
+		ResetEventJournal(fileName);
+	}
+}
+
+static uint32_t ReadDataFileSequence(string fileName) {
+	FILE* filepoint;
+	if (fopen_s(&filepoint, fileName, "rb") != 0) {
+		return 0;
+	}
+	uint32_t sequence = GetEventFileSequence(filepoint);
+	fclose(filepoint);
+	return sequence;
+}
+
+static void WriteSequence(FILE* filepoint, uint32_t sequence) {
+	for (int i = 0; i < 4; i++) {
+		fputc((sequence >> (8 * i)) & 0xFF, filepoint);
+	}
+}
+
+static bool ReadSequence(FILE* filepoint, uint32_t* sequence) {
+	*sequence = 0;
+	for (int i = 0; i < 4; i++) {
+		int byte = fgetc(filepoint);
+		if (byte == EOF) {
+			return false;
+		}
+		*sequence |= (uint32_t) byte << (8 * i);
+	}
+	return true;
+}
+
+static ReplayTable NewReplayTable(Vector events) {
+	int n = sizeVector(events);
+	ReplayTable table = newBlock(ReplayTable);
+	table->capacity = MIN_REPLAY_CAPACITY;
+	while (table->capacity < 2 * n) {
+		table->capacity *= 2;
+	}
+	table->slots = newArray(table->capacity, ReplaySlot);
+	for (int i = 0; i < table->capacity; i++) {
+		table->slots[i].event = NULL;
+		table->slots[i].index = 0;
+	}
+	table->used = 0;
+	for (int i = 0; i < n; i++) {
+		AddReplayEvent(table, getVector(events, i), i);
+	}
+	return table;
+}
+
+static void FreeReplayTable(ReplayTable table) {
+	freeBlock(table->slots);
+	freeBlock(table);
+}
+
+static void AddReplayEvent(ReplayTable table, Event event, int index) {
+	if ((table->used + 1) * 2 > table->capacity) {
+		// The taken out slots are dropped when the table is rehashed.
+		ReplaySlot* slots = table->slots;
+		int capacity = table->capacity;
+		table->capacity *= 2;
+		table->slots = newArray(table->capacity, ReplaySlot);
+		for (int i = 0; i < table->capacity; i++) {
+			table->slots[i].event = NULL;
+			table->slots[i].index = 0;
+		}
+		table->used = 0;
+		for (int i = 0; i < capacity; i++) {
+			if (slots[i].event != NULL) {
+				AddReplayEvent(table, slots[i].event, slots[i].index);
+			}
+		}
+		freeBlock(slots);
+	}
+
+	uint32_t hash = HashEvent(event);
+	int mask = table->capacity - 1;
+	int i = hash & mask;
+	while (table->slots[i].event != NULL) {
+		i = (i + 1) & mask;
+	}
+	table->slots[i].event = event;
+	table->slots[i].index = index;
+	table->slots[i].hash = hash;
+	table->used++;
+}
+
+static int TakeReplayEvent(ReplayTable table, Event event) {
+	uint32_t hash = HashEvent(event);
+	int mask = table->capacity - 1;
+	for (int i = hash & mask; table->slots[i].event != NULL || table->slots[i].index == -1; i = (i + 1) & mask) {
+		ReplaySlot* slot = &table->slots[i];
+		if (slot->event != NULL && slot->hash == hash && equalEvents(slot->event, event)) {
+			int index = slot->index;
+			slot->event = NULL;
+			slot->index = -1;
+			return index;
+		}
+	}
+	return -1;
+}
+
+static uint32_t HashEvent(Event event) {
+	// FNV-1a of the name, continued over the time.
+	uint32_t hash = 2166136261u;
+	for (string p = getEventName(event); *p != '\0'; p++) {
+		hash = (hash ^ (unsigned char) *p) * 16777619u;
+	}
+	uint64_t time = (uint64_t) (int64_t) getEventTime(event);
+	for (int i = 0; i < 8; i++) {
+		hash = (hash ^ (uint32_t) ((time >> (8 * i)) & 0xFF)) * 16777619u;
+	}
+	return hash;
+}
+
+static void RemoveDeletedEvents(Vector events) {
+	int n = sizeVector(events);
+	int kept = 0;
+	for (int i = 0; i < n; i++) {
+		Event event = getVector(events, i);
+		if (event != NULL) {
+			setVector(events, kept++, event);
+		}
+	}
+	while (n > kept) {
+		removeVector(events, --n);
+	}
+}
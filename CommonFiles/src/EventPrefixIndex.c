@@ -0,0 +1,317 @@
+/**
+ * @file	EventPrefixIndex.c.
+ *
+ * @brief	Event prefix index implementation.
+ *
+ * The result of the last query is kept together with the range of the entries that its last word
+ * has matched. A word that extends that word can only match the entries inside of the range, and
+ * every word of the new filter is checked only against the events of the last result.
+ */
+
+#include "EventPrefixIndex.h"
+#include <stdlib.h>
+#include <string.h>
+#include "cslib.h"
+#include "cmpfn.h"
+#include "strbuf.h"
+#include "strlib.h"
+#include "vector.h"
+#include "Event.h"
+#include "TextFold.h"
+
+/**
+ * @struct	Entry
+ *
+ * @brief	A word of an event.
+ */
+
+typedef struct {
+	string word;
+	int row;
+} *Entry;
+
+/**
+ * @struct	EventPrefixIndexCDT
+ *
+ * @brief	The event prefix index.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ */
+
+struct EventPrefixIndexCDT {
+	/** @brief	The events. */
+	Vector events;
+	/** @brief	The version of the events the index was built for. */
+	unsigned long version;
+	/** @brief	True if the index is built. */
+	bool built;
+	/** @brief	The entries, sorted by the words and then by the rows. */
+	Vector entries;
+	/** @brief	The marks of the rows, equal to the generation for the marked ones. */
+	int* marks;
+	/** @brief	The current generation of the marks. */
+	int generation;
+	/** @brief	The rows of the last result. */
+	int* rows;
+	/** @brief	Number of the rows of the last result. */
+	int count;
+	/** @brief	The words of the last filter, NULL if there is no last result. */
+	Vector words;
+	/** @brief	The entries the last word of the last filter has matched. */
+	int low, high;
+	/** @brief	Buffer for the words of the text. */
+	StringBuffer word;
+};
+
+/**
+ * @struct	EntryContext
+ *
+ * @brief	The arguments of the function that is called for the words of an event.
+ */
+
+typedef struct {
+	Vector entries;
+	int row;
+} EntryContext;
+
+static void RefreshIndex(EventPrefixIndex index);
+static void BuildIndex(EventPrefixIndex index);
+static void FreeEntries(EventPrefixIndex index);
+static void FreeWords(Vector words);
+static void AddEntry(string word, void* data);
+static void AddWord(string word, void* data);
+static int CompareEntries(const void* p1, const void* p2);
+static void FindPrefix(EventPrefixIndex index, string prefix, int* low, int* high);
+static void MatchPrefix(EventPrefixIndex index, int low, int high, bool all);
+static bool ExtendsWords(Vector words, Vector previous);
+
+EventPrefixIndex NewEventPrefixIndex(Vector events) {
+	EventPrefixIndex index = newBlock(EventPrefixIndex);
+	index->events = events;
+	index->version = 0;
+	index->built = false;
+	index->entries = newVector();
+	index->marks = NULL;
+	index->generation = 0;
+	index->rows = NULL;
+	index->count = 0;
+	index->words = NULL;
+	index->low = index->high = 0;
+	index->word = newStringBuffer();
+	return index;
+}
+
+void FreeEventPrefixIndex(EventPrefixIndex index) {
+	FreeEntries(index);
+	freeVector(index->entries);
+	freeStringBuffer(index->word);
+	freeBlock(index);
+}
+
+void InvalidateEventPrefixIndex(EventPrefixIndex index) {
+	index->built = false;
+}
+
+int QueryEventPrefixIndex(EventPrefixIndex index, string filter, const int** rows) {
+	RefreshIndex(index);
+
+	Vector words = newVector();
+	ForEachFoldedWord(index->word, filter, AddWord, words);
+
+	if (isEmptyVector(words)) {
+		index->count = sizeVector(index->events);
+		for (int i = 0; i < index->count; i++) {
+			index->rows[i] = i;
+		}
+		FreeWords(words);
+		FreeWords(index->words);
+		index->words = NULL;
+		*rows = index->rows;
+		return index->count;
+	}
+
+	// The words the previous filter has already checked are skipped, and the last of them is only
+	// looked for among the entries its shorter version has matched.
+	int first = 0;
+	bool all = true;
+	int low = 0, high = sizeVector(index->entries);
+	if (ExtendsWords(words, index->words)) {
+		first = sizeVector(index->words) - 1;
+		all = false;
+		low = index->low;
+		high = index->high;
+	}
+
+	for (int i = first; i < sizeVector(words); i++) {
+		if (i > first) {
+			low = 0;
+			high = sizeVector(index->entries);
+		}
+		string prefix = getVector(words, i);
+		FindPrefix(index, prefix, &low, &high);
+		MatchPrefix(index, low, high, all && i == first);
+		all = false;
+	}
+
+	FreeWords(index->words);
+	index->words = words;
+	index->low = low;
+	index->high = high;
+	*rows = index->rows;
+	return index->count;
+}
+
+// Private functions
+
+static void RefreshIndex(EventPrefixIndex index) {
+	if (!index->built || index->version != versionVector(index->events)) {
+		FreeEntries(index);
+		BuildIndex(index);
+		index->version = versionVector(index->events);
+		index->built = true;
+	}
+}
+
+static void BuildIndex(EventPrefixIndex index) {
+	int n = sizeVector(index->events);
+	EntryContext context = { index->entries, 0 };
+	for (int i = 0; i < n; i++) {
+		Event event = getVector(index->events, i);
+		context.row = i;
+		ForEachFoldedWord(index->word, getEventName(event), AddEntry, &context);
+		ForEachFoldedWord(index->word, getEventLocation(event), AddEntry, &context);
+	}
+	sortVector(index->entries, CompareEntries);
+
+	index->marks = newArray(n > 0 ? n : 1, int);
+	for (int i = 0; i < n; i++) {
+		index->marks[i] = 0;
+	}
+	index->generation = 0;
+	index->rows = newArray(n > 0 ? n : 1, int);
+	index->count = 0;
+}
+
+static void FreeEntries(EventPrefixIndex index) {
+	for (int i = 0; i < sizeVector(index->entries); i++) {
+		Entry entry = getVector(index->entries, i);
+		freeBlock(entry->word);
+		freeBlock(entry);
+	}
+	clearVector(index->entries);
+	if (index->marks != NULL) {
+		freeBlock(index->marks);
+		freeBlock(index->rows);
+		index->marks = NULL;
+		index->rows = NULL;
+	}
+	index->count = 0;
+	FreeWords(index->words);
+	index->words = NULL;
+	index->built = false;
+}
+
+static void FreeWords(Vector words) {
+	if (words == NULL) {
+		return;
+	}
+	for (int i = 0; i < sizeVector(words); i++) {
+		freeBlock(getVector(words, i));
+	}
+	freeVector(words);
+}
+
+static void AddEntry(string word, void* data) {
+	EntryContext* context = data;
+	Entry entry = newBlock(Entry);
+	entry->word = copyString(word);
+	entry->row = context->row;
+	addVector(context->entries, entry);
+}
+
+static void AddWord(string word, void* data) {
+	addVector((Vector) data, copyString(word));
+}
+
+static int CompareEntries(const void* p1, const void* p2) {
+	Entry first = (Entry) p1;
+	Entry second = (Entry) p2;
+	int result = strcmp(first->word, second->word);
+	if (result != 0) {
+		return result;
+	}
+	return (first->row < second->row) ? -1 : (first->row > second->row);
+}
+
+static void FindPrefix(EventPrefixIndex index, string prefix, int* low, int* high) {
+	int length = stringLength(prefix);
+
+	// The first word that is not before the prefix.
+	int begin = *low, end = *high;
+	while (begin < end) {
+		int middle = begin + (end - begin) / 2;
+		if (strcmp(((Entry) getVector(index->entries, middle))->word, prefix) < 0) {
+			begin = middle + 1;
+		}
+		else {
+			end = middle;
+		}
+	}
+	*low = begin;
+
+	// The first word after it that does not start with the prefix.
+	end = *high;
+	while (begin < end) {
+		int middle = begin + (end - begin) / 2;
+		if (strncmp(((Entry) getVector(index->entries, middle))->word, prefix, length) <= 0) {
+			begin = middle + 1;
+		}
+		else {
+			end = middle;
+		}
+	}
+	*high = begin;
+}
+
+static void MatchPrefix(EventPrefixIndex index, int low, int high, bool all) {
+	int generation = ++index->generation;
+	if (all) {
+		// The result is made of the rows of the entries, every row once.
+		index->count = 0;
+		for (int i = low; i < high; i++) {
+			int row = ((Entry) getVector(index->entries, i))->row;
+			if (index->marks[row] != generation) {
+				index->marks[row] = generation;
+				index->rows[index->count++] = row;
+			}
+		}
+		qsort(index->rows, index->count, sizeof(int), intCmpFn);
+		return;
+	}
+
+	// The rows of the last result keep their order, only the unmarked ones are dropped.
+	for (int i = low; i < high; i++) {
+		index->marks[((Entry) getVector(index->entries, i))->row] = generation;
+	}
+	int count = 0;
+	for (int i = 0; i < index->count; i++) {
+		if (index->marks[index->rows[i]] == generation) {
+			index->rows[count++] = index->rows[i];
+		}
+	}
+	index->count = count;
+}
+
+static bool ExtendsWords(Vector words, Vector previous) {
+	if (previous == NULL || sizeVector(words) < sizeVector(previous)) {
+		return false;
+	}
+	int last = sizeVector(previous) - 1;
+	for (int i = 0; i < last; i++) {
+		if (!stringEqual(getVector(words, i), getVector(previous, i))) {
+			return false;
+		}
+	}
+	return startsWith(getVector(words, last), getVector(previous, last));
+}
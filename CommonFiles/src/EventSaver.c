@@ -0,0 +1,306 @@
+/**
+ * @file	EventSaver.c.
+ *
+ * @brief	Autosave worker implementation.
+ *
+ * The queue is a ring of snapshot pointers with two counters: the user interface thread is the only
+ * one that advances the tail and the worker is the only one that advances the head. A snapshot is
+ * stored into its slot before the tail is advanced with a release store, and the worker reads the
+ * tail with an acquire load, so it never sees a slot before the snapshot in it. A semaphore wakes
+ * the worker up when there is something to write.
+ *
+ * The user interface thread only copies the events, which takes references to their strings (see
+ * SharedString.c). The snapshot belongs to the worker from then on, so the worker sorts it into the
+ * data file order itself. It touches no other shared state besides the queue: the category names
+ * of the events come from the category symbol table, whose names never move (see EventCategory.c).
+ */
+
+#include "EventSaver.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#endif
+#include <limits.h>
+#include <stdio.h>
+#include "cslib.h"
+#include "strlib.h"
+#include "vector.h"
+#include "Event.h"
+#include "EventCategory.h"
+#include "EventFile.h"
+#include "AtomicFile.h"
+#include "Trace.h"
+#include "utilities.h"
+#include "platform.h"
+
+/** @brief	Number of the slots in the queue. */
+#define SAVER_QUEUE_SIZE 16
+
+#ifdef _WIN32
+#define LoadAcquire(p) InterlockedCompareExchange((p), 0, 0)
+#define StoreRelease(p, value) InterlockedExchange((p), (value))
+#else
+#define LoadAcquire(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define StoreRelease(p, value) __atomic_store_n((p), (value), __ATOMIC_RELEASE)
+#endif
+
+/**
+ * @struct	Snapshot
+ *
+ * @brief	A copy of the events or of the categories, waiting to be written.
+ */
+
+typedef struct {
+	/** @brief	The copied events in the data file order, or NULL. */
+	Vector events;
+	/** @brief	The copied categories in the data file order, or NULL. */
+	Vector categories;
+	/** @brief	The sequence number of the last journal record the events contain. */
+	uint32_t sequence;
+} *Snapshot;
+
+/**
+ * @struct	EventSaverCDT
+ *
+ * @brief	The autosave worker.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ */
+
+struct EventSaverCDT {
+	string eventsFileName;
+	string categoriesFileName;
+	/** @brief	The queued snapshots. */
+	Snapshot queue[SAVER_QUEUE_SIZE];
+	/** @brief	Number of the snapshots taken from the queue, advanced by the worker. */
+	volatile long head;
+	/** @brief	Number of the snapshots put into the queue, advanced by the user interface. */
+	volatile long tail;
+	/** @brief	The sequence number of the newest events snapshot in the data file. */
+	volatile long savedSequence;
+	/** @brief	Set when the worker has to stop once the queue is empty. */
+	volatile long stopping;
+	/** @brief	Set when a data file could not be written. */
+	volatile long failed;
+#ifdef _WIN32
+	HANDLE thread;
+	HANDLE ready;
+#else
+	pthread_t thread;
+	sem_t ready;
+#endif
+};
+
+static void Publish(EventSaver saver, Snapshot snapshot);
+static void RunWorker(EventSaver saver);
+static bool WriteEvents(EventSaver saver, Snapshot snapshot);
+static bool WriteCategories(EventSaver saver, Snapshot snapshot);
+static void FreeSnapshot(Snapshot snapshot);
+#ifdef _WIN32
+static DWORD WINAPI WorkerThread(LPVOID data);
+#else
+static void* WorkerThread(void* data);
+#endif
+
+EventSaver NewEventSaver(string eventsFileName, string categoriesFileName) {
+	EventSaver saver = newBlock(EventSaver);
+	saver->eventsFileName = copyString(eventsFileName);
+	saver->categoriesFileName = copyString(categoriesFileName);
+	saver->head = 0;
+	saver->tail = 0;
+	saver->savedSequence = 0;
+	saver->stopping = 0;
+	saver->failed = 0;
+#ifdef _WIN32
+	saver->ready = CreateSemaphoreA(NULL, 0, LONG_MAX, NULL);
+	saver->thread = CreateThread(NULL, 0, WorkerThread, saver, 0, NULL);
+	if (saver->ready == NULL || saver->thread == NULL) {
+		error("NewEventSaver: The worker could not be started");
+	}
+#else
+	if (sem_init(&saver->ready, 0, 0) != 0 || pthread_create(&saver->thread, NULL, WorkerThread, saver) != 0) {
+		error("NewEventSaver: The worker could not be started");
+	}
+#endif
+	return saver;
+}
+
+void SaveEventsEventSaver(EventSaver saver, Vector events, uint32_t sequence) {
+	Snapshot snapshot = newBlock(Snapshot);
+	snapshot->events = newVector();
+	snapshot->categories = NULL;
+	snapshot->sequence = sequence;
+	for (int i = 0; i < sizeVector(events); i++) {
+		addVector(snapshot->events, cloneEvent(getVector(events, i)));
+	}
+	Publish(saver, snapshot);
+}
+
+void SaveCategoriesEventSaver(EventSaver saver, Vector categories) {
+	Snapshot snapshot = newBlock(Snapshot);
+	snapshot->events = NULL;
+	snapshot->categories = newVector();
+	snapshot->sequence = 0;
+	for (int i = 0; i < sizeVector(categories); i++) {
+		// The names are never freed, so the copies share them.
+		EventCategory category = newEventCategory();
+		setEventCategoryName(category, getEventCategoryName(getVector(categories, i)));
+		addVector(snapshot->categories, category);
+	}
+	sortVector(snapshot->categories, CompareEventCategoryName);
+	Publish(saver, snapshot);
+}
+
+uint32_t GetSavedSequenceEventSaver(EventSaver saver) {
+	return (uint32_t) LoadAcquire(&saver->savedSequence);
+}
+
+bool CloseEventSaver(EventSaver saver) {
+	// Everything is queued before the flag is set, so the worker sees it all before it stops.
+	StoreRelease(&saver->stopping, 1);
+#ifdef _WIN32
+	ReleaseSemaphore(saver->ready, 1, NULL);
+	WaitForSingleObject(saver->thread, INFINITE);
+	CloseHandle(saver->thread);
+	CloseHandle(saver->ready);
+#else
+	sem_post(&saver->ready);
+	pthread_join(saver->thread, NULL);
+	sem_destroy(&saver->ready);
+#endif
+
+	bool saved = !saver->failed;
+	freeBlock(saver->eventsFileName);
+	freeBlock(saver->categoriesFileName);
+	freeBlock(saver);
+	return saved;
+}
+
+// Private functions
+
+static void Publish(EventSaver saver, Snapshot snapshot) {
+	long tail = saver->tail;
+
+	// A full queue means the worker is far behind, so there is nothing better to do than to wait.
+	while (tail - LoadAcquire(&saver->head) == SAVER_QUEUE_SIZE) {
+#ifdef _WIN32
+		Sleep(1);
+#else
+		sched_yield();
+#endif
+	}
+	saver->queue[tail % SAVER_QUEUE_SIZE] = snapshot;
+	StoreRelease(&saver->tail, tail + 1);
+#ifdef _WIN32
+	ReleaseSemaphore(saver->ready, 1, NULL);
+#else
+	sem_post(&saver->ready);
+#endif
+}
+
+static void RunWorker(EventSaver saver) {
+	NameTraceThread("EventSaver");
+	bool stopping = false;
+	while (!stopping) {
+#ifdef _WIN32
+		WaitForSingleObject(saver->ready, INFINITE);
+#else
+		while (sem_wait(&saver->ready) != 0) {
+			// Interrupted by a signal.
+		}
+#endif
+		stopping = LoadAcquire(&saver->stopping) != 0;
+
+		// The snapshots queued while the previous ones were written are folded into one write.
+		Snapshot events = NULL;
+		Snapshot categories = NULL;
+		long head = saver->head;
+		while (head != LoadAcquire(&saver->tail)) {
+			Snapshot snapshot = saver->queue[head % SAVER_QUEUE_SIZE];
+			StoreRelease(&saver->head, ++head);
+			Snapshot* newest = (snapshot->events != NULL) ? &events : &categories;
+			if (*newest != NULL) {
+				FreeSnapshot(*newest);
+			}
+			*newest = snapshot;
+		}
+
+		if (events != NULL) {
+			if (WriteEvents(saver, events)) {
+				StoreRelease(&saver->savedSequence, (long) events->sequence);
+			}
+			else {
+				StoreRelease(&saver->failed, 1);
+			}
+			FreeSnapshot(events);
+		}
+		if (categories != NULL) {
+			if (!WriteCategories(saver, categories)) {
+				StoreRelease(&saver->failed, 1);
+			}
+			FreeSnapshot(categories);
+		}
+	}
+}
+
+static bool WriteEvents(EventSaver saver, Snapshot snapshot) {
+	FILE* filepoint = OpenAtomicFile(saver->eventsFileName);
+	if (filepoint == NULL) {
+		return false;
+	}
+	TraceSpan span = BeginTraceSpan("WriteEvents");
+
+	// The same order SaveEventsToFile writes the events in.
+	SortKey keys[] = {
+		{ CompareEventTimesDescending, SORT_ASCENDING },
+		{ CompareEventNames, SORT_ASCENDING }
+	};
+	sortVectorByKeys(snapshot->events, keys, sizeof keys / sizeof keys[0]);
+	WriteEventFile(filepoint, snapshot->events, snapshot->sequence);
+	bool committed = CommitAtomicFile(filepoint, saver->eventsFileName);
+	EndTraceSpan(span);
+	return committed;
+}
+
+static bool WriteCategories(EventSaver saver, Snapshot snapshot) {
+	FILE* filepoint = OpenAtomicFile(saver->categoriesFileName);
+	if (filepoint == NULL) {
+		return false;
+	}
+	size_t count = sizeVector(snapshot->categories);
+	fwrite(&count, sizeof count, 1, filepoint);
+	for (size_t i = 0; i < count; i++) {
+		WriteCategoryToFile(filepoint, getVector(snapshot->categories, (int) i));
+	}
+	return CommitAtomicFile(filepoint, saver->categoriesFileName);
+}
+
+static void FreeSnapshot(Snapshot snapshot) {
+	Vector items = (snapshot->events != NULL) ? snapshot->events : snapshot->categories;
+	for (int i = 0; i < sizeVector(items); i++) {
+		if (snapshot->events != NULL) {
+			freeEvent(getVector(items, i));
+		}
+		else {
+			freeEventCategory(getVector(items, i));
+		}
+	}
+	freeVector(items);
+	freeBlock(snapshot);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI WorkerThread(LPVOID data) {
+	RunWorker(data);
+	return 0;
+}
+#else
+static void* WorkerThread(void* data) {
+	RunWorker(data);
+	return NULL;
+}
+#endif
@@ -0,0 +1,346 @@
+/**
+ * @file	EventSearch.c.
+ *
+ * @brief	Event search implementation.
+ *
+ * Every event gets a document number when it is added. The posting list of a word holds the
+ * document numbers of the events with the word, in the ascending order, so the events that hold all
+ * query words are found by walking the shortest list and looking the others up with a binary
+ * search.
+ */
+
+#include "EventSearch.h"
+#include <math.h>
+#include "cslib.h"
+#include "strbuf.h"
+#include "strlib.h"
+#include "map.h"
+#include "vector.h"
+#include "Event.h"
+#include "TextFold.h"
+
+/** @brief	The weight of a word in the event name. */
+#define NAME_WEIGHT 3
+
+/** @brief	The weight of a word in the event location. */
+#define LOCATION_WEIGHT 2
+
+/** @brief	The weight of a word in the event description. */
+#define DESCRIPTION_WEIGHT 1
+
+/**
+ * @struct	Posting
+ *
+ * @brief	An event that holds a word.
+ */
+
+typedef struct {
+	int document;
+	int weight;
+} *Posting;
+
+/**
+ * @struct	Term
+ *
+ * @brief	A word and the events that hold it.
+ */
+
+typedef struct {
+	string word;
+	Vector postings;
+} *Term;
+
+/**
+ * @struct	Hit
+ *
+ * @brief	An event that matches the query.
+ */
+
+typedef struct {
+	int document;
+	double score;
+} *Hit;
+
+/**
+ * @struct	EventSearchCDT
+ *
+ * @brief	The event search index.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ */
+
+struct EventSearchCDT {
+	/** @brief	The terms by the words. */
+	Map terms;
+	/** @brief	All terms, for freeing them. */
+	Vector termList;
+	/** @brief	The events by the document numbers, NULL for the removed ones. */
+	Vector documents;
+	/** @brief	Number of the events in the index. */
+	int count;
+	/** @brief	Buffer for the words of the text. */
+	StringBuffer word;
+};
+
+/**
+ * @struct	WordContext
+ *
+ * @brief	The arguments of the posting functions that are called for the words of an event.
+ */
+
+typedef struct {
+	EventSearch search;
+	int document;
+	int weight;
+} WordContext;
+
+/**
+ * @struct	QueryContext
+ *
+ * @brief	The arguments of the function that is called for the words of a query.
+ */
+
+typedef struct {
+	EventSearch search;
+	Vector terms;
+} QueryContext;
+
+static void ForEachEventWord(EventSearch search, Event event, int document, FoldedWordFn fn);
+static void AddPosting(string word, void* data);
+static void RemovePosting(string word, void* data);
+static void AddQueryTerm(string word, void* data);
+static int FindPosting(Vector postings, int document);
+static int FindDocument(EventSearch search, Event event);
+static int CompareHits(const void* p1, const void* p2);
+
+EventSearch NewEventSearch(Vector events) {
+	EventSearch search = newBlock(EventSearch);
+	search->terms = newMapOfType(HASH_MAP);
+	search->termList = newVector();
+	search->documents = newVector();
+	search->count = 0;
+	search->word = newStringBuffer();
+	for (int i = 0; i < sizeVector(events); i++) {
+		InsertEventSearch(search, getVector(events, i));
+	}
+	return search;
+}
+
+void FreeEventSearch(EventSearch search) {
+	for (int i = 0; i < sizeVector(search->termList); i++) {
+		Term term = getVector(search->termList, i);
+		for (int j = 0; j < sizeVector(term->postings); j++) {
+			freeBlock(getVector(term->postings, j));
+		}
+		freeVector(term->postings);
+		freeBlock(term->word);
+		freeBlock(term);
+	}
+	freeVector(search->termList);
+	freeMap(search->terms);
+	freeVector(search->documents);
+	freeStringBuffer(search->word);
+	freeBlock(search);
+}
+
+void InsertEventSearch(EventSearch search, Event event) {
+	int document = sizeVector(search->documents);
+	addVector(search->documents, event);
+	search->count++;
+	ForEachEventWord(search, event, document, AddPosting);
+}
+
+void DeleteEventSearch(EventSearch search, Event event) {
+	int document = FindDocument(search, event);
+	if (document < 0) {
+		return;
+	}
+	ForEachEventWord(search, event, document, RemovePosting);
+	setVector(search->documents, document, NULL);
+	search->count--;
+}
+
+void UpdateEventSearch(EventSearch search, Event oldEvent, Event event) {
+	int document = FindDocument(search, event);
+	if (document < 0) {
+		return;
+	}
+	ForEachEventWord(search, oldEvent, document, RemovePosting);
+	ForEachEventWord(search, event, document, AddPosting);
+}
+
+Vector QueryEventSearch(EventSearch search, string query) {
+	Vector events = newVector();
+
+	// The terms of the query words, NULL for a word that no event holds.
+	QueryContext context = { search, newVector() };
+	ForEachFoldedWord(search->word, query, AddQueryTerm, &context);
+	Vector terms = context.terms;
+
+	int shortest = -1;
+	for (int i = 0; i < sizeVector(terms); i++) {
+		Term term = getVector(terms, i);
+		if (term == NULL || isEmptyVector(term->postings)) {
+			freeVector(terms);
+			return events;
+		}
+		if (shortest < 0 || sizeVector(term->postings) < sizeVector(((Term) getVector(terms, shortest))->postings)) {
+			shortest = i;
+		}
+	}
+	if (shortest < 0) {
+		freeVector(terms);
+		return events;
+	}
+
+	// Every event of the shortest list is looked up in the other lists.
+	Vector hits = newVector();
+	Vector candidates = ((Term) getVector(terms, shortest))->postings;
+	for (int i = 0; i < sizeVector(candidates); i++) {
+		Posting candidate = getVector(candidates, i);
+		double score = 0;
+		bool found = true;
+		for (int j = 0; j < sizeVector(terms) && found; j++) {
+			Term term = getVector(terms, j);
+			int position = (j == shortest) ? i : FindPosting(term->postings, candidate->document);
+			if (position < 0) {
+				found = false;
+			}
+			else {
+				Posting posting = getVector(term->postings, position);
+				double idf = log(1.0 + (double) search->count / sizeVector(term->postings));
+				score += posting->weight * idf;
+			}
+		}
+		if (found) {
+			Hit hit = newBlock(Hit);
+			hit->document = candidate->document;
+			hit->score = score;
+			addVector(hits, hit);
+		}
+	}
+
+	sortVector(hits, CompareHits);
+	for (int i = 0; i < sizeVector(hits); i++) {
+		Hit hit = getVector(hits, i);
+		addVector(events, getVector(search->documents, hit->document));
+		freeBlock(hit);
+	}
+	freeVector(hits);
+	freeVector(terms);
+	return events;
+}
+
+// Private functions
+
+static void ForEachEventWord(EventSearch search, Event event, int document, FoldedWordFn fn) {
+	WordContext context = { search, document, NAME_WEIGHT };
+	ForEachFoldedWord(search->word, getEventName(event), fn, &context);
+	context.weight = LOCATION_WEIGHT;
+	ForEachFoldedWord(search->word, getEventLocation(event), fn, &context);
+	context.weight = DESCRIPTION_WEIGHT;
+	ForEachFoldedWord(search->word, getEventDescription(event), fn, &context);
+}
+
+static void AddPosting(string word, void* data) {
+	WordContext* context = data;
+	Term term = getMap(context->search->terms, word);
+	if (term == NULL) {
+		// The map and the term share the copy of the word.
+		term = newBlock(Term);
+		term->word = copyString(word);
+		term->postings = newVector();
+		putMap(context->search->terms, term->word, term);
+		addVector(context->search->termList, term);
+	}
+
+	// The new events have the highest document numbers, so they are usually added at the end.
+	Vector postings = term->postings;
+	int count = sizeVector(postings);
+	Posting last = (count > 0) ? getVector(postings, count - 1) : NULL;
+	if (last != NULL && last->document == context->document) {
+		last->weight += context->weight;
+		return;
+	}
+	int position = count;
+	if (last != NULL && last->document > context->document) {
+		int found = FindPosting(postings, context->document);
+		if (found >= 0) {
+			((Posting) getVector(postings, found))->weight += context->weight;
+			return;
+		}
+		position = 0;
+		while (((Posting) getVector(postings, position))->document < context->document) {
+			position++;
+		}
+	}
+
+	Posting posting = newBlock(Posting);
+	posting->document = context->document;
+	posting->weight = context->weight;
+	insert(postings, position, posting);
+}
+
+static void RemovePosting(string word, void* data) {
+	WordContext* context = data;
+	Term term = getMap(context->search->terms, word);
+	if (term == NULL) {
+		return;
+	}
+	int position = FindPosting(term->postings, context->document);
+	if (position >= 0) {
+		// A word that is repeated in the event has a single posting.
+		freeBlock(getVector(term->postings, position));
+		removeVector(term->postings, position);
+	}
+}
+
+static void AddQueryTerm(string word, void* data) {
+	QueryContext* context = data;
+	Term term = getMap(context->search->terms, word);
+
+	// A repeated word counts once.
+	for (int i = 0; term != NULL && i < sizeVector(context->terms); i++) {
+		if (getVector(context->terms, i) == term) {
+			return;
+		}
+	}
+	addVector(context->terms, term);
+}
+
+static int FindPosting(Vector postings, int document) {
+	int low = 0, high = sizeVector(postings) - 1;
+	while (low <= high) {
+		int middle = low + (high - low) / 2;
+		int current = ((Posting) getVector(postings, middle))->document;
+		if (current == document) {
+			return middle;
+		}
+		if (current < document) {
+			low = middle + 1;
+		}
+		else {
+			high = middle - 1;
+		}
+	}
+	return -1;
+}
+
+static int FindDocument(EventSearch search, Event event) {
+	for (int i = sizeVector(search->documents) - 1; i >= 0; i--) {
+		if (getVector(search->documents, i) == event) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+static int CompareHits(const void* p1, const void* p2) {
+	Hit first = (Hit) p1;
+	Hit second = (Hit) p2;
+	if (first->score != second->score) {
+		return (first->score > second->score) ? -1 : +1;
+	}
+	return (first->document < second->document) ? -1 : (first->document > second->document);
+}
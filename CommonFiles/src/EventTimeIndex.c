@@ -0,0 +1,198 @@
+/**
+ * @file	EventTimeIndex.c.
+ *
+ * @brief	Event time index implementation.
+ *
+ * The events data file keeps the events sorted by their times, newest first, so the index is
+ * usually built by reversing the events. The events added by the journal are the only ones out of
+ * place, and the full sort is done only for them.
+ */
+
+#include "EventTimeIndex.h"
+#include <stdlib.h>
+#include "cslib.h"
+#include "vector.h"
+#include "Event.h"
+#include "platform.h"
+
+/**
+ * @struct	EventTimeEntry
+ *
+ * @brief	The time of an event and its position in the events vector.
+ */
+
+typedef struct {
+	time_t time;
+	int row;
+} EventTimeEntry;
+
+/**
+ * @struct	EventTimeIndexCDT
+ *
+ * @brief	The event time index.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ */
+
+struct EventTimeIndexCDT {
+	Vector events;
+	unsigned long version;
+	bool built;
+	int* rows;
+	time_t* times;
+	int count;
+};
+
+static void RefreshIndex(EventTimeIndex index);
+static void BuildIndex(EventTimeIndex index);
+static void FreeEntries(EventTimeIndex index);
+static int CompareEntries(const void* p1, const void* p2);
+static time_t GetStartOfDay(time_t time, int days);
+
+EventTimeIndex NewEventTimeIndex(Vector events) {
+	EventTimeIndex index = newBlock(EventTimeIndex);
+	index->events = events;
+	index->version = 0;
+	index->built = false;
+	index->rows = NULL;
+	index->times = NULL;
+	index->count = 0;
+	return index;
+}
+
+void FreeEventTimeIndex(EventTimeIndex index) {
+	FreeEntries(index);
+	freeBlock(index);
+}
+
+int SizeEventTimeIndex(EventTimeIndex index) {
+	RefreshIndex(index);
+	return index->count;
+}
+
+int LowerBoundEventTimeIndex(EventTimeIndex index, time_t time) {
+	RefreshIndex(index);
+	int low = 0, high = index->count;
+	while (low < high) {
+		int middle = low + (high - low) / 2;
+		if (index->times[middle] < time) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+int UpperBoundEventTimeIndex(EventTimeIndex index, time_t time) {
+	RefreshIndex(index);
+	int low = 0, high = index->count;
+	while (low < high) {
+		int middle = low + (high - low) / 2;
+		if (index->times[middle] <= time) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+int SliceEventTimeIndex(EventTimeIndex index, int begin, int end, const int** rows) {
+	RefreshIndex(index);
+	if (begin < 0) begin = 0;
+	if (end > index->count) end = index->count;
+	if (end < begin) end = begin;
+
+	*rows = index->rows + begin;
+	return end - begin;
+}
+
+int GetDayEventTimeIndex(EventTimeIndex index, time_t time, const int** rows) {
+	int begin = LowerBoundEventTimeIndex(index, GetStartOfDay(time, 0));
+	int end = LowerBoundEventTimeIndex(index, GetStartOfDay(time, 1));
+	return SliceEventTimeIndex(index, begin, end, rows);
+}
+
+// Private functions
+
+static void RefreshIndex(EventTimeIndex index) {
+	if (!index->built || index->version != versionVector(index->events)) {
+		FreeEntries(index);
+		BuildIndex(index);
+		index->version = versionVector(index->events);
+		index->built = true;
+	}
+}
+
+static void BuildIndex(EventTimeIndex index) {
+	int n = sizeVector(index->events);
+	bool ascending = true, descending = true;
+	for (int i = 1; i < n && (ascending || descending); i++) {
+		time_t previous = getEventTime(getVector(index->events, i - 1));
+		time_t current = getEventTime(getVector(index->events, i));
+		if (previous > current) ascending = false;
+		if (previous < current) descending = false;
+	}
+
+	index->count = n;
+	index->rows = newArray(n > 0 ? n : 1, int);
+	index->times = newArray(n > 0 ? n : 1, time_t);
+	if (ascending || descending) {
+		for (int i = 0; i < n; i++) {
+			index->rows[i] = descending ? n - 1 - i : i;
+			index->times[i] = getEventTime(getVector(index->events, index->rows[i]));
+		}
+	}
+	else {
+		// The positions are sorted together with the times, the earlier position first on a tie.
+		EventTimeEntry* entries = newArray(n, EventTimeEntry);
+		for (int i = 0; i < n; i++) {
+			entries[i].time = getEventTime(getVector(index->events, i));
+			entries[i].row = i;
+		}
+		qsort(entries, n, sizeof(EventTimeEntry), CompareEntries);
+		for (int i = 0; i < n; i++) {
+			index->rows[i] = entries[i].row;
+			index->times[i] = entries[i].time;
+		}
+		freeBlock(entries);
+	}
+}
+
+static void FreeEntries(EventTimeIndex index) {
+	if (index->rows != NULL) {
+		freeBlock(index->rows);
+		freeBlock(index->times);
+		index->rows = NULL;
+		index->times = NULL;
+	}
+	index->count = 0;
+	index->built = false;
+}
+
+static int CompareEntries(const void* p1, const void* p2) {
+	const EventTimeEntry* first = (const EventTimeEntry*) p1;
+	const EventTimeEntry* second = (const EventTimeEntry*) p2;
+	if (first->time != second->time) {
+		return (first->time < second->time) ? -1 : +1;
+	}
+	return (first->row < second->row) ? -1 : (first->row > second->row);
+}
+
+static time_t GetStartOfDay(time_t time, int days) {
+	struct tm day;
+	if (localtime_s(&day, &time) != 0) {
+		return time;
+	}
+
+	// The midnight is found by the library, so the days that are shorter or longer because of the
+	// daylight saving time change are handled as well.
+	day.tm_mday += days;
+	day.tm_hour = day.tm_min = day.tm_sec = 0;
+	day.tm_isdst = -1;
+	return mktime(&day);
+}
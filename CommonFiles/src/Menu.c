@@ -1,12 +1,9 @@
 #include "Menu.h"
 #include "cslib.h"
 #include "vector.h"
-#include <Windows.h>
 #include "utilities.h"
-
-// Extern variables.
-extern HANDLE hStdout;
-extern HANDLE hStdin;
+#include "Screen.h"
+#include "Console.h"
 
 struct MenuCDT {
 	Vector options;
@@ -29,6 +26,12 @@ Menu newMenu(void) {
 	return m;
 }
 
+void freeMenu(Menu menu) {
+	// The option strings belong to the caller.
+	freeVector(menu->options);
+	freeBlock(menu);
+}
+
 void addMenu(Menu menu, string option) {
 	addVector(menu->options, option);
 }
@@ -64,15 +67,9 @@ int centerMenu(Menu menu) {
 	int startX, windowSizeX;
 	int startY, windowSizeY;
 
-	CONSOLE_SCREEN_BUFFER_INFO csbi;
-	COORD sizeConsole;
-
 	// Get the screen buffer size. 
 
-	if (!GetConsoleScreenBufferInfo(hStdout, &csbi)) {
-		return 0;
-	}
-	sizeConsole = csbi.dwSize;
+	COORD sizeConsole = GetSizeConsole();
 	windowSizeX = sizeConsole.X;
 	windowSizeY = sizeConsole.Y;
 
@@ -134,90 +131,39 @@ int drawMenu(Menu menu, int currentSelection) {
 	const int totalMenu = getTotalMenu(menu);
 	const int startX = getPosX(menu);
 	const int startY = getPosY(menu);
+	Screen screen = GetScreen();
+	WORD wAttributes = GetAttributesScreen(screen);
+
+	// The lines of the menu are cleared, the rest of the console is left as it is.
+	BeginScreen(screen);
+	FillScreen(screen, 0, startY, GetWidthScreen(screen), totalMenu + 1, wAttributes);
+
 	COORD here;
 	for (int i = 0; i < totalMenu; i++) {
 		here.X = startX + (i % optionsPerLine) * spacingPerLine;
 		here.Y = startY + i / optionsPerLine;
 
-		SetConsoleCursorPosition(hStdout, here);
-
 		string buffer = getMenu(menu, i);
 
 		if (i == currentSelection) {
-			CONSOLE_SCREEN_BUFFER_INFO csbi;
-			WORD wOldColor;
-
-			// Save the current text colors. 
-			if (!GetConsoleScreenBufferInfo(hStdout, &csbi)) {
-				return 0;
-			}
-
-			wOldColor = csbi.wAttributes;
-
-			// Set the text attributes. 
-			if (!SetConsoleTextAttribute(hStdout, getHighlightAttributes(menu))) {
-				return 0;
-			}
-
-
-			DWORD cWritten;
-			if (!WriteFile(
-				hStdout,               // output handle 
-				buffer,                // string buffer 
-				lstrlenA(buffer),      // string length 
-				&cWritten,             // bytes written 
-				NULL))                 // not overlapped 
-			{
-				return 0;
-			}
-
-			// Restore the original text colors. 
-			SetConsoleTextAttribute(hStdout, wOldColor);
+			WriteScreen(screen, here.X, here.Y, buffer, getHighlightAttributes(menu));
 		}
 		else {
-			DWORD cWritten;
-			if (!WriteFile(
-				hStdout,               // output handle 
-				buffer,                // string buffer 
-				lstrlenA(buffer),      // string length 
-				&cWritten,             // bytes written 
-				NULL))                 // not overlapped 
-			{
-				return 0;
-			}
+			WriteScreen(screen, here.X, here.Y, buffer, wAttributes);
 		}
 	}
-	return 1;
+
+	// Only the options whose highlighting changed are written.
+	return PresentScreen(screen);
 }
 
 int mainMenu(Menu menu, int* selection) {
 
-	// Save the cursor info.
-	CONSOLE_CURSOR_INFO oldInfo;
-	GetConsoleCursorInfo(hStdout, &oldInfo);
+	// Save the cursor visibility.
+	bool oldVisible = IsCursorVisibleConsole();
 
 	// Hide the cursor inside the menu.
-	CONSOLE_CURSOR_INFO info;
-	info.dwSize = 100;
-	info.bVisible = FALSE;
-	SetConsoleCursorInfo(hStdout, &info);
-
-	DWORD fdwMode, fdwOldMode;
-
-	// Turn off the line input and echo input modes 
-	if (!GetConsoleMode(hStdin, &fdwOldMode)) {
-		// Restore the cursor.
-		SetConsoleCursorInfo(hStdout, &oldInfo);
-		return 0;
-	}
-
-	fdwMode = fdwOldMode &
-		~(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT);
-	if (!SetConsoleMode(hStdin, fdwMode)) {
-		// Restore the cursor.
-		SetConsoleCursorInfo(hStdout, &oldInfo);
-		return 0;
-	}
+	ShowCursorConsole(false);
 
 	// Variable for registering end.
 	BOOL done = FALSE;
@@ -234,91 +180,53 @@ int mainMenu(Menu menu, int* selection) {
 	// Number of options per one line;
 	int optionsPerLine = getOptionsPerLine(menu);
 
-	// Starting line
-	int startY = getPosY(menu);
-
-	// Finding size info.
-	CONSOLE_SCREEN_BUFFER_INFO csbi;
-	if (!GetConsoleScreenBufferInfo(hStdout, &csbi)) {
-		// Restore the original console mode. 
-		SetConsoleMode(hStdin, fdwOldMode);
-
-		// Restore the cursor.
-		SetConsoleCursorInfo(hStdout, &oldInfo);
-		return 0;
-	}
-	// End line for clearing.
-	int endY = startY + totalOptions;
-
-	// Registered event that has happend.
-	INPUT_RECORD event;
-
-	// Number of read characters.
-	DWORD cRead;
+	// Something else has been shown since the last time, so the first drawing is compared with the console.
+	InvalidateScreen(GetScreen());
 
 	// Loop for showing the menu, until done.
 	while (!done) {
-		if (!clear(startY, endY)) {
-			// Restore the original console mode. 
-			SetConsoleMode(hStdin, fdwOldMode);
-
-			// Restore the cursor.
-			SetConsoleCursorInfo(hStdout, &oldInfo);
-			return 0;
-		}
 		if (!drawMenu(menu, currentSelection)) {
-			// Restore the original console mode. 
-			SetConsoleMode(hStdin, fdwOldMode);
-
 			// Restore the cursor.
-			SetConsoleCursorInfo(hStdout, &oldInfo);
+			ShowCursorConsole(oldVisible);
 			return 0;
 		}
-		system("pause>nul");
-		if (WaitForSingleObject(hStdin, INFINITE) == WAIT_OBJECT_0)  /* if kbhit */
-		{
-			/* Get the input event */
-			ReadConsoleInput(hStdin, &event, 1, &cRead);
-
-			/* Only respond to key release events */
-			if ((event.EventType == KEY_EVENT) && !event.Event.KeyEvent.bKeyDown)
-				switch (event.Event.KeyEvent.wVirtualKeyCode) {
-				case VK_LEFT:
-					if (currentSelection % optionsPerLine > 0)
-						currentSelection--;
-					break;
-				case VK_RIGHT:
-					if (currentSelection % optionsPerLine < optionsPerLine - 1)
-						currentSelection++;
-					break;
-				case VK_UP:
-					if (currentSelection >= optionsPerLine)
-						currentSelection -= optionsPerLine;
-					break;
-				case VK_DOWN:
-					if (currentSelection + optionsPerLine < totalOptions)
-						currentSelection += optionsPerLine;
-					break;
-				case VK_ESCAPE:
-					if (canCancel) {
-						currentSelection = MENU_CANCEL;
-						done = TRUE;
-					}
-					break;
-				case VK_RETURN:
-					done = TRUE;
-					break;
-				default:
-					break;
-				}
+		switch (ReadKeyConsole()) {
+		case 0:
+			// The input is closed.
+			ShowCursorConsole(oldVisible);
+			return 0;
+		case VK_LEFT:
+			if (currentSelection % optionsPerLine > 0)
+				currentSelection--;
+			break;
+		case VK_RIGHT:
+			if (currentSelection % optionsPerLine < optionsPerLine - 1)
+				currentSelection++;
+			break;
+		case VK_UP:
+			if (currentSelection >= optionsPerLine)
+				currentSelection -= optionsPerLine;
+			break;
+		case VK_DOWN:
+			if (currentSelection + optionsPerLine < totalOptions)
+				currentSelection += optionsPerLine;
+			break;
+		case VK_ESCAPE:
+			if (canCancel) {
+				currentSelection = MENU_CANCEL;
+				done = TRUE;
+			}
+			break;
+		case VK_RETURN:
+			done = TRUE;
+			break;
+		default:
+			break;
 		}
 	}
 
-	// Restore the original console mode. 
-	SetConsoleMode(hStdin, fdwOldMode);
-
 	// Restore the cursor.
-	SetConsoleCursorInfo(hStdout, &oldInfo);
+	ShowCursorConsole(oldVisible);
 
 	*selection = currentSelection;
 	return 1;
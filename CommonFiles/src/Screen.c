@@ -0,0 +1,221 @@
+/**
+ * @file	Screen.c.
+ *
+ * @brief	Off-screen console buffer implementation.
+ *
+ * The screen keeps two grids of cells: the back grid holds the frame that is being composed, and
+ * the front grid holds the frame that is shown on the console. Only the cells that were drawn in
+ * the current frame are compared, and a cell whose shown contents are not known is always written.
+ */
+
+#include "Screen.h"
+#include <string.h>
+#include "cslib.h"
+
+/**
+ * @struct	ScreenCDT
+ *
+ * @brief	The off-screen console buffer.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ */
+
+struct ScreenCDT {
+	int width;
+	int height;
+	WORD attributes;
+	ConsoleCell* back;
+	ConsoleCell* front;
+	bool* drawn;
+	bool* known;
+	ConsoleCell* rectangle;
+};
+
+// The screen of the standard output.
+static Screen sharedScreen = NULL;
+
+static void AllocateCells(Screen screen, int width, int height);
+static void FreeCells(Screen screen);
+static bool IsChangedCell(Screen screen, int index);
+
+Screen NewScreen(void) {
+	Screen screen = newBlock(Screen);
+	screen->width = screen->height = 0;
+	screen->attributes = FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE;
+	screen->back = screen->front = screen->rectangle = NULL;
+	screen->drawn = screen->known = NULL;
+	InvalidateScreen(screen);
+	return screen;
+}
+
+void FreeScreen(Screen screen) {
+	if (screen == sharedScreen) {
+		sharedScreen = NULL;
+	}
+	FreeCells(screen);
+	freeBlock(screen);
+}
+
+Screen GetScreen(void) {
+	if (sharedScreen == NULL) {
+		sharedScreen = NewScreen();
+	}
+	return sharedScreen;
+}
+
+int GetWidthScreen(Screen screen) {
+	return screen->width;
+}
+
+int GetHeightScreen(Screen screen) {
+	return screen->height;
+}
+
+WORD GetAttributesScreen(Screen screen) {
+	return screen->attributes;
+}
+
+void InvalidateScreen(Screen screen) {
+	COORD size = GetSizeConsole();
+	screen->attributes = GetAttributesConsole();
+	if (size.X != screen->width || size.Y != screen->height) {
+		FreeCells(screen);
+		AllocateCells(screen, size.X, size.Y);
+	}
+
+	// The console is read back, so the next frame is compared with its real contents.
+	int total = screen->width * screen->height;
+	COORD home = { 0, 0 };
+	bool known = total > 0 && ReadCellsConsole(screen->front, home, size);
+	for (int i = 0; i < total; i++) {
+		if (!known) {
+			screen->front[i].character = ' ';
+			screen->front[i].attributes = screen->attributes;
+		}
+		screen->known[i] = known;
+	}
+	BeginScreen(screen);
+}
+void BeginScreen(Screen screen) {
+	memset(screen->drawn, 0, screen->width * screen->height * sizeof(bool));
+}
+
+void FillScreen(Screen screen, int x, int y, int width, int height, WORD attributes) {
+	int left = (x < 0) ? 0 : x;
+	int top = (y < 0) ? 0 : y;
+	int right = (x + width > screen->width) ? screen->width : x + width;
+	int bottom = (y + height > screen->height) ? screen->height : y + height;
+
+	for (int row = top; row < bottom; row++) {
+		for (int column = left; column < right; column++) {
+			int index = row * screen->width + column;
+			screen->back[index].character = ' ';
+			screen->back[index].attributes = attributes;
+			screen->drawn[index] = TRUE;
+		}
+	}
+}
+
+int WriteScreen(Screen screen, int x, int y, string text, WORD attributes) {
+	if (y < 0 || y >= screen->height) {
+		return 0;
+	}
+
+	int count = 0;
+	for (int column = x; text[column - x] != '\0' && column < screen->width; column++) {
+		if (column < 0) {
+			continue;
+		}
+		// Control characters would move the cursor, so they are drawn as blanks.
+		char character = text[column - x];
+		int index = y * screen->width + column;
+		screen->back[index].character = ((unsigned char) character < ' ') ? ' ' : character;
+		screen->back[index].attributes = attributes;
+		screen->drawn[index] = TRUE;
+		count++;
+	}
+	return count;
+}
+
+int PresentScreen(Screen screen) {
+	// Find the smallest rectangle that holds every changed cell.
+	int left = screen->width, top = screen->height, right = -1, bottom = -1;
+	for (int row = 0; row < screen->height; row++) {
+		for (int column = 0; column < screen->width; column++) {
+			if (IsChangedCell(screen, row * screen->width + column)) {
+				if (column < left) left = column;
+				if (column > right) right = column;
+				if (row < top) top = row;
+				bottom = row;
+			}
+		}
+	}
+	if (right < 0) {
+		return 1;
+	}
+
+	// The cells inside the rectangle that were not drawn keep their shown contents.
+	int width = right - left + 1;
+	int height = bottom - top + 1;
+	for (int row = 0; row < height; row++) {
+		for (int column = 0; column < width; column++) {
+			int index = (top + row) * screen->width + left + column;
+			screen->rectangle[row * width + column] = screen->drawn[index] ? screen->back[index] : screen->front[index];
+		}
+	}
+
+	COORD position = { (short) left, (short) top };
+	COORD size = { (short) width, (short) height };
+	if (!WriteCellsConsole(screen->rectangle, position, size)) {
+		return 0;
+	}
+
+	// The written cells are shown now.
+	int total = screen->width * screen->height;
+	for (int i = 0; i < total; i++) {
+		if (screen->drawn[i]) {
+			screen->front[i] = screen->back[i];
+			screen->known[i] = TRUE;
+		}
+	}
+	return 1;
+}
+
+// Private functions
+
+static void AllocateCells(Screen screen, int width, int height) {
+	int total = width * height;
+	screen->width = width;
+	screen->height = height;
+	screen->back = newArray(total, ConsoleCell);
+	screen->front = newArray(total, ConsoleCell);
+	screen->drawn = newArray(total, bool);
+	screen->known = newArray(total, bool);
+	screen->rectangle = newArray(total, ConsoleCell);
+}
+
+static void FreeCells(Screen screen) {
+	if (screen->back == NULL) {
+		return;
+	}
+	freeBlock(screen->back);
+	freeBlock(screen->front);
+	freeBlock(screen->drawn);
+	freeBlock(screen->known);
+	freeBlock(screen->rectangle);
+	screen->back = screen->front = screen->rectangle = NULL;
+	screen->drawn = screen->known = NULL;
+	screen->width = screen->height = 0;
+}
+
+static bool IsChangedCell(Screen screen, int index) {
+	if (!screen->drawn[index]) {
+		return FALSE;
+	}
+	if (!screen->known[index]) {
+		return TRUE;
+	}
+	return screen->back[index].character != screen->front[index].character
+		|| screen->back[index].attributes != screen->front[index].attributes;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file	SharedString.c.
+ *
+ * @brief	Shared string implementation.
+ *
+ * The reference count is kept in a header right before the text, in the same block. The count is
+ * changed atomically, because the autosave worker gives back the references of the snapshots it
+ * has written while the user interface thread takes new ones.
+ */
+
+#include "SharedString.h"
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+#include <string.h>
+#include "cslib.h"
+
+#ifdef _WIN32
+#define IncrementCount(p) InterlockedIncrement(p)
+#define DecrementCount(p) InterlockedDecrement(p)
+#else
+#define IncrementCount(p) __atomic_add_fetch((p), 1, __ATOMIC_RELAXED)
+#define DecrementCount(p) __atomic_sub_fetch((p), 1, __ATOMIC_ACQ_REL)
+#endif
+
+/**
+ * @struct	SharedStringHeader
+ *
+ * @brief	The header of a shared string, followed by its text.
+ */
+
+typedef struct {
+	/** @brief	Number of the references to the string. */
+	volatile long references;
+} *SharedStringHeader;
+
+static SharedStringHeader GetHeader(string shared);
+
+string NewSharedString(const string text) {
+	size_t length = strlen(text);
+	string shared = NewSharedStringOfLength(length);
+	memcpy(shared, text, length);
+	return shared;
+}
+
+string NewSharedStringOfLength(size_t length) {
+	SharedStringHeader header = getTypedBlock(sizeof(*header) + length + 1, "SharedString");
+	header->references = 1;
+	string shared = (string) (header + 1);
+	shared[length] = '\0';
+	return shared;
+}
+
+string RetainSharedString(string shared) {
+	IncrementCount(&GetHeader(shared)->references);
+	return shared;
+}
+
+void ReleaseSharedString(string shared) {
+	SharedStringHeader header = GetHeader(shared);
+	if (DecrementCount(&header->references) == 0) {
+		freeBlock(header);
+	}
+}
+
+// Private functions
+
+static SharedStringHeader GetHeader(string shared) {
+	return (SharedStringHeader) shared - 1;
+}
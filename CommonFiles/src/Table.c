@@ -1,14 +1,16 @@
 #include "Table.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 #include "vector.h"
-#include <Windows.h>
 #include "utilities.h"
 #include "cslib.h"
 #include "strbuf.h"
 #include "strlib.h"
-
-// Extern variables.
-extern HANDLE hStdout;
-extern HANDLE hStdin;
+#include "arena.h"
+#include "Screen.h"
+#include "Console.h"
+#include "Trace.h"
 
 struct TableCDT {
 	Vector data;
@@ -21,21 +23,44 @@ struct TableCDT {
 	Vector footer;
 	ToStringVector ToStringVectorFn;
 	FreeStringVector FreeStringVectorFn;
-	CompareFn cmpFn;
+	SortKey sortKeys[MAX_SORT_KEYS];
+	int sortKeysCount;
+	Vector sortedData;
+	unsigned long sortedVersion;
+	Vector rowCache;
+	Vector rowCacheData;
+	unsigned long rowCacheVersion;
+	Arena rowCacheArena;
+	Arena arena;
+};
+
+struct TableViewCDT {
+	Table table;
+	bool whole;
+	int* rows;
+	int count;
+	int capacity;
+	Vector footer;
+	SortKey sortKeys[MAX_SORT_KEYS];
+	int sortKeysCount;
+	bool sorted;
 };
 
+typedef struct {
+	const void* record;
+	int rank;
+} RecordRank;
+
+static bool IsRowCacheValid(Table t);
+static void ClearRowCache(Table t);
+static Vector GetRowTable(Table t, int index);
+
 Table NewTable(void) {
 	Table t = newBlock(Table);
 	t->data = newVector();
 	t->startX = 0;
 
-	CONSOLE_SCREEN_BUFFER_INFO csbi;
-	COORD windowSize;
-	// Get the console screen buffer info. 
-	if (!GetConsoleScreenBufferInfo(hStdout, &csbi)) {
-		//return 0;
-	}
-	windowSize = csbi.dwSize;
+	COORD windowSize = GetSizeConsole();
 
 	t->endX = windowSize.X - 1;
 	t->startY = 0;
@@ -45,7 +70,14 @@ Table NewTable(void) {
 	t->footer = newVector();
 	t->ToStringVectorFn = NULL;
 	t->FreeStringVectorFn = NULL;
-	t->cmpFn = NULL;
+	t->sortKeysCount = 0;
+	t->sortedData = NULL;
+	t->sortedVersion = 0;
+	t->rowCache = newVector();
+	t->rowCacheData = NULL;
+	t->rowCacheVersion = 0;
+	t->rowCacheArena = newArena();
+	t->arena = newArena();
 	return t;
 }
 
@@ -53,6 +85,10 @@ void FreeTable(Table t) {
 	freeVector(t->data);
 	freeVector(t->header);
 	freeVector(t->footer);
+	ClearRowCache(t);
+	freeVector(t->rowCache);
+	freeArena(t->rowCacheArena);
+	freeArena(t->arena);
 	freeBlock(t);
 }
 
@@ -149,11 +185,93 @@ void SetFreeStringVectorFnTable(Table t, FreeStringVector fn) {
 }
 
 CompareFn GetCompareFnTable(Table t) {
-	return t->cmpFn;
+	return (t->sortKeysCount > 0) ? t->sortKeys[0].cmpFn : NULL;
 }
 
 void SetCompareFnTable(Table t, CompareFn cmpFn) {
-	t->cmpFn = cmpFn;
+	t->sortKeys[0].cmpFn = cmpFn;
+	t->sortKeys[0].direction = SORT_ASCENDING;
+	t->sortKeysCount = 1;
+	InvalidateSortTable(t);
+}
+
+void PushSortKeyTable(Table t, CompareFn cmpFn, SortDirection direction) {
+	// Remove the key if it is already used, the other keys keep their order.
+	int count = 0;
+	for (int i = 0; i < t->sortKeysCount; i++) {
+		if (t->sortKeys[i].cmpFn != cmpFn) {
+			t->sortKeys[count++] = t->sortKeys[i];
+		}
+	}
+	if (count == MAX_SORT_KEYS) {
+		--count;
+	}
+
+	// The new key becomes the primary one.
+	for (int i = count; i > 0; i--) {
+		t->sortKeys[i] = t->sortKeys[i - 1];
+	}
+	t->sortKeys[0].cmpFn = cmpFn;
+	t->sortKeys[0].direction = direction;
+	t->sortKeysCount = count + 1;
+	InvalidateSortTable(t);
+}
+
+void ClearSortKeysTable(Table t) {
+	// The data is shown in its own order.
+	t->sortKeysCount = 0;
+	InvalidateSortTable(t);
+}
+
+static bool IsSortedTable(Table t) {
+	return t->sortedData == t->data && t->sortedVersion == versionVector(t->data);
+}
+
+void InvalidateSortTable(Table t) {
+	t->sortedData = NULL;
+
+	// The records changed in place, so their formatted rows are stale too.
+	t->rowCacheData = NULL;
+}
+
+int InsertSortedTable(Table t, void* record) {
+	if (!IsSortedTable(t)) {
+		// The data is sorted anyway before it is drawn.
+		addVector(t->data, record);
+		return sizeVector(t->data) - 1;
+	}
+	bool cached = IsRowCacheValid(t);
+	int index = insertSortedVector(t->data, record, t->sortKeys, t->sortKeysCount);
+	t->sortedVersion = versionVector(t->data);
+
+	// The formatted rows of the other records are still valid, they only move.
+	if (cached) {
+		if (index <= sizeVector(t->rowCache)) {
+			insert(t->rowCache, index, NULL);
+		}
+		t->rowCacheVersion = versionVector(t->data);
+	}
+	return index;
+}
+
+void RemoveRecordTable(Table t, int index) {
+	// Removing a record keeps the rest of the data in order.
+	bool sorted = IsSortedTable(t);
+	bool cached = IsRowCacheValid(t);
+	removeVector(t->data, index);
+	if (sorted) {
+		t->sortedVersion = versionVector(t->data);
+	}
+	if (cached) {
+		if (index < sizeVector(t->rowCache)) {
+			Vector row = getVector(t->rowCache, index);
+			if (row != NULL) {
+				t->FreeStringVectorFn(row);
+			}
+			removeVector(t->rowCache, index);
+		}
+		t->rowCacheVersion = versionVector(t->data);
+	}
 }
 
 Table CloneTable(Table table) {
@@ -168,141 +286,104 @@ Table CloneTable(Table table) {
 	clonedTable->footer = cloneVector(table->footer);
 	clonedTable->ToStringVectorFn = table->ToStringVectorFn;
 	clonedTable->FreeStringVectorFn = table->FreeStringVectorFn;
-	clonedTable->cmpFn = table->cmpFn;
+	for (int i = 0; i < table->sortKeysCount; i++) {
+		clonedTable->sortKeys[i] = table->sortKeys[i];
+	}
+	clonedTable->sortKeysCount = table->sortKeysCount;
+	clonedTable->sortedData = NULL;
+	clonedTable->sortedVersion = 0;
+	clonedTable->rowCache = newVector();
+	clonedTable->rowCacheData = NULL;
+	clonedTable->rowCacheVersion = 0;
+	clonedTable->rowCacheArena = newArena();
+	clonedTable->arena = newArena();
 	return clonedTable;
 }
 
-static string AlignCentre(string text, int width) {
+static int AlignCentre(string dest, string text, int width) {
 	int textLength = stringLength(text);
-	StringBuffer sb = newStringBuffer();
+	if (textLength == 0) {
+		return 0;
+	}
+
+	int length = 0;
 	if (textLength > width) {
-		appendString(sb, substring(text, 0, width - 4));
-		appendString(sb, "...");
+		// Too long text is cut and ends with three dots.
+		int cut = (width > 3) ? width - 3 : 0;
+		memcpy(dest, text, cut);
+		memcpy(dest + cut, "...", 3);
+		length = cut + 3;
 	}
 	else {
-		appendString(sb, text);
+		int padding = (width - textLength) / 2;
+		memset(dest, ' ', padding);
+		memcpy(dest + padding, text, textLength);
+		length = padding + textLength;
 	}
 
-	if (sizeStringBuffer(sb) == 0) {
-		string ret = copyString(getString(sb));
-		freeStringBuffer(sb);
-		return ret;
-	}
-	else {
-		StringBuffer newString = newStringBuffer();
-		for (int i = 0; i < (width - textLength) / 2; i++) {
-			pushChar(newString, ' ');
-		}
-		appendString(newString, getString(sb));
-		for (int i = sizeStringBuffer(newString); i < width; i++) {
-			pushChar(newString, ' ');
-		}
-		string ret = copyString(getString(newString));
-		freeStringBuffer(newString);
-		freeStringBuffer(sb);
-		return ret;
+	if (length < width) {
+		memset(dest + length, ' ', width - length);
+		length = width;
 	}
+	return length;
 }
 
-static int PrintRow(Table t, Vector columns) {
+static int PrintRow(Table t, Screen screen, COORD here, Vector columns, WORD attributes) {
 	int tableWidth = GetTableWidth(t);
 	int columnsCount = sizeVector(columns);
 	if (columnsCount == 0) return 1;
+	TraceSpan span = BeginTraceSpan("PrintRow");
 	int width = (tableWidth - columnsCount - 1) / columnsCount;
-	StringBuffer row = newStringBuffer();
 
-	appendString(row, " ");
-	for (int i = 0; i < sizeVector(columns); i++) {
+	// The whole row is built in the table arena, which is released after drawing.
+	int capacity = 1 + columnsCount * (((width > 0) ? width : 0) + 3) + tableWidth + 1;
+	string row = newArenaArray(t->arena, capacity, char);
+	int length = 0;
+
+	row[length++] = ' ';
+	for (int i = 0; i < columnsCount; i++) {
 		string column = getVector(columns, i);
-		string alignedColumn = AlignCentre(column, width);
-		appendString(row, alignedColumn);
-		freeBlock(alignedColumn);
-		if (i != sizeVector(columns) - 1) {
-			appendString(row, "|");
+		length += AlignCentre(row + length, column, width);
+		if (i != columnsCount - 1) {
+			row[length++] = '|';
 		}
 		else {
-			while (sizeStringBuffer(row) < tableWidth) {
-				appendString(row, " ");
+			while (length < tableWidth) {
+				row[length++] = ' ';
 			}
 		}
 	}
+	row[length] = '\0';
 
-	string strToPrint = copyString(getString(row));
-	int ret = PrintToConsole("%s", strToPrint);
-	freeBlock(strToPrint);
-	freeStringBuffer(row);
-	return ret;
-}
-
-static int PrintHighlightedRow(Table t, Vector columns) {
-	CONSOLE_SCREEN_BUFFER_INFO info;
-	WORD wOldColor;
-	WORD wAttributes = GetHighAttrTable(t);
-
-	// Save the current text colors. 
-	if (!GetConsoleScreenBufferInfo(hStdout, &info)) {
-		return 0;
-	}
-
-	wOldColor = info.wAttributes;
-
-	// Set the text attributes. 
-	if (!SetConsoleTextAttribute(hStdout, wAttributes)) {
-		return 0;
-	}
-
-	int ret = PrintRow(t, columns);
-
-	// Restore the original text colors. 
-	SetConsoleTextAttribute(hStdout, wOldColor);
-
-	return ret;
+	WriteScreen(screen, here.X, here.Y, row, attributes);
+	EndTraceSpan(span);
+	return 1;
 }
 
-static int PrintFooter(Table t, Vector columns) {
-	CONSOLE_SCREEN_BUFFER_INFO csbi;
+static int PrintFooter(Table t, Screen screen, Vector columns) {
 	COORD position;
 
-	// Get the number of character cells in the current buffer. 
-	// 
-	if (!GetConsoleScreenBufferInfo(hStdout, &csbi)) {
-		return 0;
-	}
-
+	// The footer is always on the last line of the console.
 	position.X = 0;
-	position.Y = csbi.dwSize.Y - 1;
-
-	SetConsoleCursorPosition(hStdout, position);
+	position.Y = GetHeightScreen(screen) - 1;
 
-	return PrintHighlightedRow(t, columns);
+	return PrintRow(t, screen, position, columns, GetHighAttrTable(t));
 }
 
-static int DrawTable(Table table, int currentSelection, int startIndex) {
-	// Data vector.
-	Vector data = GetDataTable(table);
+static int DrawTable(Table table, Screen screen, const int* rows, int total, Vector footer, int currentSelection, int startIndex) {
+	TraceSpan span = BeginTraceSpan("DrawTable");
 
-	// Vector to hold strings that represents columns in table.
-	Vector dataStringColumns = newVector();
-	ToStringVector ToFn = GetToStringVectorFnTable(table);
-	for (int i = 0; i < sizeVector(data); i++) {
-		void* record = getVector(data, i);
-		addVector(dataStringColumns, ToFn(record));
-	}
+	// Release the strings of the previous drawing.
+	resetArena(table->arena);
 
 	// Start line.
 	int startY = GetStartYTable(table);
 
-	// End line.
-	int endY = GetEndYTable(table);
-
 	// Start console column.
 	int startX = GetStartXTable(table);
 
-	// End console column.
-	int endX = GetEndXTable(table);
-
 	// Total number of options inside the table.
-	int totalOptions = GetTotalTable(table);
+	int totalOptions = total;
 
 	// Table height.
 	int tableHeight = GetTableHeight(table);
@@ -313,111 +394,97 @@ static int DrawTable(Table table, int currentSelection, int startIndex) {
 	// Highlighting attributes.
 	WORD wAttributes = GetHighAttrTable(table);
 
-	// Set the coordinates.
-	SetConsoleCursorPosition(hStdout, here);
+	// Attributes of the other rows.
+	WORD wNormalAttributes = GetAttributesScreen(screen);
+
+	// The frame covers the whole console, the same as the screen cleared before drawing.
+	BeginScreen(screen);
+	FillScreen(screen, 0, 0, GetWidthScreen(screen), GetHeightScreen(screen), wNormalAttributes);
 
 	// Print the header first.
-	if (!PrintHighlightedRow(table, GetHeaderTable(table))) {
+	if (!PrintRow(table, screen, here, GetHeaderTable(table), wAttributes)) {
+		EndTraceSpan(span);
 		return 0;
 	}
 
 	// Increment Y coordinate for one because of the header.
 	++startY;
 
-	if (isEmptyVector(data)) {
-		PrintToConsoleFormatted(CENTER_ALIGN | MIDDLE, "Tabela nema podataka.");
+	if (totalOptions == 0) {
+		string message = "Tabela nema podataka.";
+		int x = (GetWidthScreen(screen) - stringLength(message) - 1) / 2;
+		WriteScreen(screen, x, GetHeightScreen(screen) / 2, message, wNormalAttributes);
 	}
 
 	for (int i = 0; i < tableHeight - 2 && startIndex + i < totalOptions; i++) {
 		here.Y = startY + i;
 
-		SetConsoleCursorPosition(hStdout, here);
-
-		if (startIndex + i == currentSelection) {
-			if (!PrintHighlightedRow(table, getVector(dataStringColumns, startIndex + i))) {
-				return 0;
-			}
-		}
-		else {
-			if (!PrintRow(table, getVector(dataStringColumns, startIndex + i))) {
-				return 0;
-			}
+		// Only the visible records are formatted, and their rows are kept for the next drawing.
+		// A view shows the rows of the records it selects, so they are shared with the table.
+		int index = (rows != NULL) ? rows[startIndex + i] : startIndex + i;
+		Vector columns = GetRowTable(table, index);
+		WORD wRowAttributes = (startIndex + i == currentSelection) ? wAttributes : wNormalAttributes;
+		if (!PrintRow(table, screen, here, columns, wRowAttributes)) {
+			EndTraceSpan(span);
+			return 0;
 		}
 	}
 
-	DWORD oldMode;
-	DWORD newMode;
-
-	// Save the current input mode, to be restored on exit
-	// 
-	if (!GetConsoleMode(hStdout, &oldMode)) {
-		MessageBox(NULL, TEXT("GetConsoleMode"), TEXT("Console Error"), MB_OK);
-		exit(EXIT_FAILURE);
-	}
-
-	// Disable wraping on line end
-	// 
-	newMode = oldMode &
-		~(ENABLE_WRAP_AT_EOL_OUTPUT);
-	if (!SetConsoleMode(hStdout, newMode)) {
-		return 0;
-	}
-
 	// Print the footer
 	// 
-	if (!PrintFooter(table, GetFooterTable(table))) {
+	if (!PrintFooter(table, screen, footer)) {
+		EndTraceSpan(span);
 		return 0;
 	}
 
-	// Restore the original console mode
-	// 
-	SetConsoleMode(hStdout, oldMode);
+	// Only the cells that differ from the previous drawing are written.
+	int ret = PresentScreen(screen);
 
 	// Clean up.
-	FreeStringVector FreeFn = GetFreeStringVectorFnTable(table);
-	for (int i = 0; i < sizeVector(dataStringColumns); i++) {
-		Vector record = getVector(dataStringColumns, i);
-		FreeFn(record);
-	}
-	freeVector(dataStringColumns);
+	resetArena(table->arena);
 
-	return 1;
+	EndTraceSpan(span);
+	return ret;
 }
 
-int MainTable(Table table, int* selection, WORD* keyCode) {
-	// Data vector.
-	Vector data = GetDataTable(table);
+static bool IsRowCacheValid(Table t) {
+	return t->rowCacheData == t->data && t->rowCacheVersion == versionVector(t->data);
+}
 
-	// Function to compare data.
-	CompareFn cmpFn = GetCompareFnTable(table);
+static void ClearRowCache(Table t) {
+	for (int i = 0; i < sizeVector(t->rowCache); i++) {
+		Vector row = getVector(t->rowCache, i);
+		if (row != NULL) {
+			t->FreeStringVectorFn(row);
+		}
+	}
+	clearVector(t->rowCache);
+	resetArena(t->rowCacheArena);
+}
 
-	// Sort the vector.
-	QuickSortVector(data, 0, sizeVector(data) - 1, cmpFn);
+static Vector GetRowTable(Table t, int index) {
+	// Rows of other data, or of data that has changed since they were formatted, are dropped.
+	if (!IsRowCacheValid(t)) {
+		ClearRowCache(t);
+		t->rowCacheData = t->data;
+		t->rowCacheVersion = versionVector(t->data);
+	}
 
-	// Hide the cursor inside the table.
-	CONSOLE_CURSOR_INFO info;
-	info.dwSize = 100;
-	info.bVisible = FALSE;
-	SetConsoleCursorInfo(hStdout, &info);
-
-	DWORD fdwMode, fdwOldMode;
-
-	// Turn off the line input and echo input modes 
-	if (!GetConsoleMode(hStdin, &fdwOldMode)) {
-		// Show the cursor.
-		info.bVisible = TRUE;
-		SetConsoleCursorInfo(hStdout, &info);
-		return 0;
+	while (sizeVector(t->rowCache) <= index) {
+		addVector(t->rowCache, NULL);
 	}
 
-	fdwMode = fdwOldMode &
-		~(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT);
-	if (!SetConsoleMode(hStdin, fdwMode)) {
-		// Show the cursor.
-		info.bVisible = TRUE;
-		SetConsoleCursorInfo(hStdout, &info);
-		return 0;
+	Vector row = getVector(t->rowCache, index);
+	if (row == NULL) {
+		row = t->ToStringVectorFn(getVector(t->data, index), t->rowCacheArena);
+		setVector(t->rowCache, index, row);
 	}
+	return row;
+}
+
+static int RunTable(Table table, const int* rows, int total, Vector footer, int* selection, WORD* keyCode) {
+	// Hide the cursor inside the table.
+	ShowCursorConsole(false);
 
 	// Variable for registering end.
 	BOOL done = FALSE;
@@ -426,19 +493,7 @@ int MainTable(Table table, int* selection, WORD* keyCode) {
 	int currentSelection = *selection;
 
 	// Total number of options inside the table.
-	int totalOptions = GetTotalTable(table);
-
-	// Start line.
-	int startY = GetStartYTable(table);
-
-	// End line.
-	int endY = GetEndYTable(table);
-
-	// Start console column.
-	int startX = GetStartXTable(table);
-
-	// End console column.
-	int endX = GetEndXTable(table);
+	int totalOptions = total;
 
 	// Table height.
 	int tableHeight = GetTableHeight(table);
@@ -451,63 +506,281 @@ int MainTable(Table table, int* selection, WORD* keyCode) {
 		startIndex = 0;
 	}
 
-	// Registered event that has happend.
-	INPUT_RECORD event;
+	// Key that has been pressed.
+	WORD key = 0;
 
-	// Number of read characters.
-	DWORD cRead;
+	// Something else has been shown since the last time, so the first drawing is compared with the console.
+	Screen screen = GetScreen();
+	InvalidateScreen(screen);
 
 	// Loop for showing the menu, until done.
 	while (!done) {
-		// Using system("cls") does not produce as much flickering as does clear(startY, endY).
-		// 
-		//if (!clear(startY, endY)) {
-		//	return 0;
-		//}
-		system("cls");
-		if (!DrawTable(table, currentSelection, startIndex)) {
+		if (!DrawTable(table, screen, rows, total, footer, currentSelection, startIndex)) {
 			return 0;
 		}
-		system("pause>nul");
-		if (WaitForSingleObject(hStdin, INFINITE) == WAIT_OBJECT_0)  /* if kbhit */
-		{
-			/* Get the input event */
-			ReadConsoleInput(hStdin, &event, 1, &cRead);
-
-			/* Only respond to key release events */
-			if (event.EventType == KEY_EVENT)
-				switch (event.Event.KeyEvent.wVirtualKeyCode) {
-				case VK_UP:
-					if (currentSelection != 0) {
-						--currentSelection;
-						if (currentSelection < startIndex) {
-							--startIndex;
-						}
-					}
-					break;
-				case VK_DOWN:
-					if (currentSelection < totalOptions - 1) {
-						++currentSelection;
-						if (currentSelection >= startIndex + tableHeight - 2) {
-							++startIndex;
-						}
-					}
-					break;
-				default:
-					done = TRUE;
-					break;
+
+		key = ReadKeyConsole();
+		switch (key) {
+		case 0:
+			// The input is closed.
+			ShowCursorConsole(true);
+			return 0;
+		case VK_UP:
+			if (currentSelection != 0) {
+				--currentSelection;
+				if (currentSelection < startIndex) {
+					--startIndex;
 				}
+			}
+			break;
+		case VK_DOWN:
+			if (currentSelection < totalOptions - 1) {
+				++currentSelection;
+				if (currentSelection >= startIndex + tableHeight - 2) {
+					++startIndex;
+				}
+			}
+			break;
+		default:
+			done = TRUE;
+			break;
 		}
 	}
 
-	// Restore the original console mode. 
-	SetConsoleMode(hStdin, fdwOldMode);
-
 	// Show the cursor.
-	info.bVisible = TRUE;
-	SetConsoleCursorInfo(hStdout, &info);
+	ShowCursorConsole(true);
 
 	*selection = currentSelection;
-	*keyCode = event.Event.KeyEvent.wVirtualKeyCode;
+	*keyCode = key;
 	return 1;
 }
+
+void SortTable(Table table) {
+	// Data vector.
+	Vector data = GetDataTable(table);
+
+	// Sort the vector by all keys, the previously chosen keys break the ties.
+	// Nothing is done if neither the data nor the keys changed since the last sorting.
+	if (!IsSortedTable(table)) {
+		sortVectorByKeys(data, table->sortKeys, table->sortKeysCount);
+		table->sortedData = data;
+		table->sortedVersion = versionVector(data);
+	}
+}
+
+int MainTable(Table table, int* selection, WORD* keyCode) {
+	SortTable(table);
+	return RunTable(table, NULL, GetTotalTable(table), GetFooterTable(table), selection, keyCode);
+}
+
+TableView NewTableView(Table table) {
+	TableView view = newBlock(TableView);
+	view->table = table;
+	view->whole = true;
+	view->rows = NULL;
+	view->count = 0;
+	view->capacity = 0;
+	view->footer = NULL;
+
+	// The view starts in the order of the table, and keeps its own order from then on.
+	for (int i = 0; i < table->sortKeysCount; i++) {
+		view->sortKeys[i] = table->sortKeys[i];
+	}
+	view->sortKeysCount = table->sortKeysCount;
+	view->sorted = false;
+	return view;
+}
+
+void FreeTableView(TableView view) {
+	if (view->rows != NULL) {
+		freeBlock(view->rows);
+	}
+	freeBlock(view);
+}
+
+Table GetTableTableView(TableView view) {
+	return view->table;
+}
+
+bool IsWholeTableView(TableView view) {
+	return view->whole;
+}
+
+static void ReserveRowsTableView(TableView view, int count) {
+	if (count > view->capacity) {
+		if (view->rows != NULL) {
+			freeBlock(view->rows);
+		}
+		view->capacity = count;
+		view->rows = newArray(count, int);
+	}
+}
+
+void SetRowsTableView(TableView view, const int* rows, int count) {
+	ReserveRowsTableView(view, count);
+	if (count > 0) {
+		memcpy(view->rows, rows, count * sizeof(int));
+	}
+	view->count = count;
+	view->whole = false;
+	view->sorted = false;
+}
+
+static int CompareRecordRanks(const void* p1, const void* p2) {
+	uintptr_t first = (uintptr_t) ((const RecordRank*) p1)->record;
+	uintptr_t second = (uintptr_t) ((const RecordRank*) p2)->record;
+	return (first < second) ? -1 : (first > second);
+}
+
+void SetRecordsTableView(TableView view, Vector records) {
+	int count = sizeVector(records);
+	ReserveRowsTableView(view, count);
+	view->count = count;
+	view->whole = false;
+	view->sorted = false;
+	if (count == 0) {
+		return;
+	}
+
+	// The records are sorted by their addresses, so every record of the data is looked up among
+	// them with a binary search, and its position lands at the rank of the record.
+	RecordRank* ranks = newArray(count, RecordRank);
+	for (int i = 0; i < count; i++) {
+		ranks[i].record = getVector(records, i);
+		ranks[i].rank = i;
+		view->rows[i] = -1;
+	}
+	qsort(ranks, count, sizeof(RecordRank), CompareRecordRanks);
+
+	Vector data = view->table->data;
+	for (int i = 0; i < sizeVector(data); i++) {
+		RecordRank key = { getVector(data, i), 0 };
+		RecordRank* found = bsearch(&key, ranks, count, sizeof(RecordRank), CompareRecordRanks);
+		if (found != NULL) {
+			view->rows[found->rank] = i;
+		}
+	}
+	freeBlock(ranks);
+
+	// The records that are not in the data are left out.
+	int kept = 0;
+	for (int i = 0; i < count; i++) {
+		if (view->rows[i] >= 0) {
+			view->rows[kept++] = view->rows[i];
+		}
+	}
+	view->count = kept;
+}
+
+int GetTotalTableView(TableView view) {
+	return view->whole ? GetTotalTable(view->table) : view->count;
+}
+
+int GetRowTableView(TableView view, int index) {
+	if (index < 0 || index >= GetTotalTableView(view)) {
+		error("GetRowTableView: index outside of the view");
+	}
+	return view->whole ? index : view->rows[index];
+}
+
+void SetFooterTableView(TableView view, Vector footer) {
+	view->footer = footer;
+}
+
+void PushSortKeyTableView(TableView view, CompareFn cmpFn, SortDirection direction) {
+	if (view->whole) {
+		// The whole table is shown in its own order.
+		PushSortKeyTable(view->table, cmpFn, direction);
+		return;
+	}
+
+	// The same as for the table: the chosen key becomes the primary one.
+	int count = 0;
+	for (int i = 0; i < view->sortKeysCount; i++) {
+		if (view->sortKeys[i].cmpFn != cmpFn) {
+			view->sortKeys[count++] = view->sortKeys[i];
+		}
+	}
+	if (count == MAX_SORT_KEYS) {
+		--count;
+	}
+	for (int i = count; i > 0; i--) {
+		view->sortKeys[i] = view->sortKeys[i - 1];
+	}
+	view->sortKeys[0].cmpFn = cmpFn;
+	view->sortKeys[0].direction = direction;
+	view->sortKeysCount = count + 1;
+	view->sorted = false;
+}
+
+void ClearSortKeysTableView(TableView view) {
+	if (view->whole) {
+		ClearSortKeysTable(view->table);
+		return;
+	}
+
+	// The rows keep the order they have now.
+	view->sortKeysCount = 0;
+}
+
+static int CompareRows(Vector data, int first, int second, SortKey keys[], int nKeys) {
+	for (int i = 0; i < nKeys; i++) {
+		int result = keys[i].cmpFn(getVector(data, first), getVector(data, second));
+		if (result != 0) {
+			return (keys[i].direction == SORT_DESCENDING) ? -result : result;
+		}
+	}
+
+	// The records that are equal by all keys keep the order of the data.
+	return (first < second) ? -1 : (first > second);
+}
+
+static void MergeSortRows(Vector data, int* rows, int* buffer, int count, SortKey keys[], int nKeys) {
+	if (count < 2) {
+		return;
+	}
+	int middle = count / 2;
+	MergeSortRows(data, rows, buffer, middle, keys, nKeys);
+	MergeSortRows(data, rows + middle, buffer, count - middle, keys, nKeys);
+
+	// The halves that are already in order are not merged.
+	if (CompareRows(data, rows[middle - 1], rows[middle], keys, nKeys) <= 0) {
+		return;
+	}
+	memcpy(buffer, rows, middle * sizeof(int));
+	int i = 0, j = middle, k = 0;
+	while (i < middle && j < count) {
+		if (CompareRows(data, rows[j], buffer[i], keys, nKeys) < 0) {
+			rows[k++] = rows[j++];
+		}
+		else {
+			rows[k++] = buffer[i++];
+		}
+	}
+	while (i < middle) {
+		rows[k++] = buffer[i++];
+	}
+}
+
+void SortTableView(TableView view) {
+	if (view->whole) {
+		SortTable(view->table);
+		return;
+	}
+
+	// Only the rows are sorted, the data of the table stays as it is.
+	if (!view->sorted && view->sortKeysCount > 0 && view->count > 1) {
+		int* buffer = newArray(view->count / 2 + 1, int);
+		MergeSortRows(view->table->data, view->rows, buffer, view->count, view->sortKeys, view->sortKeysCount);
+		freeBlock(buffer);
+	}
+	view->sorted = true;
+}
+
+int MainTableView(TableView view, int* selection, WORD* keyCode) {
+	// The rows are positions in the data, so the data itself is sorted only for the whole table.
+	SortTableView(view);
+	Vector footer = (view->footer != NULL) ? view->footer : GetFooterTable(view->table);
+	const int* rows = view->whole ? NULL : view->rows;
+	return RunTable(view->table, rows, GetTotalTableView(view), footer, selection, keyCode);
+}
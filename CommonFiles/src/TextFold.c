@@ -0,0 +1,97 @@
+/**
+ * @file	TextFold.c.
+ *
+ * @brief	Text folding implementation.
+ */
+
+#include "TextFold.h"
+#include "cslib.h"
+#include "strbuf.h"
+
+bool IsFoldedChar(char ch) {
+	unsigned char uch = (unsigned char) ch;
+	if ((uch >= 'a' && uch <= 'z') || (uch >= 'A' && uch <= 'Z') || (uch >= '0' && uch <= '9')) {
+		return true;
+	}
+	switch (uch) {
+	case 0x8A: // Š
+	case 0x9A: // š
+	case 0x8E: // Ž
+	case 0x9E: // ž
+		return true;
+	case 0xD7: // ×
+	case 0xF7: // ÷
+		return false;
+	default:
+		return uch >= 0xC0;
+	}
+}
+
+bool AppendFoldedChar(StringBuffer sb, char ch) {
+	unsigned char uch = (unsigned char) ch;
+	if ((uch >= 'a' && uch <= 'z') || (uch >= '0' && uch <= '9')) {
+		pushChar(sb, ch);
+		return true;
+	}
+	if (uch >= 'A' && uch <= 'Z') {
+		pushChar(sb, ch - 'A' + 'a');
+		return true;
+	}
+
+	switch (uch) {
+	case 0xC8: // Č
+	case 0xE8: // č
+	case 0xC6: // Ć
+	case 0xE6: // ć
+		pushChar(sb, 'c');
+		return true;
+	case 0x8A: // Š
+	case 0x9A: // š
+		pushChar(sb, 's');
+		return true;
+	case 0x8E: // Ž
+	case 0x9E: // ž
+		pushChar(sb, 'z');
+		return true;
+	case 0xD0: // Đ
+	case 0xF0: // đ
+		pushChar(sb, 'd');
+		pushChar(sb, 'j');
+		return true;
+	case 0xD7: // ×
+	case 0xF7: // ÷
+		return false;
+	default:
+		break;
+	}
+
+	// The other letters of the code page are kept, in lower case.
+	if (uch >= 0xC0 && uch <= 0xDE) {
+		pushChar(sb, (char) (uch + 0x20));
+		return true;
+	}
+	if (uch >= 0xDF) {
+		pushChar(sb, ch);
+		return true;
+	}
+	return false;
+}
+
+void ForEachFoldedWord(StringBuffer sb, string text, FoldedWordFn fn, void* data) {
+	if (text == NULL) {
+		return;
+	}
+	clearStringBuffer(sb);
+	for (int i = 0;; i++) {
+		// The word ends at the first character that is neither a letter nor a digit.
+		if (text[i] == '\0' || !AppendFoldedChar(sb, text[i])) {
+			if (sizeStringBuffer(sb) > 0) {
+				fn(getString(sb), data);
+				clearStringBuffer(sb);
+			}
+			if (text[i] == '\0') {
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,269 @@
+/**
+ * @file	Trace.c.
+ *
+ * @brief	Tracing implementation.
+ *
+ * Every thread that ends a span gets its own ring of spans the first time, which is registered in
+ * a fixed table of the threads and is never freed, so the spans of a finished thread are still in
+ * the trace. Only the owning thread writes into its ring: it stores the span into the slot first and
+ * then advances the span count with a release store. The dump reads the count with an acquire load,
+ * copies the spans, and reads the count again, and leaves out the spans the owner may have
+ * overwritten in the meantime, so a dump from F12 never blocks the other threads.
+ */
+
+#include "Trace.h"
+
+#ifndef SUDOGU_NO_TRACE
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <time.h>
+#include <unistd.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include "cslib.h"
+#include "strlib.h"
+#include "Console.h"
+#include "platform.h"
+
+/** @brief	Number of the spans kept for each thread. */
+#define TRACE_RING_SIZE 4096
+
+/** @brief	Number of the threads that can be traced. */
+#define TRACE_MAX_THREADS 16
+
+/** @brief	The environment variable that holds the name of the trace file. */
+#define TRACE_VARIABLE "SUDOGU_TRACE"
+
+#ifdef _WIN32
+#define ThreadLocal __declspec(thread)
+#define LoadAcquire(p) InterlockedCompareExchange((p), 0, 0)
+#define StoreRelease(p, value) InterlockedExchange((p), (value))
+#define LoadAcquirePointer(p) InterlockedCompareExchangePointer((PVOID volatile*) (p), NULL, NULL)
+#define StoreReleasePointer(p, value) InterlockedExchangePointer((PVOID volatile*) (p), (value))
+#define FetchAdd(p, value) InterlockedExchangeAdd((p), (value))
+#define CurrentProcessId() ((int) GetCurrentProcessId())
+#else
+#define ThreadLocal __thread
+#define LoadAcquire(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define StoreRelease(p, value) __atomic_store_n((p), (value), __ATOMIC_RELEASE)
+#define LoadAcquirePointer(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define StoreReleasePointer(p, value) __atomic_store_n((p), (value), __ATOMIC_RELEASE)
+#define FetchAdd(p, value) __atomic_fetch_add((p), (value), __ATOMIC_ACQ_REL)
+#define CurrentProcessId() ((int) getpid())
+#endif
+
+/**
+ * @struct	TraceEntry
+ *
+ * @brief	An ended span.
+ */
+
+typedef struct {
+	string name;
+	uint64_t start;
+	uint64_t duration;
+} TraceEntry;
+
+/**
+ * @struct	ThreadTrace
+ *
+ * @brief	The spans of a single thread.
+ */
+
+typedef struct {
+	/** @brief	The name of the thread, or NULL. */
+	string name;
+	/** @brief	Number of the spans ended by the thread, the newest TRACE_RING_SIZE of which are kept. */
+	volatile long count;
+	TraceEntry ring[TRACE_RING_SIZE];
+} *ThreadTrace;
+
+/** @brief	The name of the trace file, or NULL if the tracing is off. */
+static string traceFileName = NULL;
+
+/** @brief	The time InitTrace was called, which the trace times are relative to. */
+static uint64_t traceOrigin;
+
+/** @brief	The registered threads. */
+static ThreadTrace volatile traceThreads[TRACE_MAX_THREADS];
+
+/** @brief	Number of the registered threads, which may go past the table size. */
+static volatile long traceThreadCount = 0;
+
+/** @brief	The ring of the calling thread, or NULL until it ends its first span. */
+static ThreadLocal ThreadTrace currentThread = NULL;
+
+static ThreadTrace GetCurrentThreadTrace(void);
+static uint64_t ReadClock(void);
+static double ToMicroseconds(uint64_t ticks);
+static void WriteThreadTrace(FILE* filepoint, ThreadTrace thread, int tid, bool* first);
+static void DumpTraceAtExit(void);
+
+void InitTrace(void) {
+#ifdef _WIN32
+	char buffer[MAX_PATH];
+	DWORD length = GetEnvironmentVariableA(TRACE_VARIABLE, buffer, sizeof(buffer));
+	string fileName = (length > 0 && length < sizeof(buffer)) ? buffer : NULL;
+#else
+	string fileName = getenv(TRACE_VARIABLE);
+#endif
+	if (fileName == NULL || *fileName == '\0' || traceFileName != NULL) {
+		return;
+	}
+	traceOrigin = ReadClock();
+	traceFileName = copyString(fileName);
+	NameTraceThread("main");
+	atexit(DumpTraceAtExit);
+}
+
+void NameTraceThread(string name) {
+	if (traceFileName == NULL) {
+		return;
+	}
+	ThreadTrace thread = GetCurrentThreadTrace();
+	if (thread != NULL) {
+		thread->name = name;
+	}
+}
+
+TraceSpan BeginTraceSpan(string name) {
+	TraceSpan span = { NULL, 0 };
+	if (traceFileName != NULL) {
+		span.name = name;
+		span.start = ReadClock();
+	}
+	return span;
+}
+
+void EndTraceSpan(TraceSpan span) {
+	if (span.name == NULL) {
+		return;
+	}
+	uint64_t end = ReadClock();
+	ThreadTrace thread = GetCurrentThreadTrace();
+	if (thread == NULL) {
+		return;
+	}
+
+	// Only this thread advances the count, so it can be read without the barrier.
+	long count = thread->count;
+	TraceEntry* entry = &thread->ring[count % TRACE_RING_SIZE];
+	entry->name = span.name;
+	entry->start = span.start;
+	entry->duration = end - span.start;
+	StoreRelease(&thread->count, count + 1);
+}
+
+bool HandleTraceKey(WORD key) {
+	if (key != VK_F12 || traceFileName == NULL) {
+		return false;
+	}
+	DumpTrace();
+	return true;
+}
+
+bool DumpTrace(void) {
+	if (traceFileName == NULL) {
+		return false;
+	}
+
+	FILE* filepoint;
+	if (fopen_s(&filepoint, traceFileName, "w") != 0) {
+		return false;
+	}
+	fprintf(filepoint, "{\"traceEvents\":[");
+	bool first = true;
+	long threads = LoadAcquire(&traceThreadCount);
+	for (int i = 0; i < threads && i < TRACE_MAX_THREADS; i++) {
+		// A thread that has just taken its slot may not have stored its ring yet.
+		ThreadTrace thread = (ThreadTrace) LoadAcquirePointer(&traceThreads[i]);
+		if (thread != NULL) {
+			WriteThreadTrace(filepoint, thread, i + 1, &first);
+		}
+	}
+	fprintf(filepoint, "\n],\"displayTimeUnit\":\"ms\"}\n");
+	return (fclose(filepoint) == 0);
+}
+
+// Private functions
+
+static ThreadTrace GetCurrentThreadTrace(void) {
+	if (currentThread == NULL) {
+		long index = FetchAdd(&traceThreadCount, 1);
+		if (index >= TRACE_MAX_THREADS) {
+			return NULL;
+		}
+		ThreadTrace thread = newBlock(ThreadTrace);
+		thread->name = NULL;
+		thread->count = 0;
+		StoreReleasePointer(&traceThreads[index], thread);
+		currentThread = thread;
+	}
+	return currentThread;
+}
+
+static void WriteThreadTrace(FILE* filepoint, ThreadTrace thread, int tid, bool* first) {
+	int pid = CurrentProcessId();
+	if (thread->name != NULL) {
+		fprintf(filepoint, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+			*first ? "" : ",", pid, tid, thread->name);
+		*first = false;
+	}
+
+	long end = LoadAcquire(&thread->count);
+	long copied = (end > TRACE_RING_SIZE) ? end - TRACE_RING_SIZE : 0;
+	TraceEntry* entries = newArray(end - copied + 1, TraceEntry);
+	for (long i = copied; i < end; i++) {
+		entries[i - copied] = thread->ring[i % TRACE_RING_SIZE];
+	}
+
+	// The owner may have overwritten the oldest copied spans while they were being copied.
+	long now = LoadAcquire(&thread->count);
+	long begin = (now - TRACE_RING_SIZE > copied) ? now - TRACE_RING_SIZE : copied;
+	for (long i = begin; i < end; i++) {
+		TraceEntry* entry = &entries[i - copied];
+		fprintf(filepoint, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+			*first ? "" : ",", entry->name, pid, tid, ToMicroseconds(entry->start - traceOrigin), ToMicroseconds(entry->duration));
+		*first = false;
+	}
+	freeBlock(entries);
+}
+
+#ifdef _WIN32
+
+static uint64_t ReadClock(void) {
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return (uint64_t) counter.QuadPart;
+}
+
+static double ToMicroseconds(uint64_t ticks) {
+	static LARGE_INTEGER frequency;
+	if (frequency.QuadPart == 0) {
+		QueryPerformanceFrequency(&frequency);
+	}
+	return (double) ticks * 1e6 / (double) frequency.QuadPart;
+}
+
+#else
+
+static uint64_t ReadClock(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+static double ToMicroseconds(uint64_t ticks) {
+	return (double) ticks / 1e3;
+}
+
+#endif
+
+static void DumpTraceAtExit(void) {
+	DumpTrace();
+}
+
+#endif // !SUDOGU_NO_TRACE
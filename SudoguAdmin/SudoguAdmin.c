@@ -4,12 +4,10 @@
  * @brief	Sudogu admin application. Main file.
  */
 
-#define _WIN32_WINNT 0x0500
 
  // System headers
 #include <stdio.h>
-#include <conio.h>
-#include <windows.h>
+#include <string.h>
 #include <time.h>
 #include <locale.h>
 
@@ -27,9 +25,18 @@
 
 // Custom headers
 #include "EventCategory.h"
+#include "EventCategoryIndex.h"
 #include "Event.h"
+#include "EventJournal.h"
+#include "EventSearch.h"
+#include "EventFilter.h"
+#include "EventFile.h"
+#include "EventSaver.h"
+#include "Trace.h"
 #include "Menu.h"
 #include "Table.h"
+#include "Console.h"
+#include "platform.h"
 
 /** @brief	The logo */
 string logo[6] = {
@@ -75,12 +82,19 @@ string eventsHeader[4] = {
 };
 
 /** @brief	The events table footer. */
-string eventsFooter[5] = {
+string eventsFooter[6] = {
 	"ESC: Izlaz.",
 	"RETURN: Detalji.",
 	"DELETE: Obriši.",
+	"F3: Pretraga.",
 	"F9: Novi događaj.",
-	"F10: Sortiraj listu."
+	"F10: Sortiraj."
+};
+
+/** @brief	The search results table footer. */
+string searchFooter[2] = {
+	"ESC: Nazad.",
+	"RETURN: Prikaži u listi."
 };
 
 /** @brief	The categories header[ 1] */
@@ -165,20 +179,14 @@ const string programName = "SudoguAdmin";
 /** @brief	The username */
 string username = NULL;
 
-/** @brief	Handle to the stdout */
-HANDLE hStdout;
-
-/** @brief	Handle to the stdin */
-HANDLE hStdin;
+/** @brief	The search index of all events */
+EventSearch eventsSearch = NULL;
 
-/** @brief	Variable to save the original console mode */
-DWORD fdwSaveOldMode;
+/** @brief	The category index of all events */
+EventCategoryIndex categoryIndex = NULL;
 
-/** @brief	The original color attributes of the console */
-WORD wOldColorAttrs;
-
-/** @brief	Information describing the console screen buffer */
-CONSOLE_SCREEN_BUFFER_INFO csbiInfo;
+/** @brief	The autosave worker that writes the data files */
+EventSaver dataSaver = NULL;
 
 /** @brief	The highlighting attributes */
 WORD HIGHLIGHT_ATTRIBUTES = F_WHITE | B_BLUE;
@@ -208,13 +216,11 @@ StringBuffer readPassword(void) {
 
 	do {
 		++i;
-		ch = _getch();
+		ch = ReadCharConsole();
 		if (ch == 0x08) // backspace
 		{
 			if (i > 0) {
-				_putch('\b');
-				_putch(' ');
-				_putch('\b');
+				WriteTextConsole("\b \b", 3);
 				popChar(password);
 				i -= 2;
 			}
@@ -223,18 +229,18 @@ StringBuffer readPassword(void) {
 		}
 		if (ch == 0x0d) // Enter
 		{
-			_putch('\n');
+			WriteTextConsole("\n", 1);
 			return password;
 		}
 		if (ch == 0x00) // Extended key pressed (F1, F2, etc.)
 		{
 			// extended keys have two parts ...
-			_getch(); // ignore it
+			ReadCharConsole(); // ignore it
 			--i;
 			continue;
 		}
 		pushChar(password, ch);
-		_putch('*');
+		WriteTextConsole("*", 1);
 	} while (ch != '\n');
 	return password;
 }
@@ -251,7 +257,7 @@ StringBuffer readPassword(void) {
 void PrintLogo(void) {
 	// 38
 	COORD cursorPosition = { 0, 4 };
-	SetConsoleCursorPosition(hStdout, cursorPosition);
+	SetCursorConsole(cursorPosition);
 	WORD oldAttributes = HIGHLIGHT_ATTRIBUTES;
 	HIGHLIGHT_ATTRIBUTES = F_BLUE | B_WHITE;
 	for (int i = 0; i < 6; i++) {
@@ -276,37 +282,30 @@ void PrintLogo(void) {
  */
 
 void loginAttempt(string* inUsername, string* inPassword) {
-	LPSTR prompt1 = "Username: ";
-	LPSTR prompt2 = "Password: ";
+	string prompt1 = "Username: ";
+	string prompt2 = "Password: ";
 	const int promptCount = 2;
-	DWORD cWritten;
+	int cWritten;
 	COORD cursorPosition;
 
-	CONSOLE_SCREEN_BUFFER_INFO csbiInfo;
-	COORD sizeConsole;
-
-	// Get the current screen sb size and window position. 
+	// Get the current screen size. 
 
-	if (!GetConsoleScreenBufferInfo(hStdout, &csbiInfo)) {
-		error_msg("GetConsoleScreenBufferInfo (%d)\n", GetLastError());
-	}
+	COORD sizeConsole = GetSizeConsole();
 
-	sizeConsole = csbiInfo.dwSize;
-
-	cursorPosition.X = (sizeConsole.X - lstrlenA(prompt1) * 2) / 2;
+	cursorPosition.X = (sizeConsole.X - (int) strlen(prompt1) * 2) / 2;
 	cursorPosition.Y = (sizeConsole.Y - promptCount) / 2;
 
 	//system("cls");
 	clearCordinates(0, cursorPosition.Y, 3, sizeConsole.X);
 
-	SetConsoleCursorPosition(hStdout, cursorPosition);
+	SetCursorConsole(cursorPosition);
 
 	cWritten = PrintToConsole(prompt1);
 
-	*inUsername = getLine();
+	*inUsername = ReadLineConsole();
 
 	++cursorPosition.Y;
-	SetConsoleCursorPosition(hStdout, cursorPosition);
+	SetCursorConsole(cursorPosition);
 
 	PrintToConsole(prompt2);
 
@@ -329,7 +328,7 @@ void login(void) {
 	Map accountsMap = NULL;
 	string inUsername = NULL, inPassword = NULL;
 
-	cls(hStdout);
+	cls();
 	while (true) {
 		if (accountsMap != NULL) {
 			freeMapFields(accountsMap);
@@ -341,7 +340,7 @@ void login(void) {
 			freeBlock(inPassword);
 		}
 
-		accountsMap = newMap();
+		accountsMap = newMapOfType(HASH_MAP);
 		if (fileToMap(fileAccounts, accountsMap) == 0) {
 			freeMapFields(accountsMap);
 			error_msg("Konfiguracioni fajl %s nije ispravan.\n", fileAccounts);
@@ -351,7 +350,7 @@ void login(void) {
 
 		loginAttempt(&inUsername, &inPassword);
 
-		cls(hStdout);
+		cls();
 		advanceCursor(3);
 
 		if (stringLength(inUsername) == 0 || stringLength(inPassword) == 0) {
@@ -416,9 +415,8 @@ void windowSetup(void);
  */
 
 string InputEventCategory(Table categories) {
-	// Save the cursor info.
-	CONSOLE_CURSOR_INFO oldInfo;
-	GetConsoleCursorInfo(hStdout, &oldInfo);
+	// Save the cursor visibility.
+	bool oldVisible = IsCursorVisibleConsole();
 
 	string categoryName;
 
@@ -429,19 +427,6 @@ string InputEventCategory(Table categories) {
 	addVector(footer, tmp);
 	SetFooterTable(cpyTable, footer);
 
-	DWORD fdwMode, fdwOldMode;
-
-	// Turn off the line input and echo input modes 
-	if (!GetConsoleMode(hStdin, &fdwOldMode)) {
-		return 0;
-	}
-
-	fdwMode = fdwOldMode &
-		~(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT);
-	if (!SetConsoleMode(hStdin, fdwMode)) {
-		return 0;
-	}
-
 	hideCursor();
 
 	// Variable for registering end.
@@ -455,10 +440,8 @@ string InputEventCategory(Table categories) {
 
 	while (!done) {
 		if (!MainTable(cpyTable, &tableSelection, &registeredKeyCode)) {
-			// Restore the original console mode. 
-			SetConsoleMode(hStdin, fdwOldMode);
 			// Restore the cursor.
-			SetConsoleCursorInfo(hStdout, &oldInfo);
+			ShowCursorConsole(oldVisible);
 			return NULL;
 		}
 		switch (registeredKeyCode) {
@@ -474,11 +457,8 @@ string InputEventCategory(Table categories) {
 	freeBlock(tmp);
 	FreeTable(cpyTable);
 
-	// Restore the original console mode. 
-	SetConsoleMode(hStdin, fdwOldMode);
-
 	// Restore the cursor.
-	SetConsoleCursorInfo(hStdout, &oldInfo);
+	ShowCursorConsole(oldVisible);
 
 	return categoryName;
 }
@@ -497,12 +477,12 @@ string InputEventCategory(Table categories) {
 time_t InputEventTime(void) {
 	int day, month, year, hour, minute;
 	PrintToConsole("\tDatum (mora biti u obliku \"dan.mjesec.godina.\"): ");
-	string inputString = getLine();
+	string inputString = ReadLineConsole();
 	sscanf(inputString, "%d.%d.%d.", &day, &month, &year);
 	//scanf("%d.%d.%d.", &day, &month, &year);
 	PrintToConsole("\tVrijeme (mora biti u obliku \"sati:minuti\"): ");
 	freeBlock(inputString);
-	inputString = getLine();
+	inputString = ReadLineConsole();
 	sscanf(inputString, "%d:%d", &hour, &minute);
 	//scanf("%d:%d", &hour, &minute);
 	// 
@@ -535,47 +515,43 @@ time_t InputEventTime(void) {
 
 int NewEventScreen(Table events, Table categories) {
 	string title = "Unos novog događaja";
-	system("cls");
+	ClearConsole();
 	PrintTitle(title);
 	advanceCursor(3);
 
 	PrintToConsole("\tNaziv događaja: ");
 	string eventName;
-	while ((eventName = getLine()) == NULL || strlen(eventName) == 0) {
+	while ((eventName = ReadLineConsole()) == NULL || strlen(eventName) == 0) {
 		advanceCursor(-1);
 		PrintToConsole("\tNaziv događaja: ");
 	}
 
 	PrintToConsole("\tLokacija: ");
 	string eventLocation;
-	while ((eventLocation = getLine()) == NULL || strlen(eventLocation) == 0) {
+	while ((eventLocation = ReadLineConsole()) == NULL || strlen(eventLocation) == 0) {
 		advanceCursor(-1);
 		PrintToConsole("\tLokacija: ");
 	}
 
 	time_t eventTime = InputEventTime();
 
-	CONSOLE_SCREEN_BUFFER_INFO csbi;
-	COORD oldCordinates; // Save original coordinates.
+	COORD oldCordinates = GetCursorConsole(); // Save original coordinates.
 
-	// Get the console screen buffer info. 
-	if (!GetConsoleScreenBufferInfo(hStdout, &csbi)) {
-		return 0;
-	}
-	oldCordinates = csbi.dwCursorPosition;
-
-	CHAR_INFO* chiBuffer = SaveScreenBuffer();
+	ConsoleCell* savedCells = SaveScreenBuffer();
 
 	string categoryName = InputEventCategory(categories);
 
-	RecoverScreenBuffer(chiBuffer);
-	SetConsoleCursorPosition(hStdout, oldCordinates);
+	RecoverScreenBuffer(savedCells);
+	SetCursorConsole(oldCordinates);
+	if (savedCells != NULL) {
+		freeBlock(savedCells);
+	}
 
 	PrintToConsole("\tKategorija: %s\n", categoryName);
 
 	PrintToConsole("\tOpis: ");
 	string eventDescription;
-	while ((eventDescription = getLine()) == NULL || strlen(eventDescription) == 0) {
+	while ((eventDescription = ReadLineConsole()) == NULL || strlen(eventDescription) == 0) {
 		advanceCursor(-1);
 		PrintToConsole("\tOpis: ");
 	}
@@ -587,8 +563,17 @@ int NewEventScreen(Table events, Table categories) {
 	setEventCategory(temp, categoryName);
 	setEventDescription(temp, eventDescription);
 
-	Vector eventsVector = GetDataTable(events);
-	addVector(eventsVector, temp);
+	// The event keeps its own copies of the strings.
+	freeBlock(eventName);
+	freeBlock(eventLocation);
+	freeBlock(eventDescription);
+
+	// The event is put at its place in the sorted table, so the table does not need sorting again.
+	unsigned long version = versionVector(GetDataTable(events));
+	int row = InsertSortedTable(events, temp);
+	JournalEventInsert(GetDataTable(events), fileEvents, temp);
+	InsertEventSearch(eventsSearch, temp);
+	InsertEventCategoryIndex(categoryIndex, row, version);
 
 	return 1;
 }
@@ -596,7 +581,8 @@ int NewEventScreen(Table events, Table categories) {
 /**
  * @fn	void SortEventsTable(Table t)
  *
- * @brief	Sorts events table.
+ * @brief	Sorts events table. The chosen column becomes the primary sort key, and the
+ * 			previously chosen columns order the events that are equal by it.
  *
  * @author	Pynikleois
  * @date	1/8/2020
@@ -616,28 +602,29 @@ void SortEventsTable(Table t) {
 	// Selected option inside the main menu.
 	int menuOption;
 
-	system("cls");
+	ClearConsole();
 	PrintTitle("Odaberite naziv kolone po kojoj želite da sortirate podatke");
 	if (!mainMenu(menu, &menuOption)) {
 		error_msg("mainMenu");
 	}
 	switch (menuOption) {
 	case EVENTS_HEADER_NAME:
-		SetCompareFnTable(t, CompareEventNames);
+		PushSortKeyTable(t, CompareEventNames, SORT_ASCENDING);
 		break;
 	case EVENTS_HEADER_LOCATION:
-		SetCompareFnTable(t, CompareEventLocations);
+		PushSortKeyTable(t, CompareEventLocations, SORT_ASCENDING);
 		break;
 	case EVENTS_HEADER_CATEGORY:
-		SetCompareFnTable(t, CompareEventCategories);
+		PushSortKeyTable(t, CompareEventCategories, SORT_ASCENDING);
 		break;
 	case EVENTS_HEADER_TIME:
-		SetCompareFnTable(t, CompareEventTimes);
+		PushSortKeyTable(t, CompareEventTimes, SORT_ASCENDING);
 		break;
 	default:
 		break;
 	}
 
+	freeMenu(menu);
 }
 
 /**
@@ -683,27 +670,34 @@ int EditEvent(Table events, Table categories, int index) {
 	time_t inputTime;
 
 	while (!done) {
-		system("cls");
+		ClearConsole();
 		PrintTitle("Koje polje želite da mijenjate?");
 		PrintStatusLine(" ESC: Povratak. ");
 		if (!mainMenu(menu, &menuOption)) {
+			freeMenu(menu);
 			return 0;
 		}
 		switch (menuOption) {
 		case EDIT_EVENT_NAME:
 			inputString = ShowPrompt("Unesite novi naziv", " RETURN: Potvrdi.", "Naziv: ");
-			setEventName(event, inputString);
+			if (inputString != NULL) {
+				setEventName(event, inputString);
+				freeBlock(inputString);
+			}
 			break;
 		case EDIT_EVENT_LOCATION:
 			inputString = ShowPrompt("Unesite novu lokaciju", " RETURN: Potvrdi.", "Lokacija: ");
-			setEventLocation(event, inputString);
+			if (inputString != NULL) {
+				setEventLocation(event, inputString);
+				freeBlock(inputString);
+			}
 			break;
 		case EDIT_EVENT_CATEGORY:
 			inputString = InputEventCategory(categories);
 			setEventCategory(event, inputString);
 			break;
 		case EDIT_EVENT_TIME:
-			system("cls");
+			ClearConsole();
 			PrintTitle("Unesite novo vrijeme");
 			PrintStatusLine(" RETURN: Potvrdi.");
 			SetCursorPositionMiddle();
@@ -714,7 +708,10 @@ int EditEvent(Table events, Table categories, int index) {
 			break;
 		case EDIT_EVENT_DESCRIPTION:
 			inputString = ShowPrompt("Unesite novi opis", " RETURN: Potvrdi.", "Opis: ");
-			setEventDescription(event, inputString);
+			if (inputString != NULL) {
+				setEventDescription(event, inputString);
+				freeBlock(inputString);
+			}
 			break;
 		case MENU_CANCEL:
 			done = TRUE;
@@ -723,6 +720,7 @@ int EditEvent(Table events, Table categories, int index) {
 			break;
 		}
 	}
+	freeMenu(menu);
 	return 1;
 }
 
@@ -747,32 +745,14 @@ int ShowEventDetails(Table events, Table categories, int index) {
 
 	string title = "Pregled detalja događaja";
 
-	DWORD fdwMode, fdwOldMode;
-
-	// Turn off the line input and echo input modes 
-	if (!GetConsoleMode(hStdin, &fdwOldMode)) {
-		showCursor();
-		return 0;
-	}
-
-	fdwMode = fdwOldMode &
-		~(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT);
-	if (!SetConsoleMode(hStdin, fdwMode)) {
-		showCursor();
-		return 0;
-	}
-
 	// Variable for registering end.
 	BOOL done = FALSE;
 
-	// Registered event that has happend.
-	INPUT_RECORD inputEvent;
-
-	// Number of read characters.
-	DWORD cRead;
+	// Event values before editing.
+	Event oldEvent;
 
 	while (!done) {
-		system("cls");
+		ClearConsole();
 
 		PrintTitle(title);
 		advanceCursor(3);
@@ -798,27 +778,33 @@ int ShowEventDetails(Table events, Table categories, int index) {
 		PrintStatusLine(" ESC: Povratak. | F9: Izmjena događaja. ");
 
 		hideCursor();
-		system("pause>nul");
-		if (WaitForSingleObject(hStdin, INFINITE) == WAIT_OBJECT_0)  /* if kbhit */
-		{
-			/* Get the input event */
-			ReadConsoleInput(hStdin, &inputEvent, 1, &cRead);
-
-			/* Only respond to key release events */
-			if (inputEvent.EventType == KEY_EVENT)
-				switch (inputEvent.Event.KeyEvent.wVirtualKeyCode) {
-				case VK_ESCAPE:
-					done = TRUE;
-					break;
-				case VK_F9:
-					if (!EditEvent(events, categories, index)) {
-						return 0;
-					}
-					SaveEventsToFile(GetDataTable(events), fileEvents);
-					break;
-				default:
-					break;
-				}
+		switch (ReadKeyConsole()) {
+		case VK_ESCAPE:
+			done = TRUE;
+			break;
+		case VK_F9:
+			oldEvent = cloneEvent(event);
+			if (!EditEvent(events, categories, index)) {
+				InvalidateSortTable(events);
+				freeEvent(oldEvent);
+				return 0;
+			}
+
+			// The cached rows point to the replaced strings even when the new ones are equal.
+			InvalidateSortTable(events);
+			if (!equalEvents(oldEvent, event)) {
+				JournalEventUpdate(data, fileEvents, oldEvent, event);
+				UpdateEventSearch(eventsSearch, oldEvent, event);
+				UpdateEventCategoryIndex(categoryIndex, index, oldEvent);
+			}
+			freeEvent(oldEvent);
+			break;
+		case 0:
+			// The input is closed.
+			showCursor();
+			return 0;
+		default:
+			break;
 		}
 	}
 
@@ -826,6 +812,75 @@ int ShowEventDetails(Table events, Table categories, int index) {
 	return 1;
 }
 
+/**
+ * @fn	int SearchEvents(Table events, int* selection)
+ *
+ * @brief	Asks for the search query and shows the found events in the order of relevance. The
+ * 			chosen event is selected in the events table.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 		  	events   	The events table.
+ * @param [in,out]	selection	The selected index inside the events table.
+ *
+ * @returns	An int: 1 on success, 0 otherwise.
+ */
+
+int SearchEvents(Table events, int* selection) {
+	string query = ShowPrompt("Pretraga događaja", " RETURN: Traži.", "Traženi pojam: ");
+	if (query == NULL) {
+		return 0;
+	}
+	Vector found = QueryEventSearch(eventsSearch, query);
+	freeBlock(query);
+
+	// The results are shown in the order of relevance, through a view of the events table.
+	TableView resultsView = NewTableView(events);
+	SetRecordsTableView(resultsView, found);
+	ClearSortKeysTableView(resultsView);
+	freeVector(found);
+	Vector footer = arrayToVector((void**) searchFooter, 2);
+	SetFooterTableView(resultsView, footer);
+
+	// Variable for registering end.
+	BOOL done = FALSE;
+
+	// Selected index inside the results table.
+	int resultSelection = 0;
+
+	// Key code that was registered inside the table.
+	WORD registeredKeyCode;
+
+	// Returning value.
+	int returnValue = 1;
+
+	while (!done) {
+		if (!MainTableView(resultsView, &resultSelection, &registeredKeyCode)) {
+			returnValue = 0;
+			break;
+		}
+		switch (registeredKeyCode) {
+		case VK_ESCAPE: // Back to the events table.
+			done = TRUE;
+			break;
+		case VK_RETURN: // Select the event in the events table.
+			if (GetTotalTableView(resultsView) == 0) {
+				break;
+			}
+			*selection = GetRowTableView(resultsView, resultSelection);
+			done = TRUE;
+			break;
+		default:
+			break;
+		}
+	}
+
+	freeVector(footer);
+	FreeTableView(resultsView);
+	return returnValue;
+}
+
 /**
  * @fn	int EventsHandling(Table events, Table categories)
  *
@@ -841,19 +896,6 @@ int ShowEventDetails(Table events, Table categories, int index) {
  */
 
 int EventsHandling(Table events, Table categories) {
-	DWORD fdwMode, fdwOldMode;
-
-	// Turn off the line input and echo input modes 
-	if (!GetConsoleMode(hStdin, &fdwOldMode)) {
-		return 0;
-	}
-
-	fdwMode = fdwOldMode &
-		~(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT);
-	if (!SetConsoleMode(hStdin, fdwMode)) {
-		return 0;
-	}
-
 	hideCursor();
 
 	// Variable for registering end.
@@ -865,61 +907,95 @@ int EventsHandling(Table events, Table categories) {
 	// Key code that was registered inside the table.
 	WORD registeredKeyCode;
 
+	// The filter that is typed into the table, which is shown whole.
+	TableView eventsView = NewTableView(events);
+	EventFilter filter = NewEventFilter(eventsView);
+
+	// Position of the selected event in the table data.
+	int row;
+
+	// Returning value.
+	int returnValue = 1;
+
 	while (!done) {
-		if (!MainTable(events, &tableSelection, &registeredKeyCode)) {
-			showCursor();
-			return 0;
+		if (!MainEventFilter(filter, &tableSelection, &registeredKeyCode)) {
+			returnValue = 0;
+			break;
 		}
+		row = GetRowEventFilter(filter, tableSelection);
 		switch (registeredKeyCode) {
-		case VK_ESCAPE: // Exit from table.
+		case VK_ESCAPE: // Clear the filter, or exit from table.
+			if (IsActiveEventFilter(filter)) {
+				tableSelection = ClearEventFilter(filter, tableSelection);
+				break;
+			}
 			done = TRUE;
 			break;
+		case VK_BACK: // Erase the last character of the filter.
+			if (EraseEventFilter(filter)) {
+				tableSelection = 0;
+			}
+			break;
 		case VK_RETURN: // Show details of the selected event.
-			if (isEmptyVector(GetDataTable(events))) {
+			if (row < 0) {
 				break;
 			}
-			if (!ShowEventDetails(events, categories, tableSelection)) {
-				showCursor();
-				return 0;
+			if (!ShowEventDetails(events, categories, row)) {
+				returnValue = 0;
+				done = TRUE;
 			}
+			RefreshEventFilter(filter);
 			break;
 		case VK_DELETE: // Delete selected event;
-			if (isEmptyVector(GetDataTable(events))) {
+			if (row < 0) {
 				break;
 			}
 			if (YesNoPrompt("Brisanje događaja", "Izbrisati odabrani događaj?")) {
-				removeVector(GetDataTable(events), tableSelection);
+				Event deleted = getVector(GetDataTable(events), row);
+				unsigned long version = versionVector(GetDataTable(events));
+				RemoveRecordTable(events, row);
+				JournalEventDelete(GetDataTable(events), fileEvents, deleted);
+				DeleteEventSearch(eventsSearch, deleted);
+				DeleteEventCategoryIndex(categoryIndex, row, deleted, version);
+				RefreshEventFilter(filter);
+				freeEvent(deleted);
 			}
 			tableSelection = 0;
-
-			SaveEventsToFile(GetDataTable(events), fileEvents);
-
+			break;
+		case VK_F3: // Search all events.
+			// The found event is selected in the whole table.
+			tableSelection = ClearEventFilter(filter, tableSelection);
+			if (!SearchEvents(events, &tableSelection)) {
+				returnValue = 0;
+				done = TRUE;
+			}
 			break;
 		case VK_F9: // New event.
 			if (isEmptyVector(GetDataTable(categories))) {
-				system("cls");
+				ClearConsole();
 				PrintToConsoleFormatted(CENTER_ALIGN | MIDDLE, "Mora postojati bar jedna kategorija događaja u evidenciji.");
-				system("pause>nul");
+				ReadKeyConsole();
 				break;
 			}
 			NewEventScreen(events, categories);
-
-			SaveEventsToFile(GetDataTable(events), fileEvents);
-
+			RefreshEventFilter(filter);
 			break;
 		case VK_F10: // Sort the list.
 			SortEventsTable(events);
+			RefreshEventFilter(filter);
 			break;
-		default:
+		default: // Type the character into the filter.
+			if (TypeEventFilter(filter, GetKeyCharConsole())) {
+				tableSelection = 0;
+			}
 			break;
 		}
 	}
 
-	// Restore the original console mode. 
-	SetConsoleMode(hStdin, fdwOldMode);
-
+	FreeEventFilter(filter);
+	FreeTableView(eventsView);
 	showCursor();
-	return 1;
+	return returnValue;
 }
 
 /**
@@ -935,12 +1011,12 @@ int EventsHandling(Table events, Table categories) {
 
 void NewCategoryScreen(Table table) {
 	string title = "Unos nove kategorije događaja";
-	system("cls");
+	ClearConsole();
 	PrintTitle(title);
 	advanceCursor(3);
 	PrintToConsole("\tNaziv nove kategorije događaja: ");
 
-	string categoryName = getLine();
+	string categoryName = ReadLineConsole();
 
 	EventCategory cat = newEventCategory();
 	setEventCategoryName(cat, categoryName);
@@ -963,18 +1039,6 @@ void NewCategoryScreen(Table table) {
  */
 
 int CategoriesHandling(Table table) {
-	DWORD fdwMode, fdwOldMode;
-
-	// Turn off the line input and echo input modes 
-	if (!GetConsoleMode(hStdin, &fdwOldMode)) {
-		return 0;
-	}
-
-	fdwMode = fdwOldMode &
-		~(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT);
-	if (!SetConsoleMode(hStdin, fdwMode)) {
-		return 0;
-	}
 	hideCursor();
 
 	// Variable for registering end.
@@ -1003,19 +1067,16 @@ int CategoriesHandling(Table table) {
 				removeVector(GetDataTable(table), tableSelection);
 			}
 			tableSelection = 0;
-			SaveCategoriesToFile(GetDataTable(table), fileCategories);
+			SaveCategoriesEventSaver(dataSaver, GetDataTable(table));
 			break;
 		case VK_F9: // New event.
 			NewCategoryScreen(table);
-			SaveCategoriesToFile(GetDataTable(table), fileCategories);
+			SaveCategoriesEventSaver(dataSaver, GetDataTable(table));
 			break;
 		default:
 			break;
 		}
 	}
-	// Restore the original console mode. 
-	SetConsoleMode(hStdin, fdwOldMode);
-
 	showCursor();
 	return 1;
 }
@@ -1033,25 +1094,16 @@ int CategoriesHandling(Table table) {
 
 int main(void) {
 
+	// Trace the application if SUDOGU_TRACE names the trace file
+	InitTrace();
+
 	// Setup the window
 	windowSetup();
 
-	// Vector to hold all events
-	Vector events;
-	
-	// Check if the events data file exists, and read it if it does. 
-	// Otherwise, create new vector.
-	// 
-	if (fileExists(fileEvents)) {
-		events = ReadEventsFromFile(fileEvents);
-	}
-	else {
-		events = newVector();
-	}
-
 	// Vector to hold all categories
 	Vector categories;
 	
+	// The categories are read first, so they are the first names in the category symbol table.
 	// Check if the categories data file exists, and read it if it does. 
 	// Otherwise, create new vector.
 	// 
@@ -1071,6 +1123,35 @@ int main(void) {
 		SaveCategoriesToFile(categories, fileCategories);
 	}
 
+	// Vector to hold all events
+	Vector events;
+	
+	// Check if the events data file exists, and read it if it does. 
+	// Otherwise, create new vector.
+	// 
+	if (fileExists(fileEvents)) {
+		// Files written by the older versions are converted to the current format.
+		ConvertLegacyEventFile(fileEvents);
+		events = ReadEventsFromFile(fileEvents);
+	}
+	else {
+		events = newVector();
+		ReplayEventJournal(events, fileEvents);
+	}
+
+	// Search index of the events, updated with every change of the events.
+	// 
+	eventsSearch = NewEventSearch(events);
+
+	// Category index of the events, updated with every change of the events.
+	// 
+	categoryIndex = NewEventCategoryIndex(events);
+
+	// From now on the data files are written in the background.
+	// 
+	dataSaver = NewEventSaver(fileEvents, fileCategories);
+	AttachEventJournalSaver(dataSaver);
+
 	// Main menu
 	Menu menu = newMenu();
 	
@@ -1078,7 +1159,7 @@ int main(void) {
 	// 
 	Vector menuVector = getMenuOptions(menu);
 	freeVector(menuVector);
-	Vector tmp = arrayToVector(menuOptions, 4);
+	Vector tmp = arrayToVector((void**) menuOptions, 4);
 	setMenuOptions(menu, tmp);
 
 	// Center the menu
@@ -1105,7 +1186,7 @@ int main(void) {
 	}
 	SetHeaderTable(eventsTable, tmpVector);
 	tmpVector = newVector();
-	for (int i = 0; i < 5; i++) {
+	for (int i = 0; i < 6; i++) {
 		string tmp = copyString(eventsFooter[i]);
 		addVector(tmpVector, tmp);
 	}
@@ -1125,8 +1206,10 @@ int main(void) {
 	
 	// Set funciton for comparing the events.
 	// Used for sorting the table before drawing it.
+	// Events at the same time are ordered by their names.
 	// 
-	SetCompareFnTable(eventsTable, CompareEventTimesDescending);
+	SetCompareFnTable(eventsTable, CompareEventNames);
+	PushSortKeyTable(eventsTable, CompareEventTimesDescending, SORT_ASCENDING);
 
 
 	// Table for all categories
@@ -1169,7 +1252,7 @@ int main(void) {
 
 	// City name, read from a config file
 	string cityName = NULL;
-	Map cityMap = newMap();
+	Map cityMap = newMapOfType(HASH_MAP);
 	if (fileToMap(fileCity, cityMap) != 1) {
 		freeMapFields(cityMap);
 		error_msg("Neispravna konfiguracija parametara grada unutar datoteke %s.\n", fileCity);
@@ -1192,7 +1275,7 @@ int main(void) {
 		loggedOut = FALSE;
 		while (!loggedOut && !done) {
 			// Clear the screen
-			system("cls");
+			ClearConsole();
 
 			// Print city and user name
 			advanceCursor(3);
@@ -1226,11 +1309,22 @@ int main(void) {
 		}
 	}
 
-	// Restore the original console mode. 
-	SetConsoleMode(hStdin, fdwSaveOldMode);
+	// Fold the journaled changes into the events data file and wait for the worker to write it.
+	// If the worker could not write a data file, it is written once more and the error is shown.
+	CompactEventJournal(events, fileEvents);
+	DetachEventJournalSaver();
+	if (CloseEventSaver(dataSaver)) {
+		ResetEventJournal(fileEvents);
+	}
+	else {
+		SaveEventsToFile(events, fileEvents);
+		SaveCategoriesToFile(categories, fileCategories);
+	}
+	FreeEventSearch(eventsSearch);
+	FreeEventCategoryIndex(categoryIndex);
 
-	// Restore the original text colors. 
-	SetConsoleTextAttribute(hStdout, wOldColorAttrs);
+	// Restore the original console mode, text colors and cursor.
+	CloseConsole();
 
 	return 0;
 }
@@ -1245,15 +1339,13 @@ int main(void) {
  */
 
 void windowSetup(void) {
-	// Set codepage. Needed for Serbian Latin chars.
+	// Set codepage and window size, and save the console state, to be restored on exit.
+	// Needed for Serbian Latin chars.
 	// Also added additional options in project property pages:
 	// /source-charset:windows-1250 /execution-charset:windows-1250
 	// 
-	if (!SetConsoleCP(1250)) {
-		error_msg("SetConsoleCP");
-	}
-	if (!SetConsoleOutputCP(1250)) {
-		error_msg("SetConsoleOutputCP");
+	if (!OpenConsole(windowSizeX, windowSizeY)) {
+		error_msg("OpenConsole");
 	}
 
 	// Set system locale.
@@ -1267,43 +1359,9 @@ void windowSetup(void) {
 	//
 	_tzset();
 
-	// Disable window resizing and maximizing.
-	// 
-	HWND consoleWindow = GetConsoleWindow();
-	SetWindowLong(consoleWindow, GWL_STYLE, GetWindowLong(consoleWindow, GWL_STYLE) & ~WS_MAXIMIZEBOX & ~WS_SIZEBOX);
-	SetConsoleWindowSize(windowSizeX, windowSizeY);
-
-	// Get handles to STDIN and STDOUT.
-	// 
-	hStdin = GetStdHandle(STD_INPUT_HANDLE);
-	hStdout = GetStdHandle(STD_OUTPUT_HANDLE);
-	if (hStdin == INVALID_HANDLE_VALUE || hStdout == INVALID_HANDLE_VALUE) {
-		MessageBox(NULL, TEXT("GetStdHandle"), TEXT("Console Error"), MB_OK);
-		exit(EXIT_FAILURE);
-	}
-
-	// Save the current input mode, to be restored on exit.
-	// 
-	if (!GetConsoleMode(hStdin, &fdwSaveOldMode)) {
-		MessageBox(NULL, TEXT("GetConsoleMode"), TEXT("Console Error"), MB_OK);
-		exit(EXIT_FAILURE);
-	}
-
-	// Save the current text colors.
-	// 
-	if (!GetConsoleScreenBufferInfo(hStdout, &csbiInfo)) {
-		MessageBox(NULL, TEXT("GetConsoleScreenBufferInfo"), TEXT("Console Error"), MB_OK);
-		exit(EXIT_FAILURE);
-	}
-
-	wOldColorAttrs = csbiInfo.wAttributes;
-
 	// Set text attributes.
 	// 
-	if (!SetConsoleTextAttribute(hStdout, B_WHITE)) {
-		MessageBox(NULL, TEXT("SetConsoleTextAttribute"), TEXT("Console Error"), MB_OK);
-		exit(EXIT_FAILURE);
-	}
+	SetAttributesConsole(B_WHITE);
 
 	// Show cursor.
 	// 
@@ -1311,5 +1369,5 @@ void windowSetup(void) {
 
 	// Clear screen.
 	// 
-	system("cls");
+	ClearConsole();
 }
@@ -0,0 +1,843 @@
+﻿/**
+ * @file	SudoguBench.c.
+ *
+ * @brief	Sudogu micro-benchmarks. Main file.
+ *
+ * Measures the library containers and the events data file code paths the applications use. Every
+ * benchmark runs in its own child process, so the peak resident set size belongs to that benchmark
+ * only, and the data one benchmark leaves behind does not slow the next one down.
+ *
+ * Usage: SudoguBench [size...] [name...]
+ * 	The sizes replace the default ones (1000, 100000 and 1000000), and the names select the
+ * 	benchmarks whose names start with them.
+ *
+ * The allocations are counted by wrapping the C runtime allocator, which is done only when the
+ * benchmark is linked with the GNU linker (see CMakeLists.txt); otherwise they are not reported.
+ */
+
+// System headers
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// CSLib headers
+#include "cslib.h"
+#include "bst.h"
+#include "map.h"
+#include "strbuf.h"
+#include "strlib.h"
+#include "utilities.h"
+#include "vector.h"
+
+// Custom headers
+#include "Event.h"
+#include "EventJournal.h"
+#include "AtomicFile.h"
+#include "Console.h"
+
+/** @brief	The highlighting attributes (used by the utilities) */
+WORD HIGHLIGHT_ATTRIBUTES = F_WHITE | B_BLUE;
+
+/** @brief	The data file the events benchmarks write and read */
+const string benchFile = "SudoguBench.dat";
+
+/** @brief	The default numbers of elements */
+const int defaultSizes[] = { 1000, 100000, 1000000 };
+
+/** @brief	The smallest number of operations a measurement repeats the benchmark for */
+#define MIN_OPERATIONS 1000000
+
+/**
+ * @struct	Benchmark
+ *
+ * @brief	A benchmark.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ */
+
+typedef struct {
+	/** @brief	The name of the benchmark. */
+	string name;
+	/** @brief	The largest number of elements, or zero if there is no limit. */
+	int maxSize;
+	/** @brief	Runs the benchmark with the number of elements. */
+	void (*run)(int n);
+} Benchmark;
+
+/** @brief	The start of the measurement */
+static struct timespec measureStart;
+
+/** @brief	The number of allocations at the start of the measurement */
+static long measureAllocations;
+
+/** @brief	The measured time in nanoseconds per operation */
+static double resultTime;
+
+/** @brief	The measured number of allocations per operation */
+static double resultAllocations;
+
+/** @brief	The number of allocations made so far */
+static long allocationCount = 0;
+
+/** @brief	The state of the random number generator */
+static unsigned long randomState = 1;
+
+#ifdef SUDOGU_BENCH_COUNT_ALLOCATIONS
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+	allocationCount++;
+	return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+	allocationCount++;
+	return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+	allocationCount++;
+	return __real_realloc(ptr, size);
+}
+
+#endif
+
+/**
+ * @fn	static void StartMeasure(void)
+ *
+ * @brief	Starts the measurement. The preparation done before is not measured.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ */
+
+static void StartMeasure(void) {
+	measureAllocations = allocationCount;
+	clock_gettime(CLOCK_MONOTONIC, &measureStart);
+}
+
+/**
+ * @fn	static void StopMeasure(long operations)
+ *
+ * @brief	Stops the measurement.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	operations	The number of the measured operations.
+ */
+
+static void StopMeasure(long operations) {
+	struct timespec end;
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	double elapsed = (end.tv_sec - measureStart.tv_sec) * 1e9 + (end.tv_nsec - measureStart.tv_nsec);
+	resultTime = elapsed / operations;
+	resultAllocations = (double) (allocationCount - measureAllocations) / operations;
+}
+
+/**
+ * @fn	static int NextRandom(int bound)
+ *
+ * @brief	Gets the next number of the fixed pseudo-random sequence, so every run measures the same
+ * 			data.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	bound	The upper bound of the number.
+ *
+ * @returns	A number between zero and the bound, without the bound.
+ */
+
+static int NextRandom(int bound) {
+	randomState = randomState * 6364136223846793005UL + 1442695040888963407UL;
+	return (int) ((randomState >> 33) % (unsigned long) bound);
+}
+
+/**
+ * @fn	static int Repetitions(int n)
+ *
+ * @brief	Gets how many times a benchmark over the elements is repeated, so the small sizes are
+ * 			measured long enough.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of elements.
+ *
+ * @returns	The number of repetitions.
+ */
+
+static int Repetitions(int n) {
+	return (n < MIN_OPERATIONS) ? MIN_OPERATIONS / n : 1;
+}
+
+/**
+ * @fn	static string* NewKeys(int n)
+ *
+ * @brief	Creates the distinct keys in a shuffled order.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of keys.
+ *
+ * @returns	The keys.
+ */
+
+static string* NewKeys(int n) {
+	string* keys = newArray(n, string);
+	char buf[32];
+	for (int i = 0; i < n; i++) {
+		sprintf(buf, "kljuc%07d", i);
+		keys[i] = copyString(buf);
+	}
+	for (int i = n - 1; i > 0; i--) {
+		int j = NextRandom(i + 1);
+		string key = keys[i];
+		keys[i] = keys[j];
+		keys[j] = key;
+	}
+	return keys;
+}
+
+/**
+ * @fn	static Vector NewEvents(int n)
+ *
+ * @brief	Creates the events with the random times, locations and categories.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of events.
+ *
+ * @returns	The events vector.
+ */
+
+static Vector NewEvents(int n) {
+	static string locations[] = { "Banja Luka", "Laktaši", "Prijedor", "Doboj", "Bijeljina" };
+	static string categories[] = { "Koncerti", "Promocije", "Izložbe", "Predstave", "Sport" };
+	time_t now = time(NULL);
+	Vector events = newVector();
+	char buf[64];
+	for (int i = 0; i < n; i++) {
+		Event e = newEvent();
+		sprintf(buf, "Događaj %d", NextRandom(n));
+		setEventName(e, buf);
+		sprintf(buf, "Opis događaja %d", i);
+		setEventDescription(e, buf);
+		setEventLocation(e, locations[NextRandom(sizeof locations / sizeof locations[0])]);
+		setEventCategory(e, categories[NextRandom(sizeof categories / sizeof categories[0])]);
+		setEventTime(e, now + NextRandom(2 * 365 * 24 * 60) * 60L - 365 * 24 * 60 * 60L);
+		addVector(events, e);
+	}
+	return events;
+}
+
+/**
+ * @fn	static void BenchVectorAdd(int n)
+ *
+ * @brief	Measures adding the elements to the end of a new vector.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of elements.
+ */
+
+static void BenchVectorAdd(int n) {
+	int repetitions = Repetitions(n);
+	StartMeasure();
+	for (int r = 0; r < repetitions; r++) {
+		Vector vector = newVector();
+		for (int i = 0; i < n; i++) {
+			addVector(vector, vector);
+		}
+		freeVector(vector);
+	}
+	StopMeasure((long) repetitions * n);
+}
+
+/**
+ * @fn	static void BenchVectorInsert(int n)
+ *
+ * @brief	Measures inserting the elements into the middle of the vector.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of elements.
+ */
+
+static void BenchVectorInsert(int n) {
+	Vector vector = newVector();
+	StartMeasure();
+	for (int i = 0; i < n; i++) {
+		insert(vector, i / 2, vector);
+	}
+	StopMeasure(n);
+	freeVector(vector);
+}
+
+/**
+ * @fn	static void BenchVectorRemove(int n)
+ *
+ * @brief	Measures removing the elements from the middle of the vector.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of elements.
+ */
+
+static void BenchVectorRemove(int n) {
+	Vector vector = newVector();
+	for (int i = 0; i < n; i++) {
+		addVector(vector, vector);
+	}
+	StartMeasure();
+	for (int i = n; i > 0; i--) {
+		removeVector(vector, i / 2);
+	}
+	StopMeasure(n);
+	freeVector(vector);
+}
+
+/**
+ * @fn	static void BenchVectorClone(int n)
+ *
+ * @brief	Measures cloning the vector, per element.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of elements.
+ */
+
+static void BenchVectorClone(int n) {
+	int repetitions = Repetitions(n);
+	Vector vector = newVector();
+	for (int i = 0; i < n; i++) {
+		addVector(vector, vector);
+	}
+	StartMeasure();
+	for (int r = 0; r < repetitions; r++) {
+		freeVector(cloneVector(vector));
+	}
+	StopMeasure((long) repetitions * n);
+	freeVector(vector);
+}
+
+/**
+ * @fn	static void BenchStringBufferPush(int n)
+ *
+ * @brief	Measures pushing the characters to a new string buffer.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of characters.
+ */
+
+static void BenchStringBufferPush(int n) {
+	int repetitions = Repetitions(n);
+	StartMeasure();
+	for (int r = 0; r < repetitions; r++) {
+		StringBuffer sb = newStringBuffer();
+		for (int i = 0; i < n; i++) {
+			pushChar(sb, 'a' + i % 26);
+		}
+		freeStringBuffer(sb);
+	}
+	StopMeasure((long) repetitions * n);
+}
+
+/**
+ * @fn	static void BenchStringBufferAppend(int n)
+ *
+ * @brief	Measures appending the strings to a new string buffer.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of strings.
+ */
+
+static void BenchStringBufferAppend(int n) {
+	int repetitions = Repetitions(n);
+	StartMeasure();
+	for (int r = 0; r < repetitions; r++) {
+		StringBuffer sb = newStringBuffer();
+		for (int i = 0; i < n; i++) {
+			appendString(sb, "Banja Luka");
+		}
+		freeStringBuffer(sb);
+	}
+	StopMeasure((long) repetitions * n);
+}
+
+/**
+ * @fn	static void BenchBSTInsert(int n)
+ *
+ * @brief	Measures inserting the shuffled keys into the binary search tree.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of keys.
+ */
+
+static void BenchBSTInsert(int n) {
+	string* keys = NewKeys(n);
+	BST bst = newBST(string);
+	StartMeasure();
+	for (int i = 0; i < n; i++) {
+		insertBSTNodeString(bst, keys[i]);
+	}
+	StopMeasure(n);
+	freeBST(bst);
+}
+
+/**
+ * @fn	static void BenchBSTFind(int n)
+ *
+ * @brief	Measures finding every key in the binary search tree.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of keys.
+ */
+
+static void BenchBSTFind(int n) {
+	int repetitions = Repetitions(n);
+	string* keys = NewKeys(n);
+	BST bst = newBST(string);
+	for (int i = 0; i < n; i++) {
+		insertBSTNodeString(bst, keys[i]);
+	}
+	StartMeasure();
+	for (int r = 0; r < repetitions; r++) {
+		for (int i = 0; i < n; i++) {
+			if (findBSTNodeString(bst, keys[i]) == NULL) {
+				error("BenchBSTFind: Key not found");
+			}
+		}
+	}
+	StopMeasure((long) repetitions * n);
+	freeBST(bst);
+}
+
+/**
+ * @fn	static void BenchMapPut(int n, MapType type)
+ *
+ * @brief	Measures putting the shuffled keys into the map of the type.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n   	The number of keys.
+ * @param 	type	The type of the map.
+ */
+
+static void BenchMapPut(int n, MapType type) {
+	string* keys = NewKeys(n);
+	Map map = newMapOfType(type);
+	StartMeasure();
+	for (int i = 0; i < n; i++) {
+		putMap(map, keys[i], keys[i]);
+	}
+	StopMeasure(n);
+	freeMap(map);
+}
+
+/**
+ * @fn	static void BenchMapGet(int n, MapType type)
+ *
+ * @brief	Measures getting every key from the map of the type.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n   	The number of keys.
+ * @param 	type	The type of the map.
+ */
+
+static void BenchMapGet(int n, MapType type) {
+	int repetitions = Repetitions(n);
+	string* keys = NewKeys(n);
+	Map map = newMapOfType(type);
+	for (int i = 0; i < n; i++) {
+		putMap(map, keys[i], keys[i]);
+	}
+	StartMeasure();
+	for (int r = 0; r < repetitions; r++) {
+		for (int i = 0; i < n; i++) {
+			if (getMap(map, keys[i]) != keys[i]) {
+				error("BenchMapGet: Key not found");
+			}
+		}
+	}
+	StopMeasure((long) repetitions * n);
+	freeMap(map);
+}
+
+/**
+ * @fn	static void BenchTreeMapPut(int n)
+ *
+ * @brief	Measures putting the keys into the tree map.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of keys.
+ */
+
+static void BenchTreeMapPut(int n) {
+	BenchMapPut(n, TREE_MAP);
+}
+
+/**
+ * @fn	static void BenchTreeMapGet(int n)
+ *
+ * @brief	Measures getting the keys from the tree map.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of keys.
+ */
+
+static void BenchTreeMapGet(int n) {
+	BenchMapGet(n, TREE_MAP);
+}
+
+/**
+ * @fn	static void BenchHashMapPut(int n)
+ *
+ * @brief	Measures putting the keys into the hash map.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of keys.
+ */
+
+static void BenchHashMapPut(int n) {
+	BenchMapPut(n, HASH_MAP);
+}
+
+/**
+ * @fn	static void BenchHashMapGet(int n)
+ *
+ * @brief	Measures getting the keys from the hash map.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of keys.
+ */
+
+static void BenchHashMapGet(int n) {
+	BenchMapGet(n, HASH_MAP);
+}
+
+/**
+ * @fn	static void BenchSort(int n, CompareFn cmpFn)
+ *
+ * @brief	Measures sorting the random events with the comparison function.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n    	The number of events.
+ * @param 	cmpFn	The comparison function.
+ */
+
+static void BenchSort(int n, CompareFn cmpFn) {
+	Vector events = NewEvents(n);
+	StartMeasure();
+	QuickSortVector(events, 0, sizeVector(events) - 1, cmpFn);
+	StopMeasure(n);
+}
+
+/**
+ * @fn	static void BenchSortNames(int n)
+ *
+ * @brief	Measures sorting the events by name.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of events.
+ */
+
+static void BenchSortNames(int n) {
+	BenchSort(n, CompareEventNames);
+}
+
+/**
+ * @fn	static void BenchSortLocations(int n)
+ *
+ * @brief	Measures sorting the events by location.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of events.
+ */
+
+static void BenchSortLocations(int n) {
+	BenchSort(n, CompareEventLocations);
+}
+
+/**
+ * @fn	static void BenchSortCategories(int n)
+ *
+ * @brief	Measures sorting the events by category.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of events.
+ */
+
+static void BenchSortCategories(int n) {
+	BenchSort(n, CompareEventCategories);
+}
+
+/**
+ * @fn	static void BenchSortTimes(int n)
+ *
+ * @brief	Measures sorting the events by time.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of events.
+ */
+
+static void BenchSortTimes(int n) {
+	BenchSort(n, CompareEventTimes);
+}
+
+/**
+ * @fn	static void BenchSortTimesDescending(int n)
+ *
+ * @brief	Measures sorting the events by time, the newest first.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of events.
+ */
+
+static void BenchSortTimesDescending(int n) {
+	BenchSort(n, CompareEventTimesDescending);
+}
+
+/**
+ * @fn	static void RemoveBenchFiles(void)
+ *
+ * @brief	Removes the data file the events benchmarks write, together with its backup.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ */
+
+static void RemoveBenchFiles(void) {
+	string backupName = GetBackupNameAtomicFile(benchFile);
+	remove(benchFile);
+	remove(backupName);
+	freeBlock(backupName);
+	ResetEventJournal(benchFile);
+}
+
+/**
+ * @fn	static void BenchEventsSave(int n)
+ *
+ * @brief	Measures saving the events to the data file.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of events.
+ */
+
+static void BenchEventsSave(int n) {
+	Vector events = NewEvents(n);
+	RemoveBenchFiles();
+	StartMeasure();
+	SaveEventsToFile(events, benchFile);
+	StopMeasure(n);
+	RemoveBenchFiles();
+}
+
+/**
+ * @fn	static void BenchEventsRead(int n)
+ *
+ * @brief	Measures reading the events from the data file.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	n	The number of events.
+ */
+
+static void BenchEventsRead(int n) {
+	Vector events = NewEvents(n);
+	RemoveBenchFiles();
+	SaveEventsToFile(events, benchFile);
+	StartMeasure();
+	Vector read = ReadEventsFromFile(benchFile);
+	StopMeasure(n);
+	if (sizeVector(read) != n) {
+		error("BenchEventsRead: Events lost");
+	}
+	RemoveBenchFiles();
+}
+
+/** @brief	The benchmarks */
+const Benchmark benchmarks[] = {
+	{ "vector_add", 0, BenchVectorAdd },
+	{ "vector_insert", 100000, BenchVectorInsert },
+	{ "vector_remove", 100000, BenchVectorRemove },
+	{ "vector_clone", 0, BenchVectorClone },
+	{ "strbuf_push", 0, BenchStringBufferPush },
+	{ "strbuf_append", 0, BenchStringBufferAppend },
+	{ "bst_insert", 0, BenchBSTInsert },
+	{ "bst_find", 0, BenchBSTFind },
+	{ "map_tree_put", 0, BenchTreeMapPut },
+	{ "map_tree_get", 0, BenchTreeMapGet },
+	{ "map_hash_put", 0, BenchHashMapPut },
+	{ "map_hash_get", 0, BenchHashMapGet },
+	{ "sort_names", 0, BenchSortNames },
+	{ "sort_locations", 0, BenchSortLocations },
+	{ "sort_categories", 0, BenchSortCategories },
+	{ "sort_times", 0, BenchSortTimes },
+	{ "sort_times_descending", 0, BenchSortTimesDescending },
+	{ "events_save", 0, BenchEventsSave },
+	{ "events_read", 0, BenchEventsRead }
+};
+
+/**
+ * @fn	static void RunBenchmark(const Benchmark* benchmark, int n)
+ *
+ * @brief	Runs the benchmark in a child process and prints its results.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	benchmark	The benchmark.
+ * @param 	n		 	The number of elements.
+ */
+
+static void RunBenchmark(const Benchmark* benchmark, int n) {
+	fflush(stdout);
+	pid_t pid = fork();
+	if (pid < 0) {
+		error("RunBenchmark: The benchmark process could not be started");
+	}
+	if (pid == 0) {
+		benchmark->run(n);
+
+		struct rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		printf("%-24s %9d %12.1f", benchmark->name, n, resultTime);
+#ifdef SUDOGU_BENCH_COUNT_ALLOCATIONS
+		printf(" %12.2f", resultAllocations);
+#else
+		printf(" %12s", "-");
+#endif
+		printf(" %12ld\n", usage.ru_maxrss);
+		fflush(stdout);
+		_exit(0);
+	}
+
+	int status;
+	waitpid(pid, &status, 0);
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+		printf("%-24s %9d %12s\n", benchmark->name, n, "failed");
+	}
+}
+
+/**
+ * @fn	static bool IsSelected(const Benchmark* benchmark, int argc, char** argv)
+ *
+ * @brief	Checks if the benchmark is selected by the names on the command line.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	benchmark	The benchmark.
+ * @param 	argc	 	The number of command line arguments.
+ * @param 	argv	 	The command line arguments.
+ *
+ * @returns	True if there are no names or the benchmark name starts with one of them.
+ */
+
+static bool IsSelected(const Benchmark* benchmark, int argc, char** argv) {
+	bool named = false;
+	for (int i = 1; i < argc; i++) {
+		if (atoi(argv[i]) > 0) {
+			continue;
+		}
+		named = true;
+		if (startsWith(benchmark->name, argv[i])) {
+			return true;
+		}
+	}
+	return !named;
+}
+
+/**
+ * @fn	int main(int argc, char** argv)
+ *
+ * @brief	Main entry-point for this application
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	argc	The number of command line arguments.
+ * @param 	argv	The command line arguments.
+ *
+ * @returns	Exit-code for the process - 0 for success, else an error code.
+ */
+
+int main(int argc, char** argv) {
+	Vector sizes = newVector();
+	for (int i = 1; i < argc; i++) {
+		int n = atoi(argv[i]);
+		if (n > 0) {
+			addVector(sizes, (void*) (long) n);
+		}
+	}
+	if (isEmptyVector(sizes)) {
+		for (size_t i = 0; i < sizeof defaultSizes / sizeof defaultSizes[0]; i++) {
+			addVector(sizes, (void*) (long) defaultSizes[i]);
+		}
+	}
+
+	printf("%-24s %9s %12s %12s %12s\n", "benchmark", "n", "ns/op", "allocs/op", "peak RSS KiB");
+	for (size_t b = 0; b < sizeof benchmarks / sizeof benchmarks[0]; b++) {
+		if (!IsSelected(&benchmarks[b], argc, argv)) {
+			continue;
+		}
+		for (int i = 0; i < sizeVector(sizes); i++) {
+			int n = (int) (long) getVector(sizes, i);
+			if (benchmarks[b].maxSize == 0 || n <= benchmarks[b].maxSize) {
+				RunBenchmark(&benchmarks[b], n);
+			}
+		}
+	}
+	freeVector(sizes);
+	return 0;
+}
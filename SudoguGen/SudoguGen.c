@@ -0,0 +1,413 @@
+﻿/**
+ * @file	SudoguGen.c.
+ *
+ * @brief	Sudogu synthetic catalogue generator. Main file.
+ *
+ * Writes the events and the categories data files filled with generated events, in the same format
+ * the applications write them, for the load testing. The events are generated and written one at a
+ * time, newest first like the applications keep them, so the memory does not grow with the size of
+ * the events: only the offset table of the file (8 bytes per event) is kept until the end.
+ *
+ * The times are spread evenly over the time span. The descending times are generated directly as
+ * the order statistics of the uniform distribution, so they do not have to be sorted. The locations
+ * follow the Zipf distribution, so a few locations hold most of the events, and the description
+ * lengths follow the exponential distribution between the shortest and the longest length.
+ *
+ * Usage: SudoguGen [option value]...
+ * 	--events N              number of events (10000)
+ * 	--categories N          number of categories (10)
+ * 	--locations N           number of locations (100)
+ * 	--zipf S                exponent of the location distribution (1.0)
+ * 	--description-min N     shortest description (20)
+ * 	--description-mean N    mean description length (200)
+ * 	--description-max N     longest description (2000)
+ * 	--from DAYS             start of the time span, in days from now (-365)
+ * 	--to DAYS               end of the time span, in days from now (365)
+ * 	--seed N                seed of the random numbers (1)
+ * 	--events-file NAME      events data file (events.dat)
+ * 	--categories-file NAME  categories data file (categories.dat)
+ */
+
+// System headers
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+// CSLib headers
+#include "cslib.h"
+#include "strlib.h"
+#include "utilities.h"
+#include "vector.h"
+
+// Custom headers
+#include "Event.h"
+#include "EventCategory.h"
+#include "EventFile.h"
+#include "EventJournal.h"
+#include "AtomicFile.h"
+#include "Console.h"
+
+/** @brief	The highlighting attributes (used by the utilities) */
+WORD HIGHLIGHT_ATTRIBUTES = F_WHITE | B_BLUE;
+
+/** @brief	The names of the first locations, the most frequent ones */
+string cityNames[] = {
+	"Banja Luka", "Bijeljina", "Prijedor", "Doboj", "Trebinje",
+	"Laktaši", "Gradiška", "Zvornik", "Derventa", "Mrkonjić Grad"
+};
+
+/** @brief	The words the descriptions are made of */
+string descriptionWords[] = {
+	"koncert", "izložba", "predstava", "promocija", "festival", "turnir", "sajam", "radionica",
+	"gradski", "trg", "dvorana", "ulaz", "slobodan", "počinje", "večeras", "u", "na", "sa",
+	"gostovanje", "program", "muzika", "djeca", "porodica", "tradicionalni", "veliki", "novi"
+};
+
+/**
+ * @struct	GeneratorOptions
+ *
+ * @brief	The generator options.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ */
+
+typedef struct {
+	long events;
+	int categories;
+	int locations;
+	double zipf;
+	int descriptionMin;
+	int descriptionMean;
+	int descriptionMax;
+	double from;
+	double to;
+	uint64_t seed;
+	string eventsFile;
+	string categoriesFile;
+} GeneratorOptions;
+
+/** @brief	The state of the random number generator */
+static uint64_t randomState;
+
+/**
+ * @fn	static double NextRandom(void)
+ *
+ * @brief	Gets the next number of the pseudo-random sequence.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @returns	A number greater than zero and not greater than one.
+ */
+
+static double NextRandom(void) {
+	randomState = randomState * 6364136223846793005ULL + 1442695040888963407ULL;
+	return ((randomState >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @fn	static int NextIndex(int bound)
+ *
+ * @brief	Picks one of the equally likely indices.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	bound	The number of indices.
+ *
+ * @returns	An index between zero and the bound, without the bound.
+ */
+
+static int NextIndex(int bound) {
+	int index = (int) (NextRandom() * bound);
+	return (index < bound) ? index : bound - 1;
+}
+
+/**
+ * @fn	static void Usage(void)
+ *
+ * @brief	Prints the usage and exits.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ */
+
+static void Usage(void) {
+	fprintf(stderr, "Usage: SudoguGen [--events N] [--categories N] [--locations N] [--zipf S]\n"
+		"\t[--description-min N] [--description-mean N] [--description-max N]\n"
+		"\t[--from DAYS] [--to DAYS] [--seed N] [--events-file NAME] [--categories-file NAME]\n");
+	exit(EXIT_FAILURE);
+}
+
+/**
+ * @fn	static void ReadOptions(GeneratorOptions* options, int argc, char** argv)
+ *
+ * @brief	Reads the options from the command line.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param [out]	options	The options.
+ * @param 	   	argc   	The number of command line arguments.
+ * @param 	   	argv   	The command line arguments.
+ */
+
+static void ReadOptions(GeneratorOptions* options, int argc, char** argv) {
+	options->events = 10000;
+	options->categories = 10;
+	options->locations = 100;
+	options->zipf = 1.0;
+	options->descriptionMin = 20;
+	options->descriptionMean = 200;
+	options->descriptionMax = 2000;
+	options->from = -365;
+	options->to = 365;
+	options->seed = 1;
+	options->eventsFile = "events.dat";
+	options->categoriesFile = "categories.dat";
+
+	for (int i = 1; i < argc; i += 2) {
+		if (i + 1 == argc) {
+			Usage();
+		}
+		string name = argv[i];
+		string value = argv[i + 1];
+		if (stringEqual(name, "--events")) options->events = atol(value);
+		else if (stringEqual(name, "--categories")) options->categories = atoi(value);
+		else if (stringEqual(name, "--locations")) options->locations = atoi(value);
+		else if (stringEqual(name, "--zipf")) options->zipf = atof(value);
+		else if (stringEqual(name, "--description-min")) options->descriptionMin = atoi(value);
+		else if (stringEqual(name, "--description-mean")) options->descriptionMean = atoi(value);
+		else if (stringEqual(name, "--description-max")) options->descriptionMax = atoi(value);
+		else if (stringEqual(name, "--from")) options->from = atof(value);
+		else if (stringEqual(name, "--to")) options->to = atof(value);
+		else if (stringEqual(name, "--seed")) options->seed = strtoull(value, NULL, 10);
+		else if (stringEqual(name, "--events-file")) options->eventsFile = value;
+		else if (stringEqual(name, "--categories-file")) options->categoriesFile = value;
+		else Usage();
+	}
+
+	if (options->events < 0 || options->categories < 1 || options->locations < 1 || options->zipf < 0
+		|| options->descriptionMin < 0 || options->descriptionMax < options->descriptionMin
+		|| options->descriptionMean < options->descriptionMin || options->to < options->from) {
+		Usage();
+	}
+}
+
+/**
+ * @fn	static Vector NewCategories(GeneratorOptions* options)
+ *
+ * @brief	Creates the categories.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	options	The options.
+ *
+ * @returns	The categories vector.
+ */
+
+static Vector NewCategories(GeneratorOptions* options) {
+	Vector categories = newVector();
+	char buf[32];
+	for (int i = 0; i < options->categories; i++) {
+		sprintf(buf, "Kategorija %d", i + 1);
+		EventCategory category = newEventCategory();
+		setEventCategoryName(category, getInternedEventCategory(internEventCategory(buf)));
+		addVector(categories, category);
+	}
+	return categories;
+}
+
+/**
+ * @fn	static string* NewLocations(GeneratorOptions* options, double** cumulative)
+ *
+ * @brief	Creates the locations and their cumulative Zipf weights.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	   	options   	The options.
+ * @param [out]	cumulative	Set to the sum of the weights of the locations up to every one.
+ *
+ * @returns	The location names.
+ */
+
+static string* NewLocations(GeneratorOptions* options, double** cumulative) {
+	int cities = sizeof cityNames / sizeof cityNames[0];
+	string* locations = newArray(options->locations, string);
+	*cumulative = newArray(options->locations, double);
+	double sum = 0;
+	char buf[32];
+	for (int i = 0; i < options->locations; i++) {
+		if (i < cities) {
+			locations[i] = cityNames[i];
+		}
+		else {
+			sprintf(buf, "Mjesto %d", i + 1 - cities);
+			locations[i] = copyString(buf);
+		}
+		sum += 1.0 / pow(i + 1, options->zipf);
+		(*cumulative)[i] = sum;
+	}
+	return locations;
+}
+
+/**
+ * @fn	static int NextLocation(GeneratorOptions* options, double* cumulative)
+ *
+ * @brief	Picks a location by its Zipf weight.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	options   	The options.
+ * @param 	cumulative	The cumulative weights of the locations.
+ *
+ * @returns	The index of the location.
+ */
+
+static int NextLocation(GeneratorOptions* options, double* cumulative) {
+	double target = NextRandom() * cumulative[options->locations - 1];
+	int low = 0, high = options->locations - 1;
+	while (low < high) {
+		int middle = low + (high - low) / 2;
+		if (cumulative[middle] < target) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+/**
+ * @fn	static void NextDescription(GeneratorOptions* options, char* buf)
+ *
+ * @brief	Generates a description.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	   	options	The options.
+ * @param [out]	buf	   	The buffer of the description, at least the longest description long.
+ */
+
+static void NextDescription(GeneratorOptions* options, char* buf) {
+	double mean = options->descriptionMean - options->descriptionMin;
+	int length = options->descriptionMin + (int) (-mean * log(NextRandom()));
+	if (length > options->descriptionMax) {
+		length = options->descriptionMax;
+	}
+
+	int pos = 0;
+	while (pos < length) {
+		string word = descriptionWords[NextIndex(sizeof descriptionWords / sizeof descriptionWords[0])];
+		int wordLength = (int) strlen(word);
+		if (pos > 0) {
+			buf[pos++] = ' ';
+		}
+		if (pos + wordLength > length) {
+			wordLength = length - pos;
+		}
+		memcpy(buf + pos, word, wordLength);
+		pos += wordLength;
+	}
+	buf[length] = '\0';
+}
+
+/**
+ * @fn	static void WriteEvents(GeneratorOptions* options, Vector categories)
+ *
+ * @brief	Generates the events and writes them into the events data file.
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	options   	The options.
+ * @param 	categories	The categories.
+ */
+
+static void WriteEvents(GeneratorOptions* options, Vector categories) {
+	double* cumulative;
+	string* locations = NewLocations(options, &cumulative);
+	string description = newArray(options->descriptionMax + 1, char);
+	char name[32];
+
+	FILE* filepoint = OpenAtomicFile(options->eventsFile);
+	if (filepoint == NULL) {
+		error_msg("Nije moguće otvoriti fajl %s", options->eventsFile);
+	}
+	EventFileWriter writer = NewEventFileWriter(filepoint, 0);
+
+	// The largest of the remaining uniform numbers, for the times from the newest to the oldest.
+	time_t now = time(NULL);
+	double span = (options->to - options->from) * 24 * 60 * 60;
+	double largest = 1.0;
+	Event event = newEvent();
+	for (long i = options->events; i > 0; i--) {
+		largest *= pow(NextRandom(), 1.0 / i);
+		sprintf(name, "Događaj %ld", options->events - i + 1);
+		NextDescription(options, description);
+
+		// The event only points to the buffers, which are written before they are reused.
+		pinEventStrings(event, name, description, locations[NextLocation(options, cumulative)]);
+		setEventCategory(event, getEventCategoryName(getVector(categories, NextIndex(sizeVector(categories)))));
+		setEventTime(event, now + (time_t) (options->from * 24 * 60 * 60 + largest * span));
+		AppendEventFileWriter(writer, event);
+	}
+	freeEvent(event);
+
+	CloseEventFileWriter(writer);
+	if (!CommitAtomicFile(filepoint, options->eventsFile)) {
+		error_msg("Nije moguće sačuvati fajl %s", options->eventsFile);
+	}
+
+	// The journal of the previous events does not belong to these.
+	ResetEventJournal(options->eventsFile);
+
+	for (int i = sizeof cityNames / sizeof cityNames[0]; i < options->locations; i++) {
+		freeBlock(locations[i]);
+	}
+	freeBlock(locations);
+	freeBlock(cumulative);
+	freeBlock(description);
+}
+
+/**
+ * @fn	int main(int argc, char** argv)
+ *
+ * @brief	Main entry-point for this application
+ *
+ * @author	Pynikleois
+ * @date	17.10.2026.
+ *
+ * @param 	argc	The number of command line arguments.
+ * @param 	argv	The command line arguments.
+ *
+ * @returns	Exit-code for the process - 0 for success, else an error code.
+ */
+
+int main(int argc, char** argv) {
+	GeneratorOptions options;
+	ReadOptions(&options, argc, argv);
+	randomState = options.seed;
+
+	Vector categories = NewCategories(&options);
+	SaveCategoriesToFile(categories, options.categoriesFile);
+	WriteEvents(&options, categories);
+
+	printf("%ld events, %d categories and %d locations written to %s and %s\n", options.events,
+		options.categories, options.locations, options.eventsFile, options.categoriesFile);
+
+	for (int i = 0; i < sizeVector(categories); i++) {
+		freeEventCategory(getVector(categories, i));
+	}
+	freeVector(categories);
+	return 0;
+}
@@ -6,11 +6,9 @@
 
  // System headers
 #include <stdio.h>
-#include <conio.h>
-#include <windows.h>
+#include <string.h>
 #include <time.h>
 #include <locale.h>
-#include <io.h>
 
 // CSLib headers
 #include "cslib.h"
@@ -27,8 +25,17 @@
 // Custom headers
 #include "EventCategory.h"
 #include "Event.h"
+#include "EventJournal.h"
+#include "EventFile.h"
+#include "EventTimeIndex.h"
+#include "EventCategoryIndex.h"
+#include "EventSearch.h"
+#include "EventFilter.h"
+#include "Trace.h"
 #include "Menu.h"
 #include "Table.h"
+#include "Console.h"
+#include "platform.h"
 
 /** @brief	The array of menu options. */
 string menuOptions[5] = {
@@ -67,9 +74,10 @@ string eventsHeader[4] = {
 };
 
 /** @brief	The events table footer. */
-string eventsFooter[3] = {
+string eventsFooter[4] = {
 	"ESC: Izlaz.",
 	"RETURN: Detalji.",
+	"F3: Pretraga.",
 	"F10: Sortiraj listu."
 };
 
@@ -113,24 +121,12 @@ const string fileCategories = "categories.dat";
 /** @brief	Name of the program (used on error) */
 const string programName = "SudoguUser";
 
-/** @brief	Handle to the stdout */
-HANDLE hStdout;
-
-/** @brief	Handle to the stdin */
-HANDLE hStdin;
-
-/** @brief	Variable to save the original console mode */
-DWORD fdwSaveOldMode;
-
-/** @brief	The original color attributes */
-WORD wOldColorAttrs;
-
-/** @brief	Information describing the console screen sb */
-CONSOLE_SCREEN_BUFFER_INFO csbiInfo;
-
 /** @brief	The highlight attributes */
 WORD HIGHLIGHT_ATTRIBUTES = F_WHITE | B_BLUE;
 
+/** @brief	The search index of all events */
+EventSearch eventsSearch = NULL;
+
 /** @brief	The window size x coordinate */
 const int windowSizeX = 121;
 
@@ -139,6 +135,8 @@ const int windowSizeY = 33;
 
 void windowSetup(void);
 
+int EventsHandling(TableView events);
+
 /**
  * @fn	string InputEventCategory(Table categories, int* tableSelection)
  *
@@ -154,25 +152,11 @@ void windowSetup(void);
  */
 
 string InputEventCategory(Table categories, int* tableSelection) {
-	// Save the cursor info.
-	CONSOLE_CURSOR_INFO oldInfo;
-	GetConsoleCursorInfo(hStdout, &oldInfo);
+	// Save the cursor visibility.
+	bool oldVisible = IsCursorVisibleConsole();
 
 	string categoryName;
 
-	DWORD fdwMode, fdwOldMode;
-
-	// Turn off the line input and echo input modes 
-	if (!GetConsoleMode(hStdin, &fdwOldMode)) {
-		return 0;
-	}
-
-	fdwMode = fdwOldMode &
-		~(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT);
-	if (!SetConsoleMode(hStdin, fdwMode)) {
-		return 0;
-	}
-
 	hideCursor();
 
 	// Variable for registering end.
@@ -183,10 +167,8 @@ string InputEventCategory(Table categories, int* tableSelection) {
 
 	while (!done) {
 		if (!MainTable(categories, tableSelection, &registeredKeyCode)) {
-			// Restore the original console mode. 
-			SetConsoleMode(hStdin, fdwOldMode);
 			// Restore the cursor.
-			SetConsoleCursorInfo(hStdout, &oldInfo);
+			ShowCursorConsole(oldVisible);
 			error_msg("InputEventCategory::MainTable");
 		}
 		switch (registeredKeyCode) {
@@ -211,29 +193,27 @@ string InputEventCategory(Table categories, int* tableSelection) {
 		categoryName = NULL;
 	}
 
-	// Restore the original console mode. 
-	SetConsoleMode(hStdin, fdwOldMode);
-
 	// Restore the cursor.
-	SetConsoleCursorInfo(hStdout, &oldInfo);
+	ShowCursorConsole(oldVisible);
 
 	return categoryName;
 }
 
 /**
- * @fn	void SortEventsTable(Table t)
+ * @fn	void SortEventsTable(TableView t)
  *
- * @brief	Sort events table according to the chosen column.
+ * @brief	Sort events table view according to the chosen column. The previously chosen columns
+ * 			order the events that are equal by the chosen one.
  *
  * @author	Pynikleois
  * @date	8.1.2020.
  *
- * @param 	t	A Table of events to process.
+ * @param 	t	A view of the events table to process.
  */
 
-void SortEventsTable(Table t) {
+void SortEventsTable(TableView t) {
 	// Table header contents
-	Vector header = GetHeaderTable(t);
+	Vector header = GetHeaderTable(GetTableTableView(t));
 
 	// Menu for holding column names as options
 	Menu menu = newMenu();
@@ -257,7 +237,7 @@ void SortEventsTable(Table t) {
 	int menuOption;
 
 	// Clear the screen
-	system("cls");
+	ClearConsole();
 
 	// Print the title
 	PrintTitle("Odaberite naziv kolone po kojoj želite da sortirate podatke");
@@ -270,21 +250,22 @@ void SortEventsTable(Table t) {
 	// Register and process the option
 	switch (menuOption) {
 	case EVENTS_HEADER_NAME: // Sorting by event names
-		SetCompareFnTable(t, CompareEventNames);
+		PushSortKeyTableView(t, CompareEventNames, SORT_ASCENDING);
 		break;
 	case EVENTS_HEADER_LOCATION: // Sorting by event locations
-		SetCompareFnTable(t, CompareEventLocations);
+		PushSortKeyTableView(t, CompareEventLocations, SORT_ASCENDING);
 		break;
 	case EVENTS_HEADER_CATEGORY: // Sorting by event categories
-		SetCompareFnTable(t, CompareEventCategories);
+		PushSortKeyTableView(t, CompareEventCategories, SORT_ASCENDING);
 		break;
 	case EVENTS_HEADER_TIME: // Sorting by event times
-		SetCompareFnTable(t, CompareEventTimes);
+		PushSortKeyTableView(t, CompareEventTimes, SORT_ASCENDING);
 		break;
 	default:
 		break;
 	}
 
+	freeMenu(menu);
 }
 
 /**
@@ -321,7 +302,7 @@ int ShowEventDetails(Table events, int index) {
 	}
 
 	string title = "Pregled detalja događaja";
-	system("cls");
+	ClearConsole();
 	PrintTitle(title);
 	advanceCursor(3);
 	PrintToConsole("\tNaziv: %s\n", getEventName(event));
@@ -332,46 +313,20 @@ int ShowEventDetails(Table events, int index) {
 	PrintStatusLine(" ESC: Povratak. ");
 	hideCursor();
 
-	DWORD fdwMode, fdwOldMode;
-
-	// Turn off the line input and echo input modes 
-	if (!GetConsoleMode(hStdin, &fdwOldMode)) {
-		showCursor();
-		return 0;
-	}
-
-	fdwMode = fdwOldMode &
-		~(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT);
-	if (!SetConsoleMode(hStdin, fdwMode)) {
-		showCursor();
-		return 0;
-	}
-
 	// Variable for registering end.
 	BOOL done = FALSE;
 
-	// Registered event that has happend.
-	INPUT_RECORD inputEvent;
-
-	// Number of read characters.
-	DWORD cRead;
-
 	while (!done) {
-		system("pause>nul");
-		if (WaitForSingleObject(hStdin, INFINITE) == WAIT_OBJECT_0)  /* if kbhit */
-		{
-			/* Get the input event */
-			ReadConsoleInput(hStdin, &inputEvent, 1, &cRead);
-
-			/* Only respond to key events */
-			if (inputEvent.EventType == KEY_EVENT)
-				switch (inputEvent.Event.KeyEvent.wVirtualKeyCode) {
-				case VK_ESCAPE:
-					done = TRUE;
-					break;
-				default:
-					break;
-				}
+		switch (ReadKeyConsole()) {
+		case VK_ESCAPE:
+			done = TRUE;
+			break;
+		case 0:
+			// The input is closed.
+			showCursor();
+			return 0;
+		default:
+			break;
 		}
 	}
 
@@ -380,33 +335,51 @@ int ShowEventDetails(Table events, int index) {
 }
 
 /**
- * @fn	int EventsHandling(Table events)
+ * @fn	int SearchEvents(TableView events)
  *
- * @brief	Events handling that involves displaying the events table and proccessing the user
- *  input.
+ * @brief	Asks for the search query, and shows the found events in the order of relevance, until
+ * 			they are sorted by a column.
  *
  * @author	Pynikleois
- * @date	8.1.2020.
+ * @date	17.10.2026.
  *
- * @param 	events	The events table.
+ * @param 	events	The view of the events table, whose table the results view shows.
  *
  * @returns	An int. 1 on success; 0 otherwise.
  */
 
-int EventsHandling(Table events) {
-	DWORD fdwMode, fdwOldMode;
-
-	// Turn off the line input and echo input modes 
-	if (!GetConsoleMode(hStdin, &fdwOldMode)) {
+int SearchEvents(TableView events) {
+	string query = ShowPrompt("Pretraga događaja", " RETURN: Traži.", "Traženi pojam: ");
+	if (query == NULL) {
 		return 0;
 	}
+	Vector found = QueryEventSearch(eventsSearch, query);
+	freeBlock(query);
 
-	fdwMode = fdwOldMode &
-		~(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT);
-	if (!SetConsoleMode(hStdin, fdwMode)) {
-		return 0;
-	}
+	TableView resultsView = NewTableView(GetTableTableView(events));
+	SetRecordsTableView(resultsView, found);
+	ClearSortKeysTableView(resultsView);
+	freeVector(found);
+	int res = EventsHandling(resultsView);
+	FreeTableView(resultsView);
+	return res;
+}
 
+/**
+ * @fn	int EventsHandling(TableView events)
+ *
+ * @brief	Events handling that involves displaying the events table and proccessing the user
+ *  input.
+ *
+ * @author	Pynikleois
+ * @date	8.1.2020.
+ *
+ * @param 	events	The view of the events table.
+ *
+ * @returns	An int. 1 on success; 0 otherwise.
+ */
+
+int EventsHandling(TableView events) {
 	hideCursor();
 
 	// Variable for registering end.
@@ -418,178 +391,87 @@ int EventsHandling(Table events) {
 	// Key code that was registered inside the table.
 	WORD registeredKeyCode;
 
+	// The filter that is typed into the table.
+	EventFilter filter = NewEventFilter(events);
+
+	// Returning value.
+	int returnValue = 1;
+
 	while (!done) {
-		if (!MainTable(events, &tableSelection, &registeredKeyCode)) {
-			showCursor();
-			return 0;
+		if (!MainEventFilter(filter, &tableSelection, &registeredKeyCode)) {
+			returnValue = 0;
+			break;
 		}
 		switch (registeredKeyCode) {
-		case VK_ESCAPE: // Exit from table.
+		case VK_ESCAPE: // Clear the filter, or exit from table.
+			if (IsActiveEventFilter(filter)) {
+				tableSelection = ClearEventFilter(filter, tableSelection);
+				break;
+			}
 			done = TRUE;
 			break;
+		case VK_BACK: // Erase the last character of the filter.
+			if (EraseEventFilter(filter)) {
+				tableSelection = 0;
+			}
+			break;
 		case VK_RETURN: // Show details of the selected event.
-			if (isEmptyVector(GetDataTable(events))) {
+			if (GetRowEventFilter(filter, tableSelection) < 0) {
 				break;
 			}
-			if (!ShowEventDetails(events, tableSelection)) {
-				showCursor();
-				return 0;
+			if (!ShowEventDetails(GetTableTableView(events), GetRowEventFilter(filter, tableSelection))) {
+				returnValue = 0;
+				done = TRUE;
+			}
+			break;
+		case VK_F3: // Search all events.
+			if (!SearchEvents(events)) {
+				returnValue = 0;
+				done = TRUE;
 			}
 			break;
 		case VK_F10: // Sort the list.
 			SortEventsTable(events);
+			RefreshEventFilter(filter);
 			break;
-		default:
+		default: // Type the character into the filter.
+			if (TypeEventFilter(filter, GetKeyCharConsole())) {
+				tableSelection = 0;
+			}
 			break;
 		}
 	}
 
-	// Restore the original console mode. 
-	SetConsoleMode(hStdin, fdwOldMode);
-
+	FreeEventFilter(filter);
 	showCursor();
-	return 1;
-}
-
-/**
- * @fn	int IsTodaysEvent(const void* p1, const void* p2)
- *
- * @brief	Check if the event is happening today.
- *
- * @author	Pynikleois
- * @date	8.1.2020.
- *
- * @param 	p1	The pointer to the event.
- * @param 	p2	The ponter to the struct tm that is initialized to current time.
- *
- * @returns	An int. 0 if the event is happening today; 1 otherwise.
- */
-
-int IsTodaysEvent(const void* p1, const void* p2) {
-	Event event = (Event) p1;
-	struct tm* tmNow = (struct tm*) p2;
-	time_t eventTime = getEventTime(event);
-	struct tm tmEvent;
-	tmEvent = *localtime(&eventTime);
-
-	if (tmNow->tm_year == tmEvent.tm_year
-		&& tmNow->tm_yday == tmEvent.tm_yday) {
-		return 0;
-	}
-	else {
-		return 1;
-	}
-}
-
-/**
- * @fn	int IsFutureEvent(const void* p1, const void* p2)
- *
- * @brief	Is future event
- *
- * @author	Pynikleois
- * @date	8.1.2020.
- *
- * @param 	p1	The pointer to the event.
- * @param 	p2	The pointer to the time_t variable initialized to current time.
- *
- * @returns	An int.
- */
-
-int IsFutureEvent(const void* p1, const void* p2) {
-	Event event = (Event) p1;
-	time_t now = *(time_t*) p2;
-	time_t eventTime = getEventTime(event);
-
-	if (difftime(eventTime, now) > 0) {
-		return 0;
-	}
-	else {
-		return 1;
-	}
-}
-
-/**
- * @fn	int IsPastEvent(const void* p1, const void* p2)
- *
- * @brief	Checks if the event is in the past.
- *
- * @author	Pynikleois
- * @date	8.1.2020.
- *
- * @param 	p1	The pointer to the event.
- * @param 	p2	The pointer to the time_t variable initialized to current time.
- *
- * @returns	An int.
- */
-
-int IsPastEvent(const void* p1, const void* p2) {
-	Event event = (Event) p1;
-	time_t now = *(time_t*) p2;
-	time_t eventTime = getEventTime(event);
-
-	if (difftime(eventTime, now) < 0) {
-		return 0;
-	}
-	else {
-		return 1;
-	}
-}
-
-/**
- * @fn	int IsCategoryEvent(const void* p1, const void* p2)
- *
- * @brief	Is category event
- *
- * @author	Pynikleois
- * @date	8.1.2020.
- *
- * @param 	p1	The pointer to the event.
- * @param 	p2	The pointer to the string that holds category name to compare to.
- *
- * @returns	An int.
- */
-
-int IsCategoryEvent(const void* p1, const void* p2) {
-	Event event = (Event) p1;
-	string categoryToCompareTo = (string) p2;
-	string eventCategory = getEventCategory(event);
-	if (stringCompare(eventCategory, categoryToCompareTo) == 0) {
-		return 0;
-	}
-	else {
-		return 1;
-	}
+	return returnValue;
 }
 
 /**
- * @fn	Vector FilterVector(Vector old, CompareFn cmpFn, void* toCmpTo)
+ * @fn	int ShowEventsSlice(Table eventsTable, const int* rows, int count)
  *
- * @brief	Filter vector
+ * @brief	Shows the events found in the time index, through a view of the events table.
  *
  * @author	Pynikleois
- * @date	8.1.2020.
+ * @date	17.10.2026.
  *
- * @param 		  	old	   	The vector to filter.
- * @param 		  	cmpFn  	The compare function.
- * @param [in,out]	toCmpTo	If non-null, second argument of the compare function. Argument to
- * 							compare to.
+ * @param 	eventsTable	The events table.
+ * @param 	rows	   	The positions of the found events in the table data.
+ * @param 	count	   	Number of the found events.
  *
- * @returns	A filtered Vector.
+ * @returns	An int. 1 on success; 0 otherwise.
  */
 
-Vector FilterVector(Vector old, CompareFn cmpFn, void* toCmpTo) {
-	Vector new = newVector();
-	for (int i = 0; i < sizeVector(old); i++) {
-		void* record = getVector(old, i);
-		if (cmpFn(record, toCmpTo) == 0) {
-			addVector(new, record);
-		}
-	}
-	return new;
+int ShowEventsSlice(Table eventsTable, const int* rows, int count) {
+	TableView filteredView = NewTableView(eventsTable);
+	SetRowsTableView(filteredView, rows, count);
+	int res = EventsHandling(filteredView);
+	FreeTableView(filteredView);
+	return res;
 }
 
 /**
- * @fn	int ShowTodaysEvents(Table eventsTable)
+ * @fn	int ShowTodaysEvents(Table eventsTable, EventTimeIndex eventsIndex)
  *
  * @brief	Shows the todays events
  *
@@ -597,29 +479,22 @@ Vector FilterVector(Vector old, CompareFn cmpFn, void* toCmpTo) {
  * @date	8.1.2020.
  *
  * @param 	eventsTable	The events table.
+ * @param 	eventsIndex	The time index of the events.
  *
  * @returns	An int. 1 on success; 0 otherwise.
  */
 
-int ShowTodaysEvents(Table eventsTable) {
-	Table filteredTable = CloneTable(eventsTable);
-	Vector eventsVector = GetDataTable(filteredTable);
-
+int ShowTodaysEvents(Table eventsTable, EventTimeIndex eventsIndex) {
 	time_t now;
 	time(&now);
-	struct tm tmNow;
-	tmNow = *localtime(&now);
-
-	Vector filteredVector = FilterVector(eventsVector, IsTodaysEvent, &tmNow);
-	freeVector(eventsVector);
-	SetDataTable(filteredTable, filteredVector);
-	int res = EventsHandling(filteredTable);
-	FreeTable(filteredTable);
-	return res;
+
+	const int* rows;
+	int count = GetDayEventTimeIndex(eventsIndex, now, &rows);
+	return ShowEventsSlice(eventsTable, rows, count);
 }
 
 /**
- * @fn	int ShowFutureEvents(Table eventsTable)
+ * @fn	int ShowFutureEvents(Table eventsTable, EventTimeIndex eventsIndex)
  *
  * @brief	Shows the future events
  *
@@ -627,27 +502,24 @@ int ShowTodaysEvents(Table eventsTable) {
  * @date	8.1.2020.
  *
  * @param 	eventsTable	The events table.
+ * @param 	eventsIndex	The time index of the events.
  *
  * @returns	An int. 1 on success; 0 otherwise.
  */
 
-int ShowFutureEvents(Table eventsTable) {
-	Table filteredTable = CloneTable(eventsTable);
-	Vector eventsVector = GetDataTable(filteredTable);
-
+int ShowFutureEvents(Table eventsTable, EventTimeIndex eventsIndex) {
 	time_t now;
 	time(&now);
 
-	Vector filteredVector = FilterVector(eventsVector, IsFutureEvent, &now);
-	freeVector(eventsVector);
-	SetDataTable(filteredTable, filteredVector);
-	int res = EventsHandling(filteredTable);
-	FreeTable(filteredTable);
-	return res;
+	int begin = UpperBoundEventTimeIndex(eventsIndex, now);
+	int end = SizeEventTimeIndex(eventsIndex);
+	const int* rows;
+	int count = SliceEventTimeIndex(eventsIndex, begin, end, &rows);
+	return ShowEventsSlice(eventsTable, rows, count);
 }
 
 /**
- * @fn	int ShowPastEvents(Table eventsTable)
+ * @fn	int ShowPastEvents(Table eventsTable, EventTimeIndex eventsIndex)
  *
  * @brief	Shows the past events
  *
@@ -655,27 +527,23 @@ int ShowFutureEvents(Table eventsTable) {
  * @date	8.1.2020.
  *
  * @param 	eventsTable	The events table.
+ * @param 	eventsIndex	The time index of the events.
  *
  * @returns	An int. 1 on success; 0 otherwise.
  */
 
-int ShowPastEvents(Table eventsTable) {
-	Table filteredTable = CloneTable(eventsTable);
-	Vector eventsVector = GetDataTable(filteredTable);
-
+int ShowPastEvents(Table eventsTable, EventTimeIndex eventsIndex) {
 	time_t now;
 	time(&now);
 
-	Vector filteredVector = FilterVector(eventsVector, IsPastEvent, &now);
-	freeVector(eventsVector);
-	SetDataTable(filteredTable, filteredVector);
-	int res = EventsHandling(filteredTable);
-	FreeTable(filteredTable);
-	return res;
+	int end = LowerBoundEventTimeIndex(eventsIndex, now);
+	const int* rows;
+	int count = SliceEventTimeIndex(eventsIndex, 0, end, &rows);
+	return ShowEventsSlice(eventsTable, rows, count);
 }
 
 /**
- * @fn	int ShowCategoryEvents(Table eventsTable, Table categoriesTable)
+ * @fn	int ShowCategoryEvents(Table eventsTable, Table categoriesTable, EventCategoryIndex categoryIndex)
  *
  * @brief	Shows the events of the chosen category.
  *
@@ -684,13 +552,14 @@ int ShowPastEvents(Table eventsTable) {
  *
  * @param 	eventsTable	   	The events table.
  * @param 	categoriesTable	The categories table.
+ * @param 	categoryIndex  	The category index of the events.
  *
  * @returns	An int. 1 on success; 0 otherwise.
  */
 
-int ShowCategoryEvents(Table eventsTable, Table categoriesTable) {
-	Table filteredTable = CloneTable(eventsTable);
-	Vector eventsVector = GetDataTable(filteredTable);
+int ShowCategoryEvents(Table eventsTable, Table categoriesTable, EventCategoryIndex categoryIndex) {
+	// The view keeps the order chosen for the previous category.
+	TableView filteredView = NewTableView(eventsTable);
 
 	// Variable for registering end.
 	BOOL done = FALSE;
@@ -704,18 +573,17 @@ int ShowCategoryEvents(Table eventsTable, Table categoriesTable) {
 	while (!done) {
 		string selectedCategory = InputEventCategory(categoriesTable, &tableSelection);
 		if (selectedCategory != NULL && tableSelection != -1) {
-			Vector filteredVector = FilterVector(eventsVector, IsCategoryEvent, selectedCategory);
-			SetDataTable(filteredTable, filteredVector);
-			returnValue = EventsHandling(filteredTable);
-			freeVector(filteredVector);
+			const int* rows;
+			int count = GetRowsEventCategoryIndex(categoryIndex, selectedCategory, &rows);
+			SetRowsTableView(filteredView, rows, count);
+			returnValue = EventsHandling(filteredView);
 		}
 		else {
 			done = TRUE;
 		}
 	}
 
-	SetDataTable(filteredTable, eventsVector);
-	FreeTable(filteredTable);
+	FreeTableView(filteredView);
 	return returnValue;
 }
 
@@ -732,33 +600,55 @@ int ShowCategoryEvents(Table eventsTable, Table categoriesTable) {
 
 int main(void) {
 
+	// Trace the application if SUDOGU_TRACE names the trace file
+	InitTrace();
+
 	// Setup the window
 	windowSetup();
 
-	// Vector to hold all events
-	Vector events;
+	// Vector to hold all categories
+	Vector categories;
 
-	// Check if the events data file exists, and read it if it does. 
+	// The categories are read first, so they are the first names in the category symbol table.
+	// Check if the categories data file exists, and read it if it does. 
 	// Otherwise, create new vector.
 	// 
-	if (fileExists(fileEvents)) {
-		events = ReadEventsFromFile(fileEvents);
+	if (fileExists(fileCategories)) {
+		categories = ReadCategoriesFromFile(fileCategories);
 	}
 	else {
-		events = newVector();
+		categories = newVector();
 	}
 
-	// Vector to hold all categories
-	Vector categories;
+	// Vector to hold all events
+	Vector events = NULL;
 
-	// Check if the categories data file exists, and read it if it does. 
+	// Mapping of the events data file
+	EventFileMapping eventsMapping = NULL;
+
+	// Check if the events data file exists, and read it if it does. 
 	// Otherwise, create new vector.
 	// 
-	if (fileExists(fileCategories)) {
-		categories = ReadCategoriesFromFile(fileCategories);
+	if (fileExists(fileEvents)) {
+		// The events point straight into the mapped file, so it stays mapped until the exit.
+		eventsMapping = MapEventFile(fileEvents);
+		if (eventsMapping != NULL) {
+			events = ReadMappedEventFile(eventsMapping);
+			if (events != NULL) {
+				ReplayEventJournal(events, fileEvents);
+			}
+			else {
+				UnmapEventFile(eventsMapping);
+				eventsMapping = NULL;
+			}
+		}
+		if (events == NULL) {
+			events = ReadEventsFromFile(fileEvents);
+		}
 	}
 	else {
-		categories = newVector();
+		events = newVector();
+		ReplayEventJournal(events, fileEvents);
 	}
 
 	// Main menu
@@ -768,7 +658,7 @@ int main(void) {
 	// 
 	Vector menuVector = getMenuOptions(menu);
 	freeVector(menuVector);
-	Vector tmp = arrayToVector(menuOptions, 5);
+	Vector tmp = arrayToVector((void**) menuOptions, 5);
 	setMenuOptions(menu, tmp);
 
 	// Set spacing per line in the new menu and center it.
@@ -795,7 +685,7 @@ int main(void) {
 	}
 	SetHeaderTable(eventsTable, tmpVector);
 	tmpVector = newVector();
-	for (int i = 0; i < 3; i++) {
+	for (int i = 0; i < 4; i++) {
 		string tmp = copyString(eventsFooter[i]);
 		addVector(tmpVector, tmp);
 	}
@@ -815,8 +705,22 @@ int main(void) {
 
 	// Set funciton for comparing the events.
 	// Used for sorting the table before drawing it.
+	// Events at the same time are ordered by their names.
+	// 
+	SetCompareFnTable(eventsTable, CompareEventNames);
+	PushSortKeyTable(eventsTable, CompareEventTimesDescending, SORT_ASCENDING);
+
+	// Time index of the events, for finding the events of a time range.
+	// 
+	EventTimeIndex eventsIndex = NewEventTimeIndex(events);
+
+	// Category index of the events, for browsing the events of a category.
 	// 
-	SetCompareFnTable(eventsTable, CompareEventTimesDescending);
+	EventCategoryIndex categoryIndex = NewEventCategoryIndex(events);
+
+	// Search index of the events, for the search in the events tables.
+	// 
+	eventsSearch = NewEventSearch(events);
 
 	// Table for all categories
 	// 
@@ -858,7 +762,7 @@ int main(void) {
 
 	// City name, read from a config file
 	string cityName = NULL;
-	Map cityMap = newMap();
+	Map cityMap = newMapOfType(HASH_MAP);
 	if (fileToMap(fileCity, cityMap) != 1) {
 		freeMapFields(cityMap);
 		error_msg("Neispravna konfiguracija parametara grada unutar datoteke %s.\n", fileCity);
@@ -878,7 +782,7 @@ int main(void) {
 
 	while (!done) {
 		// Clear the screen
-		system("cls");
+		ClearConsole();
 
 		// Print city name
 		advanceCursor(3);
@@ -889,22 +793,22 @@ int main(void) {
 		}
 		switch (menuOption) {
 		case MENU_TODAYS_EVENTS:
-			if (!ShowTodaysEvents(eventsTable)) {
+			if (!ShowTodaysEvents(eventsTable, eventsIndex)) {
 				error_msg("Nije moguce prikazati dogadjaje.");
 			}
 			break;
 		case MENU_CATEGORY_EVENTS:
-			if (!ShowCategoryEvents(eventsTable, categoriesTable)) {
+			if (!ShowCategoryEvents(eventsTable, categoriesTable, categoryIndex)) {
 				error_msg("Nije moguce prikazati dogadjaje.");
 			}
 			break;
 		case MENU_FUTURE_EVENTS:
-			if (!ShowFutureEvents(eventsTable)) {
+			if (!ShowFutureEvents(eventsTable, eventsIndex)) {
 				error_msg("Nije moguce prikazati dogadjaje.");
 			}
 			break;
 		case MENU_PAST_EVENTS:
-			if (!ShowPastEvents(eventsTable)) {
+			if (!ShowPastEvents(eventsTable, eventsIndex)) {
 				error_msg("Nije moguce prikazati dogadjaje.");
 			}
 			break;
@@ -916,11 +820,17 @@ int main(void) {
 		}
 	}
 
-	// Restore the original console mode. 
-	SetConsoleMode(hStdin, fdwSaveOldMode);
+	FreeEventTimeIndex(eventsIndex);
+	FreeEventCategoryIndex(categoryIndex);
+	FreeEventSearch(eventsSearch);
+
+	// The events point into the mapping, so it is released only at the exit.
+	if (eventsMapping != NULL) {
+		UnmapEventFile(eventsMapping);
+	}
 
-	// Restore the original text colors. 
-	SetConsoleTextAttribute(hStdout, wOldColorAttrs);
+	// Restore the original console mode, text colors and cursor.
+	CloseConsole();
 
 	return 0;
 }
@@ -935,15 +845,13 @@ int main(void) {
  */
 
 void windowSetup(void) {
-	// Set codepage. Needed for Serbian Latin chars.
+	// Set codepage and window size, and save the console state, to be restored on exit.
+	// Needed for Serbian Latin chars.
 	// Also added additional options in project property pages:
 	// /source-charset:windows-1250 /execution-charset:windows-1250
 	// 
-	if (!SetConsoleCP(1250)) {
-		error_msg("SetConsoleCP");
-	}
-	if (!SetConsoleOutputCP(1250)) {
-		error_msg("SetConsoleOutputCP");
+	if (!OpenConsole(windowSizeX, windowSizeY)) {
+		error_msg("OpenConsole");
 	}
 
 	// Set system locale.
@@ -957,43 +865,9 @@ void windowSetup(void) {
 	//
 	_tzset();
 
-	// Disable window resizing and maximizing.
-	// 
-	HWND consoleWindow = GetConsoleWindow();
-	SetWindowLong(consoleWindow, GWL_STYLE, GetWindowLong(consoleWindow, GWL_STYLE) & ~WS_MAXIMIZEBOX & ~WS_SIZEBOX);
-	SetConsoleWindowSize(windowSizeX, windowSizeY);
-
-	// Get handles to STDIN and STDOUT.
-	// 
-	hStdin = GetStdHandle(STD_INPUT_HANDLE);
-	hStdout = GetStdHandle(STD_OUTPUT_HANDLE);
-	if (hStdin == INVALID_HANDLE_VALUE || hStdout == INVALID_HANDLE_VALUE) {
-		MessageBox(NULL, TEXT("GetStdHandle"), TEXT("Console Error"), MB_OK);
-		exit(EXIT_FAILURE);
-	}
-
-	// Save the current input mode, to be restored on exit.
-	// 
-	if (!GetConsoleMode(hStdin, &fdwSaveOldMode)) {
-		MessageBox(NULL, TEXT("GetConsoleMode"), TEXT("Console Error"), MB_OK);
-		exit(EXIT_FAILURE);
-	}
-
-	// Save the current text colors.
-	// 
-	if (!GetConsoleScreenBufferInfo(hStdout, &csbiInfo)) {
-		MessageBox(NULL, TEXT("GetConsoleScreenBufferInfo"), TEXT("Console Error"), MB_OK);
-		exit(EXIT_FAILURE);
-	}
-
-	wOldColorAttrs = csbiInfo.wAttributes;
-
 	// Set text attributes.
 	// 
-	if (!SetConsoleTextAttribute(hStdout, B_WHITE)) {
-		MessageBox(NULL, TEXT("SetConsoleTextAttribute"), TEXT("Console Error"), MB_OK);
-		exit(EXIT_FAILURE);
-	}
+	SetAttributesConsole(B_WHITE);
 
 	// Show cursor.
 	// 
@@ -1001,5 +875,5 @@ void windowSetup(void) {
 
 	// Clear screen.
 	// 
-	system("cls");
+	ClearConsole();
 }